@@ -2,6 +2,47 @@
 #define AABB_HPP
 
 #include "common/rtweekend.hpp"
+#include "common/transform.hpp"
+
+/**
+ * 미리 계산된 방향벡터 역수(inv_dir)와 부호(sign)를 사용하는 branchless slab test
+ *
+ * - 축마다 방향 부호로 광선이 먼저 만나는 경계면(near)과 나중에 만나는 경계면(far)을 바로 선택하므로,
+ *   aabb::hit(const ray &) 처럼 t0, t1 의 대소 비교에 따른 데이터 의존 분기가 필요 없다.
+ * - 진입/탈출 시점 누적은 min/max 형태의 삼항 연산자로 작성하여 컴파일러가 minsd/maxsd 명령어로 변환할 수 있도록 한다.
+ * - 경계값 타입 T 는 double(aabb) 또는 float(평탄화된 BVH 노드)이며, 계산은 항상 double 로 수행한다.
+ */
+template <typename T>
+inline bool slab_test(const traversal_ray &r, const T *bounds_min, const T *bounds_max, interval ray_t, double &t_entry, double &t_exit)
+{
+  double t_min = ray_t.min;
+  double t_max = ray_t.max;
+
+  for (int axis = 0; axis < 3; axis++)
+  {
+    double near_bound = r.sign[axis] ? bounds_max[axis] : bounds_min[axis];
+    double far_bound = r.sign[axis] ? bounds_min[axis] : bounds_max[axis];
+    double t_near = (near_bound - r.origin[axis]) * r.inv_dir[axis];
+    double t_far = (far_bound - r.origin[axis]) * r.inv_dir[axis];
+
+    // 방향 성분이 0 이고 출발점이 경계면 위에 있으면 0 * inf = NaN 이 되는데,
+    // NaN 과의 비교는 항상 false 이므로 아래 비교식에서는 누적값(t_min, t_max)이 그대로 유지됨 -> 해당 축 경계면을 무시 (NaN-robust)
+    t_min = t_near > t_min ? t_near : t_min;
+    t_max = t_far < t_max ? t_far : t_max;
+  }
+
+  t_entry = t_min;
+  t_exit = t_max;
+  return t_min < t_max;
+};
+
+// 진입 시점만 필요한 경우 (BVH 노드 검사)
+template <typename T>
+inline bool slab_test(const traversal_ray &r, const T *bounds_min, const T *bounds_max, interval ray_t, double &t_entry)
+{
+  double t_exit;
+  return slab_test(r, bounds_min, bounds_max, ray_t, t_entry, t_exit);
+};
 
 /**
  * 축 정렬 경계 박스(Axis-Aligned Bounding Box, AABB)를 정의하는 클래스
@@ -111,6 +152,29 @@ public:
     return true;
   };
 
+  // 방향벡터 역수와 부호가 미리 계산된 traversal_ray 와 AABB 의 교차 여부를 branchless slab test 로 검사 (하단 필기 참고)
+  bool hit(const traversal_ray &r, interval ray_t) const
+  {
+    double t_entry;
+    return hit(r, ray_t, t_entry);
+  };
+
+  // traversal_ray 와 AABB 교차 검사 후, 교차 시 광선이 AABB 에 진입하는 시점을 t_entry 로 출력
+  bool hit(const traversal_ray &r, interval ray_t, double &t_entry) const
+  {
+    const double bounds_min[3] = {x.min, y.min, z.min};
+    const double bounds_max[3] = {x.max, y.max, z.max};
+    return slab_test(r, bounds_min, bounds_max, ray_t, t_entry);
+  };
+
+  // traversal_ray 와 AABB 교차 검사 후, 광선이 AABB 에 진입/탈출하는 시점을 t_entry / t_exit 로 출력 (grid, kd-tree 순회 구간 계산용)
+  bool hit(const traversal_ray &r, interval ray_t, double &t_entry, double &t_exit) const
+  {
+    const double bounds_min[3] = {x.min, y.min, z.min};
+    const double bounds_max[3] = {x.max, y.max, z.max};
+    return slab_test(r, bounds_min, bounds_max, ray_t, t_entry, t_exit);
+  };
+
   // 가장 긴 축의 슬랩 인덱스를 반환하는 함수 (0: x, 1: y, 2: z)
   // -> BVH 분할 시, 가장 긴 축을 기준으로 정렬하여 공간 분할 품질을 높이기 위함
   int longest_axis() const
@@ -126,6 +190,23 @@ public:
     }
   };
 
+  // AABB 의 표면적 계산 -> SAH(Surface Area Heuristic) 기반 BVH 분할 비용 계산 시, 광선이 AABB 와 교차할 확률에 비례하는 값으로 사용
+  double surface_area() const
+  {
+    // 비어 있는 AABB(슬랩의 min > max)는 표면적 0 으로 취급
+    if (x.size() < 0.0f || y.size() < 0.0f || z.size() < 0.0f)
+    {
+      return 0.0f;
+    }
+    return 2.0f * (x.size() * y.size() + y.size() * z.size() + z.size() * x.size());
+  };
+
+  // AABB 의 중심점 계산
+  point3 centroid() const
+  {
+    return point3(0.5f * (x.min + x.max), 0.5f * (y.min + y.max), 0.5f * (z.min + z.max));
+  };
+
   // AABB 의 특수 상수 객체 선언
   static const aabb empty;    // 아무것도 감싸지 않는 최소 AABB
   static const aabb universe; // 모든 공간을 감싸는 무한한 AABB
@@ -172,6 +253,26 @@ aabb operator+(const vec3 &offset, const aabb &bbox)
   return bbox + offset;
 };
 
+// 주어진 AABB(bbox)의 8개 꼭짓점에 아핀 변환 t 를 적용한 뒤 다시 감싸는 AABB 를 반환 (회전이 있으면 원래보다 느슨해짐)
+inline aabb transform_bbox(const transform &t, const aabb &bbox)
+{
+  if (bbox.x.min > bbox.x.max || bbox.y.min > bbox.y.max || bbox.z.min > bbox.z.max)
+  {
+    return aabb(); // 비어 있는 AABB 는 변환해도 비어 있음
+  }
+
+  aabb result;
+  for (int i = 0; i < 8; i++)
+  {
+    point3 corner((i & 1) ? bbox.x.max : bbox.x.min,
+                  (i & 2) ? bbox.y.max : bbox.y.min,
+                  (i & 4) ? bbox.z.max : bbox.z.min);
+    point3 p = t.apply_point(corner);
+    result = aabb(result, aabb(p, p));
+  }
+  return result;
+};
+
 /**
  * aabb::hit()
  *
@@ -195,6 +296,11 @@ aabb operator+(const vec3 &offset, const aabb &bbox)
  *
  * 이 두 값이 겹치는지 여부(t_min < t_max)를 통해 AABB 교차 여부를 판단한다.
  *
+ * 가속 구조 순회에서는 같은 광선으로 수많은 AABB 를 검사하므로,
+ * 방향벡터 역수와 부호를 traversal_ray 에 한 번만 계산해두고 branchless 버전(slab_test())을 사용한다.
+ * 방향 부호를 알면 각 축에서 어느 경계면이 진입(near)/탈출(far) 면인지 미리 정해지므로 t0, t1 정렬 분기가 사라지고,
+ * 남은 min/max 누적은 분기 없는 명령어로 처리되어 분기 예측 실패가 발생하지 않는다.
+ *
  * 이 개념은 친구들 약속 시간 잡기 비유로도 이해할 수 있다:
  *   - 각 축의 슬랩은 친구 1명,
  *   - 슬랩이 허용하는 t 구간은 그 친구가 약속 가능한 시간대,
@@ -0,0 +1,109 @@
+#ifndef ACCELERATOR_HPP
+#define ACCELERATOR_HPP
+
+#include "bvh_build.hpp"
+#include "bvh_flat.hpp"
+#include "bvh_motion.hpp"
+#include "bvh_node.hpp"
+#include "bvh_quantized.hpp"
+#include "bvh_stats.hpp"
+#include "bvh_wide.hpp"
+#include "grid.hpp"
+#include "kd_tree.hpp"
+#include "hittable/hittable_list.hpp"
+
+/**
+ * scene 가속 구조 종류
+ *
+ * - none     : 가속 구조 없이 hittable_list 로 모든 객체를 선형 검사
+ * - bvh_tree : shared_ptr 포인터 트리 기반 이진 BVH (bvh_node)
+ * - bvh_flat : 깊이 우선 노드 배열로 평탄화된 이진 BVH (flat_bvh)
+ * - bvh_wide : 이진 BVH 를 접어서 만든 4-wide BVH (wide_bvh)
+ * - bvh_quantized : 자식 AABB 를 8 비트 정수로 양자화해서 노드 배열 크기를 줄인 이진 BVH (quantized_bvh)
+ * - bvh_motion : 셔터 시작/끝 시점 AABB 를 광선 시점으로 보간하는 모션 블러용 이진 BVH (motion_bvh)
+ * - grid     : 3D-DDA 로 순회하는 균일 격자 (uniform_grid)
+ * - kd_tree  : SAH 로 분할 평면을 고른 kd-tree (kd_tree)
+ */
+enum class accelerator_type
+{
+  none,
+  bvh_tree,
+  bvh_flat,
+  bvh_wide,
+  bvh_quantized,
+  bvh_motion,
+  grid,
+  kd_tree,
+};
+
+// 가속 구조 종류 이름 반환 (로그 및 벤치마크 출력용)
+inline const char *accelerator_name(accelerator_type type)
+{
+  switch (type)
+  {
+  case accelerator_type::none:
+    return "none";
+  case accelerator_type::bvh_tree:
+    return "bvh_tree";
+  case accelerator_type::bvh_flat:
+    return "bvh_flat";
+  case accelerator_type::bvh_wide:
+    return "bvh_wide";
+  case accelerator_type::bvh_quantized:
+    return "bvh_quantized";
+  case accelerator_type::bvh_motion:
+    return "bvh_motion";
+  case accelerator_type::grid:
+    return "grid";
+  case accelerator_type::kd_tree:
+    return "kd_tree";
+  }
+  return "unknown";
+};
+
+// 옵션에 따라 생성된 가속 구조의 품질 통계를 출력하거나 노드 AABB 를 OBJ 파일로 저장한 뒤 그대로 반환
+template <typename T>
+inline std::shared_ptr<hittable> report_accelerator(std::shared_ptr<T> accelerator, accelerator_type type, const bvh_build_options &options)
+{
+  if (options.report_stats || !options.stats_dump_path.empty())
+  {
+    bvh_stats stats = accelerator->stats(options.traversal_cost, options.intersection_cost);
+    if (options.report_stats)
+    {
+      stats.print(accelerator_name(type));
+    }
+    if (!options.stats_dump_path.empty())
+    {
+      stats.write_obj(options.stats_dump_path);
+    }
+  }
+  return accelerator;
+};
+
+// world(hittable_list) 의 객체들로 지정한 종류의 가속 구조를 생성하여 반환
+inline std::shared_ptr<hittable> make_accelerator(const hittable_list &world, accelerator_type type,
+                                                  const bvh_build_options &options = bvh_build_options())
+{
+  switch (type)
+  {
+  case accelerator_type::bvh_tree:
+    return report_accelerator(std::make_shared<bvh_node>(world, options), type, options);
+  case accelerator_type::bvh_flat:
+    return report_accelerator(std::make_shared<flat_bvh>(world, options), type, options);
+  case accelerator_type::bvh_wide:
+    return report_accelerator(std::make_shared<wide_bvh>(world, options), type, options);
+  case accelerator_type::bvh_quantized:
+    return report_accelerator(std::make_shared<quantized_bvh>(world, options), type, options);
+  case accelerator_type::bvh_motion:
+    return report_accelerator(std::make_shared<motion_bvh>(world, options), type, options);
+  case accelerator_type::grid:
+    return std::make_shared<uniform_grid>(world, options); // 트리가 아니므로 bvh_stats 대신 생성자에서 격자 해상도와 cell 통계를 출력
+  case accelerator_type::kd_tree:
+    return report_accelerator(std::make_shared<kd_tree>(world, options), type, options);
+  case accelerator_type::none:
+    break;
+  }
+  return std::make_shared<hittable_list>(world);
+};
+
+#endif /* ACCELERATOR_HPP */
@@ -0,0 +1,1096 @@
+#ifndef BVH_BUILD_HPP
+#define BVH_BUILD_HPP
+
+#include "aabb.hpp"
+#include "common/parallel.hpp"
+#include "hittable/hittable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+/**
+ * BVH 빌드 시 사용하는 primitive 정보
+ *
+ * - 빌드 시작 시점에 각 primitive 의 AABB 와 중심점(centroid)을 한 번만 계산해서 평탄한(flat) 배열에 저장해둔다.
+ * - 이후 분할 과정에서는 가상 함수 hittable::bounding_box() 를 다시 호출하지 않고 이 배열만 참조한다.
+ */
+class bvh_build_prim
+{
+public:
+  aabb bbox;       // primitive 의 AABB
+  point3 centroid; // primitive AABB 의 중심점 -> 어느 bin / 어느 자식 노드에 속하는지 결정하는 기준
+  size_t index;    // 원본 hittable 객체 배열에서의 인덱스
+};
+
+/**
+ * BVH 빌드 결과 트리의 노드
+ *
+ * - 빌드 결과는 포인터 트리가 아닌 노드 배열(bvh_builder::nodes) 안의 인덱스로 서로를 참조한다.
+ * - bvh_node(포인터 트리), 평탄화된 BVH 등 실제 순회용 가속 구조는 이 중간 결과를 각자의 노드 형식으로 변환해서 사용한다.
+ */
+class bvh_build_node
+{
+public:
+  aabb bbox;         // 현재 노드를 감싸는 AABB
+  int left = -1;     // 내부 노드: 좌측 자식 노드 인덱스
+  int right = -1;    // 내부 노드: 우측 자식 노드 인덱스
+  size_t first = 0;  // 리프 노드: bvh_builder::prim_indices 내 primitive 범위의 시작 위치
+  size_t count = 0;  // 리프 노드: primitive 개수 (0 이면 내부 노드, 항상 max_leaf_size 이하)
+  int axis = 0;      // 내부 노드: 분할 축 (0: x, 1: y, 2: z) -> 순회 시 가까운 자식을 먼저 방문하는 데 사용
+
+  bool is_leaf() const { return count > 0; };
+};
+
+/**
+ * BVH 빌드 품질 (= 빌드 방식) 선택
+ *
+ * - high : SAH + binning 빌더. 빌드는 상대적으로 느리지만 광선 하나당 방문 노드 수가 적은 트리를 만든다.
+ * - fast : Morton code 정렬 기반 LBVH(Linear BVH) 빌더. 트리 품질은 떨어지지만 빌드가 거의 즉시 끝난다.
+ *          (primitive 수가 매우 많아서 렌더링 시간보다 빌드 시간이 더 중요한 경우에 사용)
+ * - spatial : high 의 SAH binning 에 공간 분할(spatial split)을 추가한 SBVH 빌더.
+ *             크기가 큰 primitive 를 분할 평면에서 잘라 여러 리프가 참조하도록 허용하므로, 거대한 평면과 작은 디테일이 섞인 scene 에서 트리 품질이 좋아진다.
+ *             (빌드는 단일 thread 로 수행되며 high 보다 느림)
+ */
+enum class bvh_build_quality
+{
+  fast,
+  high,
+  spatial,
+};
+
+/**
+ * BVH 빌드 옵션
+ *
+ * - 빌드 방식(품질), SAH 비용 모델의 상수와 binning 해상도, 리프 노드 최대 크기, 병렬 빌드 설정을 지정한다.
+ */
+class bvh_build_options
+{
+public:
+  bvh_build_quality quality = bvh_build_quality::high; // 빌드 방식 (high: SAH binning, fast: LBVH, spatial: SBVH)
+  int bin_count = 16;                                  // 축 하나당 centroid binning 에 사용할 bin 개수
+  size_t max_leaf_size = 4;                            // 리프 노드 하나에 담을 수 있는 최대 primitive 개수 (bvh_max_leaf_size 로 제한됨)
+  double traversal_cost = 1.0f;                        // 내부 노드 하나를 방문(AABB 검사)하는 상대 비용
+  double intersection_cost = 1.0f;                     // primitive 하나와 교차 검사하는 상대 비용
+  int max_depth = 64;                                  // 트리 최대 깊이 -> 고정 크기 스택으로 순회하는 가속 구조(flat_bvh 등)의 스택 크기 상한
+  int thread_count = 0;                                // 빌드에 사용할 thread 개수 (0 이면 하드웨어 thread 개수, 1 이면 단일 thread 빌드)
+  size_t parallel_threshold = 4096;                    // primitive 수가 이 값 이상인 노드에서만 서브트리 병렬 빌드 및 병렬 binning 수행
+  double spatial_split_alpha = 1e-5;                   // SBVH: object 분할의 두 자식 AABB 겹침 표면적 / 루트 표면적이 이 값보다 클 때만 공간 분할을 시도
+  double duplication_budget = 0.5;                     // SBVH: 공간 분할로 늘어날 수 있는 primitive 참조 수 상한 (원래 primitive 수 대비 비율, 0.5 -> 최대 1.5배)
+  double grid_density = 4.0f;                          // uniform_grid: primitive 하나당 평균 cell 개수 (해상도 결정, grid.hpp 참고)
+  int motion_segments = 2;                             // motion_bvh: 셔터 구간을 나눌 시간 segment 개수 (segment 마다 트리를 따로 구축, bvh_motion.hpp 참고)
+  bool report_timings = false;                         // true 이면 빌드 완료 후 단계별 소요 시간을 콘솔에 출력
+  bool report_stats = false;                           // true 이면 가속 구조 생성 후 트리 품질 통계(bvh_stats)를 콘솔에 출력 (make_accelerator() 에서 처리)
+  std::string stats_dump_path;                         // 비어 있지 않으면 가속 구조 노드 AABB 를 이 경로에 OBJ wireframe 으로 저장
+  std::string cache_path;                              // 비어 있지 않으면 빌드 결과를 이 경로의 캐시 파일로 저장하고, 다음 실행에서 scene 이 같으면 mmap 으로 재사용 (flat_bvh 전용, bvh_cache.hpp 참고)
+};
+
+// 평탄화된 노드들(bvh_flat_node, wide_bvh_node 등)이 리프 primitive 개수를 uint16_t 로 저장하므로 허용하는 최대 리프 크기
+const size_t bvh_max_leaf_size = std::numeric_limits<uint16_t>::max();
+
+// 빌더가 실제로 사용하는 옵션 (max_leaf_size 를 노드의 리프 개수 필드가 표현할 수 있는 범위로 제한)
+// -> 더 큰 값을 그대로 쓰면 평탄화 단계에서 리프 개수가 잘려서 primitive 가 순회에서 조용히 빠지게 됨
+inline bvh_build_options effective_build_options(bvh_build_options options)
+{
+  if (options.max_leaf_size > bvh_max_leaf_size)
+  {
+    options.max_leaf_size = bvh_max_leaf_size;
+  }
+  return options;
+};
+
+/**
+ * BVH 빌드 단계별 소요 시간 (ms)
+ */
+class bvh_build_timings
+{
+public:
+  double prepare_ms = 0.0;   // primitive AABB / 중심점 계산
+  double sort_ms = 0.0;      // Morton code 계산 및 radix sort (LBVH 빌드에서만 사용)
+  double hierarchy_ms = 0.0; // 트리 구성 (분할 및 노드 생성)
+  double total_ms = 0.0;     // 전체 빌드 시간
+};
+
+/**
+ * BVH 빌더
+ *
+ * - hittable 객체 배열을 입력으로 받아 bvh_build_node 배열 형태의 이진 트리를 구성한다.
+ * - quality == high : 각 노드에서 x, y, z 세 축 모두에 대해 primitive 중심점을 bin_count 개의 bin 으로 나누고,
+ *   bin 경계마다 SAH 비용을 계산하여 가장 비용이 낮은 분할 평면을 선택한다. (하단 필기 참고)
+ *   분할 비용보다 리프 노드로 남기는 비용이 더 낮으면 (max_leaf_size 이하인 경우에 한해) 리프 노드를 생성한다.
+ * - quality == fast : primitive 중심점의 Morton code 를 radix sort 한 뒤, code 의 최상위 비트부터 차례로 분할하여 트리를 구성한다.
+ * - 두 방식 모두 primitive 수가 parallel_threshold 이상인 상위 노드에서는 좌/우 서브트리를 서로 다른 thread 에서 동시에 구성하고,
+ *   SAH binning 도 여러 thread 로 나눠서 수행한다. (하단 필기 참고)
+ * - quality == spatial : 노드마다 object 분할과 공간 분할(primitive 참조를 분할 평면으로 잘라 양쪽 자식에 복제) 중 SAH 비용이 낮은 쪽을 선택한다.
+ *   이 경우 prim_indices 에 같은 primitive 가 여러 번 나타날 수 있으므로 prim_indices.size() 가 primitive 수보다 클 수 있다.
+ */
+class bvh_builder
+{
+public:
+  // bounds_time 이 0 ~ 1 이면 셔터 구간 전체를 감싸는 AABB 대신 그 시점의 AABB(bounding_box_at())로 분할 위치를 결정한다.
+  // -> 노드 AABB 가 다른 시점의 primitive 를 감싸지 않으므로, 노드 AABB 를 따로 다시 계산하는 motion_bvh 에서만 사용
+  bvh_builder(const std::vector<std::shared_ptr<hittable>> &objects, const bvh_build_options &options = bvh_build_options(),
+              double bounds_time = -1.0f)
+      : options(effective_build_options(options))
+  {
+    auto build_start = std::chrono::steady_clock::now();
+    const int thread_count = resolve_thread_count(options.thread_count);
+
+    // 1. 각 primitive 의 AABB 와 중심점을 한 번만 계산하여 평탄한 배열에 저장 (primitive 별로 독립적이므로 병렬 계산)
+    prims.resize(objects.size());
+    parallel_for_chunks(objects.size(), objects.size() >= options.parallel_threshold ? thread_count : 1,
+                        [&](int, size_t begin, size_t end)
+                        {
+                          for (size_t i = begin; i < end; i++)
+                          {
+                            prims[i].bbox = bounds_time < 0.0f ? objects[i]->bounding_box() : objects[i]->bounding_box_at(bounds_time);
+                            prims[i].centroid = prims[i].bbox.centroid();
+                            prims[i].index = i;
+                          }
+                        });
+    build(build_start, thread_count);
+  };
+
+  // hittable 객체 배열 대신 primitive AABB 배열로 트리 구성 (triangle_mesh 처럼 primitive 마다 hittable 객체를 만들지 않는 경우에 사용)
+  // -> prim_indices 는 bounds 배열의 인덱스를 가리킴
+  bvh_builder(const std::vector<aabb> &bounds, const bvh_build_options &options = bvh_build_options())
+      : options(effective_build_options(options))
+  {
+    auto build_start = std::chrono::steady_clock::now();
+    const int thread_count = resolve_thread_count(options.thread_count);
+
+    prims.resize(bounds.size());
+    parallel_for_chunks(bounds.size(), bounds.size() >= options.parallel_threshold ? thread_count : 1,
+                        [&](int, size_t begin, size_t end)
+                        {
+                          for (size_t i = begin; i < end; i++)
+                          {
+                            prims[i].bbox = bounds[i];
+                            prims[i].centroid = bounds[i].centroid();
+                            prims[i].index = i;
+                          }
+                        });
+    build(build_start, thread_count);
+  };
+
+public:
+  std::vector<bvh_build_node> nodes; // 빌드된 트리의 노드 배열
+  std::vector<size_t> prim_indices;  // 리프 노드의 [first, first + count) 범위가 가리키는 원본 hittable 객체 인덱스 배열
+  int root = -1;                     // 루트 노드 인덱스
+  bvh_build_timings timings;         // 빌드 단계별 소요 시간
+
+private:
+  // prims 배열이 채워진 뒤 (2 ~ 4 단계) 트리를 구성하고 단계별 소요 시간 기록
+  void build(std::chrono::steady_clock::time_point build_start, int thread_count)
+  {
+    auto prepare_end = std::chrono::steady_clock::now();
+
+    // 2. LBVH 빌드: Morton code 순서로 primitive 정렬
+    if (options.quality == bvh_build_quality::fast)
+    {
+      sort_by_morton_code(thread_count);
+    }
+    auto sort_end = std::chrono::steady_clock::now();
+
+    // 3. 루트 노드부터 재귀적으로 분할하며 트리 구성 (노드 수는 최대 2n - 1 개)
+    nodes.reserve(prims.empty() ? 1 : 2 * prims.size() - 1);
+    if (options.quality == bvh_build_quality::spatial)
+    {
+      // SBVH 빌드: 노드마다 primitive 참조(reference) 배열을 좌/우로 나눠 담으며 트리를 구성하고,
+      // 리프 노드가 만들어질 때 그 참조들을 prim_indices 에 추가함 (공간 분할로 같은 primitive 가 여러 리프에 들어갈 수 있음)
+      aabb bbox, centroid_bounds;
+      compute_bounds(0, prims.size(), 1, bbox, centroid_bounds);
+      root_area = bbox.surface_area();
+      reference_count = prims.size();
+      reference_budget = prims.size() + static_cast<size_t>(options.duplication_budget * prims.size());
+      std::vector<bvh_build_prim> refs(prims);
+      root = build_spatial(refs, 0, nodes);
+    }
+    else
+    {
+      root = build_recursive(0, prims.size(), 0, thread_count, nodes);
+
+      // 4. 리프 노드가 참조할 primitive 인덱스 배열 생성 (분할 과정에서 정렬된 prims 순서 그대로)
+      prim_indices.reserve(prims.size());
+      for (const auto &prim : prims)
+      {
+        prim_indices.push_back(prim.index);
+      }
+    }
+    auto build_end = std::chrono::steady_clock::now();
+
+    // 단계별 소요 시간 기록
+    timings.prepare_ms = elapsed_ms(build_start, prepare_end);
+    timings.sort_ms = elapsed_ms(prepare_end, sort_end);
+    timings.hierarchy_ms = elapsed_ms(sort_end, build_end);
+    timings.total_ms = elapsed_ms(build_start, build_end);
+
+    if (options.report_timings)
+    {
+      printf("BVH build [%s, %d threads] %zu prims (%zu references) -> %zu nodes | prepare %.2f ms, sort %.2f ms, hierarchy %.2f ms, total %.2f ms\n",
+             quality_name(options.quality), options.quality == bvh_build_quality::spatial ? 1 : thread_count, prims.size(), prim_indices.size(),
+             nodes.size(), timings.prepare_ms, timings.sort_ms, timings.hierarchy_ms, timings.total_ms);
+    }
+  };
+
+  // 하나의 bin 에 누적되는 정보
+  class bin
+  {
+  public:
+    aabb bbox = aabb::empty; // bin 에 속한 primitive 들의 AABB 합집합
+    size_t count = 0;        // bin 에 속한 primitive 개수
+  };
+
+  // Morton code 의 축당 비트 수 (21 비트 * 3 축 = 63 비트 code)
+  static const int morton_bits_per_axis = 21;
+
+  /**
+   * prims[start, end) 구간을 하나의 노드로 만들고, 필요하면 두 자식 노드로 재귀 분할한 뒤 out 배열 내 노드 인덱스를 반환
+   *
+   * - thread_budget 은 이 서브트리를 구성하는 데 사용할 수 있는 thread 개수이다.
+   *   2 이상이면 좌측 서브트리를 새 thread 에서 별도의 노드 배열로 구성하고, 우측 서브트리는 현재 thread 에서 구성한 뒤 out 에 이어 붙인다.
+   *   (두 서브트리는 prims 배열의 서로 겹치지 않는 구간만 수정하므로 동기화가 필요 없음)
+   */
+  int build_recursive(size_t start, size_t end, int depth, int thread_budget, std::vector<bvh_build_node> &out)
+  {
+    int node_index = static_cast<int>(out.size());
+    out.push_back(bvh_build_node());
+
+    size_t object_span = end - start;
+    bool parallel = thread_budget > 1 && object_span >= options.parallel_threshold;
+
+    // 현재 노드의 AABB 와 중심점들을 감싸는 AABB(centroid bounds) 계산
+    aabb bbox, centroid_bounds;
+    compute_bounds(start, end, parallel ? thread_budget : 1, bbox, centroid_bounds);
+    out[node_index].bbox = bbox;
+
+    // primitive 가 1개뿐이면 더 이상 나눌 수 없으므로 리프 노드 생성
+    if (object_span <= 1)
+    {
+      make_leaf(out[node_index], start, object_span);
+      return node_index;
+    }
+
+    // 빌드 방식에 따라 분할 위치(mid)와 분할 축 결정 (리프 노드로 남기는 게 나으면 false 반환)
+    size_t mid = start;
+    int axis = 0;
+    bool split = options.quality == bvh_build_quality::fast
+                     ? split_morton(start, end, mid, axis)
+                     : split_sah(start, end, bbox, centroid_bounds, parallel ? thread_budget : 1, mid, axis);
+    if (!split)
+    {
+      make_leaf(out[node_index], start, object_span);
+      return node_index;
+    }
+
+    // 분할에 실패했거나(모든 중심점이 한 점에 모여 binning 이 불가능하거나 한쪽이 비어버린 경우), 남은 primitive 를 절반씩 나눠도
+    // max_depth 안에 다 담기 어려울 만큼 깊어진 경우 -> 가장 긴 축 기준 object median 분할로 대체하여 트리 깊이를 제한함
+    if (mid == start || mid == end || depth + ceil_log2(object_span) >= options.max_depth - 1)
+    {
+      if (options.quality == bvh_build_quality::fast)
+      {
+        // LBVH: prims 는 이미 Morton code 순서로 정렬되어 있으므로, 재정렬 없이 code 순서상 중간에서 분할 (morton_codes 와의 대응 유지)
+        mid = start + object_span / 2;
+      }
+      else
+      {
+        axis = centroid_bounds.longest_axis();
+        mid = start + object_span / 2;
+        std::nth_element(prims.begin() + start, prims.begin() + mid, prims.begin() + end,
+                         [axis](const bvh_build_prim &a, const bvh_build_prim &b)
+                         { return a.centroid[axis] < b.centroid[axis]; });
+      }
+    }
+
+    int left, right;
+    if (parallel)
+    {
+      // 좌측 서브트리는 새 thread 에서, 우측 서브트리는 현재 thread 에서 각자의 노드 배열로 구성
+      int left_budget = thread_budget / 2;
+      int right_budget = thread_budget - left_budget;
+      std::vector<bvh_build_node> left_nodes, right_nodes;
+      std::thread left_worker([&]()
+                              { build_recursive(start, mid, depth + 1, left_budget, left_nodes); });
+      build_recursive(mid, end, depth + 1, right_budget, right_nodes);
+      left_worker.join();
+
+      // 두 서브트리 노드 배열을 out 뒤에 이어 붙임 (각 서브트리의 루트는 해당 배열의 0번 노드)
+      left = append_nodes(out, left_nodes);
+      right = append_nodes(out, right_nodes);
+    }
+    else
+    {
+      // 좌/우 서브트리를 재귀적으로 구성 (push_back 으로 out 이 재할당될 수 있으므로 인덱스로 접근)
+      left = build_recursive(start, mid, depth + 1, 1, out);
+      right = build_recursive(mid, end, depth + 1, 1, out);
+    }
+    out[node_index].left = left;
+    out[node_index].right = right;
+    out[node_index].axis = axis;
+    return node_index;
+  };
+
+  // prims[start, end) 의 AABB 합집합과 중심점들을 감싸는 AABB 계산 (thread_count 가 2 이상이면 구간을 나눠 병렬 계산 후 합침)
+  void compute_bounds(size_t start, size_t end, int thread_count, aabb &bbox, aabb &centroid_bounds) const
+  {
+    if (thread_count <= 1)
+    {
+      bbox = aabb::empty;
+      centroid_bounds = aabb::empty;
+      for (size_t i = start; i < end; i++)
+      {
+        bbox = aabb(bbox, prims[i].bbox);
+        centroid_bounds = aabb(centroid_bounds, aabb_of_point(prims[i].centroid));
+      }
+      return;
+    }
+
+    std::vector<aabb> chunk_bbox(thread_count, aabb::empty);
+    std::vector<aabb> chunk_centroid(thread_count, aabb::empty);
+    int chunks = parallel_for_chunks(end - start, thread_count,
+                                     [&](int chunk, size_t begin, size_t finish)
+                                     {
+                                       aabb b = aabb::empty, c = aabb::empty;
+                                       for (size_t i = start + begin; i < start + finish; i++)
+                                       {
+                                         b = aabb(b, prims[i].bbox);
+                                         c = aabb(c, aabb_of_point(prims[i].centroid));
+                                       }
+                                       chunk_bbox[chunk] = b;
+                                       chunk_centroid[chunk] = c;
+                                     });
+
+    bbox = aabb::empty;
+    centroid_bounds = aabb::empty;
+    for (int c = 0; c < chunks; c++)
+    {
+      bbox = aabb(bbox, chunk_bbox[c]);
+      centroid_bounds = aabb(centroid_bounds, chunk_centroid[c]);
+    }
+  };
+
+  // SAH 비용이 가장 낮은 분할 평면으로 prims[start, end) 를 분할 (리프 노드로 남기는 비용이 더 저렴하면 false 반환)
+  bool split_sah(size_t start, size_t end, const aabb &bbox, const aabb &centroid_bounds, int thread_count, size_t &mid, int &axis)
+  {
+    size_t object_span = end - start;
+
+    // SAH 비용이 가장 낮은 분할 축과 bin 경계 탐색
+    int best_axis = -1;
+    int best_split = -1;
+    double best_cost = infinity;
+    find_best_split(prims, start, end, bbox, centroid_bounds, thread_count, best_axis, best_split, best_cost);
+
+    // 현재 노드를 리프 노드로 남겼을 때의 비용 (모든 primitive 와 교차 검사)
+    double leaf_cost = options.intersection_cost * object_span;
+
+    // 리프 노드 비용이 더 저렴하고 최대 리프 크기를 넘지 않으면 분할하지 않고 리프 노드 생성
+    if (object_span <= options.max_leaf_size && (best_axis < 0 || leaf_cost <= best_cost))
+    {
+      return false;
+    }
+
+    mid = start;
+    if (best_axis >= 0)
+    {
+      // 선택된 bin 경계 기준으로 primitive 들을 좌/우로 분할 (정렬 없이 O(n) partition)
+      auto first = prims.begin() + start;
+      auto last = prims.begin() + end;
+      auto pivot = std::partition(first, last, [&](const bvh_build_prim &prim)
+                                  { return bin_index(prim.centroid, centroid_bounds, best_axis) <= best_split; });
+      mid = start + (pivot - first);
+      axis = best_axis;
+    }
+    return true;
+  };
+
+  // source[start, end) 에 대해 세 축 모두 binning 후 SAH 비용이 가장 낮은 (축, bin 경계) 조합을 찾는 함수
+  void find_best_split(const std::vector<bvh_build_prim> &source, size_t start, size_t end, const aabb &bbox, const aabb &centroid_bounds,
+                       int thread_count, int &best_axis, int &best_split, double &best_cost) const
+  {
+    const int bin_count = options.bin_count;
+    double parent_area = bbox.surface_area();
+
+    // 중심점들이 모두 같은 위치에 있어서 binning 할 수 없는 축 표시
+    bool axis_valid[3];
+    for (int axis = 0; axis < 3; axis++)
+    {
+      axis_valid[axis] = centroid_bounds.axis_interval(axis).size() > 0.0f;
+    }
+
+    // 1. 각 primitive 를 중심점 위치에 따라 세 축의 bin 에 동시에 배정하며 bin 별 AABB 와 개수 누적
+    // -> 구간을 thread 별로 나눠서 각자의 bin 배열(chunk_bins[chunk])에 누적한 뒤 마지막에 합침
+    std::vector<std::vector<bin>> chunk_bins(thread_count, std::vector<bin>(3 * bin_count));
+    int chunks = parallel_for_chunks(end - start, thread_count,
+                                     [&](int chunk, size_t begin, size_t finish)
+                                     {
+                                       std::vector<bin> &local = chunk_bins[chunk];
+                                       for (size_t i = start + begin; i < start + finish; i++)
+                                       {
+                                         for (int axis = 0; axis < 3; axis++)
+                                         {
+                                           if (!axis_valid[axis])
+                                             continue;
+                                           bin &b = local[axis * bin_count + bin_index(source[i].centroid, centroid_bounds, axis)];
+                                           b.bbox = aabb(b.bbox, source[i].bbox);
+                                           b.count++;
+                                         }
+                                       }
+                                     });
+    std::vector<bin> &bins = chunk_bins[0];
+    for (int c = 1; c < chunks; c++)
+    {
+      for (int i = 0; i < 3 * bin_count; i++)
+      {
+        bins[i].bbox = aabb(bins[i].bbox, chunk_bins[c][i].bbox);
+        bins[i].count += chunk_bins[c][i].count;
+      }
+    }
+
+    std::vector<double> right_cost(bin_count);
+    for (int axis = 0; axis < 3; axis++)
+    {
+      // 현재 축 방향으로 중심점들이 모두 같은 위치에 있으면 이 축으로는 분할 불가
+      if (!axis_valid[axis])
+      {
+        continue;
+      }
+      const bin *axis_bins = &bins[axis * bin_count];
+
+      // 2. 오른쪽 끝에서부터 bin 을 누적하며 각 경계 오른쪽 영역의 (표면적 * 개수) 계산
+      aabb right_box = aabb::empty;
+      size_t right_count = 0;
+      for (int i = bin_count - 1; i > 0; i--)
+      {
+        right_box = aabb(right_box, axis_bins[i].bbox);
+        right_count += axis_bins[i].count;
+        right_cost[i - 1] = right_count > 0 ? right_box.surface_area() * right_count : 0.0f;
+      }
+
+      // 3. 왼쪽 끝에서부터 bin 을 누적하며 각 경계(split = i -> bin[0..i] 이 왼쪽)에서의 SAH 비용 계산
+      aabb left_box = aabb::empty;
+      size_t left_count = 0;
+      for (int i = 0; i < bin_count - 1; i++)
+      {
+        left_box = aabb(left_box, axis_bins[i].bbox);
+        left_count += axis_bins[i].count;
+
+        // 한쪽 자식이 비어버리는 분할은 무의미하므로 제외
+        if (left_count == 0 || left_count == end - start)
+        {
+          continue;
+        }
+
+        double left_cost = left_box.surface_area() * left_count;
+        double cost = options.traversal_cost + options.intersection_cost * (left_cost + right_cost[i]) / parent_area;
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_axis = axis;
+          best_split = i;
+        }
+      }
+    }
+  };
+
+  /**
+   * SBVH 빌드: refs 배열의 primitive 참조들로 노드 하나를 만들고, 필요하면 object 분할 또는 공간 분할로 두 자식 노드를 재귀적으로 구성 (하단 필기 참고)
+   *
+   * - refs 의 bbox 는 공간 분할로 잘린(clipped) AABB 일 수 있으며, 자식 참조 배열로 나눈 뒤에는 refs 메모리를 바로 해제한다.
+   */
+  int build_spatial(std::vector<bvh_build_prim> &refs, int depth, std::vector<bvh_build_node> &out)
+  {
+    int node_index = static_cast<int>(out.size());
+    out.push_back(bvh_build_node());
+
+    aabb bbox, centroid_bounds;
+    compute_reference_bounds(refs, bbox, centroid_bounds);
+    out[node_index].bbox = bbox;
+
+    size_t count = refs.size();
+    if (count <= 1)
+    {
+      make_spatial_leaf(out[node_index], refs);
+      return node_index;
+    }
+
+    // 1. object 분할 후보 (SAH binning)
+    int object_axis = -1, object_split = -1;
+    double object_cost = infinity;
+    find_best_split(refs, 0, count, bbox, centroid_bounds, 1, object_axis, object_split, object_cost);
+
+    // 2. 공간 분할 후보: object 분할의 두 자식 AABB 가 (루트 대비) 충분히 겹치고, 참조 수 예산이 남아 있을 때만 탐색
+    bool depth_limited = depth + ceil_log2(count) >= options.max_depth - 1;
+    int spatial_axis = -1, spatial_split = -1;
+    double spatial_cost = infinity;
+    if (!depth_limited && reference_count < reference_budget &&
+        object_split_overlap(refs, centroid_bounds, object_axis, object_split) > options.spatial_split_alpha * root_area)
+    {
+      find_best_spatial_split(refs, bbox, spatial_axis, spatial_split, spatial_cost);
+    }
+
+    // 리프 노드 비용이 더 저렴하고 최대 리프 크기를 넘지 않으면 리프 노드 생성
+    double leaf_cost = options.intersection_cost * count;
+    if (count <= options.max_leaf_size && leaf_cost <= std::min(object_cost, spatial_cost))
+    {
+      make_spatial_leaf(out[node_index], refs);
+      return node_index;
+    }
+
+    // 3. 비용이 더 낮은 방식으로 참조들을 좌/우 자식 배열로 분배
+    std::vector<bvh_build_prim> left_refs, right_refs;
+    int axis = 0;
+    if (!depth_limited && spatial_axis >= 0 && spatial_cost < object_cost)
+    {
+      axis = spatial_axis;
+      split_references(refs, bbox, spatial_axis, spatial_split, left_refs, right_refs);
+    }
+    else if (!depth_limited && object_axis >= 0)
+    {
+      axis = object_axis;
+      for (const auto &ref : refs)
+      {
+        (bin_index(ref.centroid, centroid_bounds, object_axis) <= object_split ? left_refs : right_refs).push_back(ref);
+      }
+    }
+
+    // 분할할 수 없거나 너무 깊어진 경우 -> 가장 긴 축 기준 object median 분할로 대체
+    if (left_refs.empty() || right_refs.empty())
+    {
+      axis = centroid_bounds.longest_axis();
+      size_t mid = count / 2;
+      std::nth_element(refs.begin(), refs.begin() + mid, refs.end(),
+                       [axis](const bvh_build_prim &a, const bvh_build_prim &b)
+                       { return a.centroid[axis] < b.centroid[axis]; });
+      left_refs.assign(refs.begin(), refs.begin() + mid);
+      right_refs.assign(refs.begin() + mid, refs.end());
+    }
+    std::vector<bvh_build_prim>().swap(refs); // 자식 배열로 나눈 뒤에는 현재 노드의 참조 배열이 필요 없으므로 메모리 해제
+
+    int left = build_spatial(left_refs, depth + 1, out);
+    int right = build_spatial(right_refs, depth + 1, out);
+    out[node_index].left = left;
+    out[node_index].right = right;
+    out[node_index].axis = axis;
+    return node_index;
+  };
+
+  // 노드 AABB 를 축마다 bin_count 개의 같은 폭 구간으로 나누고, 각 참조를 걸치는 모든 구간에 잘린 AABB 로 누적하여
+  // SAH 비용이 가장 낮은 공간 분할 평면(축, 구간 경계)을 찾는 함수
+  void find_best_spatial_split(const std::vector<bvh_build_prim> &refs, const aabb &bbox,
+                               int &best_axis, int &best_split, double &best_cost) const
+  {
+    const int bin_count = options.bin_count;
+    double parent_area = bbox.surface_area();
+    std::vector<aabb> bin_bounds(bin_count);
+    std::vector<size_t> entry_count(bin_count), exit_count(bin_count);
+    std::vector<double> right_cost(bin_count);
+    std::vector<size_t> right_counts(bin_count);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+      const interval &extent = bbox.axis_interval(axis);
+      if (extent.size() <= 0.0f)
+      {
+        continue;
+      }
+
+      // 1. 각 참조가 시작하는 구간(entry)과 끝나는 구간(exit)을 세고, 걸치는 구간마다 구간 경계로 잘린 AABB 를 누적
+      std::fill(bin_bounds.begin(), bin_bounds.end(), aabb::empty);
+      std::fill(entry_count.begin(), entry_count.end(), 0);
+      std::fill(exit_count.begin(), exit_count.end(), 0);
+      for (const auto &ref : refs)
+      {
+        const interval &r = ref.bbox.axis_interval(axis);
+        int first = spatial_bin_index(r.min, extent);
+        int last = spatial_bin_index(r.max, extent);
+        for (int b = first; b <= last; b++)
+        {
+          bin_bounds[b] = aabb(bin_bounds[b], clip_bounds(ref.bbox, axis, spatial_bin_min(b, extent), spatial_bin_min(b + 1, extent)));
+        }
+        entry_count[first]++;
+        exit_count[last]++;
+      }
+
+      // 2. 오른쪽 끝에서부터 누적: 경계 i 의 오른쪽 자식은 구간 [i + 1, bin_count) 에서 끝나는 참조들
+      aabb right_box = aabb::empty;
+      size_t right_count = 0;
+      for (int i = bin_count - 1; i > 0; i--)
+      {
+        right_box = aabb(right_box, bin_bounds[i]);
+        right_count += exit_count[i];
+        right_cost[i - 1] = right_box.surface_area() * right_count;
+        right_counts[i - 1] = right_count;
+      }
+
+      // 3. 왼쪽 끝에서부터 누적: 경계 i 의 왼쪽 자식은 구간 [0, i] 에서 시작하는 참조들 (경계에 걸친 참조는 양쪽에 모두 포함)
+      aabb left_box = aabb::empty;
+      size_t left_count = 0;
+      for (int i = 0; i < bin_count - 1; i++)
+      {
+        left_box = aabb(left_box, bin_bounds[i]);
+        left_count += entry_count[i];
+        if (left_count == 0 || right_counts[i] == 0)
+        {
+          continue;
+        }
+
+        double cost = options.traversal_cost +
+                      options.intersection_cost * (left_box.surface_area() * left_count + right_cost[i]) / parent_area;
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_axis = axis;
+          best_split = i;
+        }
+      }
+    }
+  };
+
+  // 공간 분할 평면(axis 축의 split 번째 구간 경계)으로 참조들을 좌/우로 분배
+  // -> 평면에 걸친 참조는 잘린 AABB 로 양쪽에 복제하되, 한쪽에만 넣는 편이 SAH 비용이 더 낮으면 복제하지 않음 (reference unsplitting)
+  void split_references(const std::vector<bvh_build_prim> &refs, const aabb &bbox, int axis, int split,
+                        std::vector<bvh_build_prim> &left_refs, std::vector<bvh_build_prim> &right_refs)
+  {
+    const interval &extent = bbox.axis_interval(axis);
+    double plane = spatial_bin_min(split + 1, extent);
+
+    // 1. 걸친 참조를 일단 양쪽에 모두 넣었다고 가정하고 좌/우 자식 AABB 와 참조 수 계산
+    aabb left_box = aabb::empty, right_box = aabb::empty;
+    size_t left_count = 0, right_count = 0;
+    std::vector<size_t> straddling;
+    for (size_t i = 0; i < refs.size(); i++)
+    {
+      const interval &r = refs[i].bbox.axis_interval(axis);
+      int first = spatial_bin_index(r.min, extent);
+      int last = spatial_bin_index(r.max, extent);
+      if (last <= split)
+      {
+        left_box = aabb(left_box, refs[i].bbox);
+        left_count++;
+        left_refs.push_back(refs[i]);
+      }
+      else if (first > split)
+      {
+        right_box = aabb(right_box, refs[i].bbox);
+        right_count++;
+        right_refs.push_back(refs[i]);
+      }
+      else
+      {
+        left_box = aabb(left_box, clip_bounds(refs[i].bbox, axis, extent.min, plane));
+        right_box = aabb(right_box, clip_bounds(refs[i].bbox, axis, plane, extent.max));
+        left_count++;
+        right_count++;
+        straddling.push_back(i);
+      }
+    }
+
+    // 2. 걸친 참조마다 (양쪽 복제 / 왼쪽에만 / 오른쪽에만) 중 SAH 비용이 가장 낮은 쪽을 선택 (참조 수 예산을 다 쓰면 복제하지 않음)
+    for (size_t i : straddling)
+    {
+      const bvh_build_prim &ref = refs[i];
+      aabb left_whole(left_box, ref.bbox), right_whole(right_box, ref.bbox);
+      double split_cost = left_box.surface_area() * left_count + right_box.surface_area() * right_count;
+      double left_only = left_whole.surface_area() * left_count + right_box.surface_area() * (right_count - 1);
+      double right_only = left_box.surface_area() * (left_count - 1) + right_whole.surface_area() * right_count;
+      bool can_duplicate = reference_count < reference_budget;
+
+      if ((!can_duplicate || left_only < split_cost) && left_only <= right_only)
+      {
+        left_refs.push_back(ref);
+        left_box = left_whole;
+        right_count--;
+      }
+      else if (!can_duplicate || right_only < split_cost)
+      {
+        right_refs.push_back(ref);
+        right_box = right_whole;
+        left_count--;
+      }
+      else
+      {
+        bvh_build_prim left_part = ref, right_part = ref;
+        left_part.bbox = clip_bounds(ref.bbox, axis, extent.min, plane);
+        left_part.centroid = left_part.bbox.centroid();
+        right_part.bbox = clip_bounds(ref.bbox, axis, plane, extent.max);
+        right_part.centroid = right_part.bbox.centroid();
+        left_refs.push_back(left_part);
+        right_refs.push_back(right_part);
+        reference_count++;
+      }
+    }
+  };
+
+  // object 분할 후보의 두 자식 AABB 교집합 표면적 (분할 후보가 없으면 무한대 -> 항상 공간 분할을 시도)
+  double object_split_overlap(const std::vector<bvh_build_prim> &refs, const aabb &centroid_bounds, int axis, int split) const
+  {
+    if (axis < 0)
+    {
+      return infinity;
+    }
+
+    aabb left_box = aabb::empty, right_box = aabb::empty;
+    for (const auto &ref : refs)
+    {
+      aabb &side = bin_index(ref.centroid, centroid_bounds, axis) <= split ? left_box : right_box;
+      side = aabb(side, ref.bbox);
+    }
+
+    double dx = std::min(left_box.x.max, right_box.x.max) - std::max(left_box.x.min, right_box.x.min);
+    double dy = std::min(left_box.y.max, right_box.y.max) - std::max(left_box.y.min, right_box.y.min);
+    double dz = std::min(left_box.z.max, right_box.z.max) - std::max(left_box.z.min, right_box.z.min);
+    if (dx <= 0.0f || dy <= 0.0f || dz <= 0.0f)
+    {
+      return 0.0f;
+    }
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+  };
+
+  // 참조 배열의 AABB 합집합과 중심점들을 감싸는 AABB 계산
+  static void compute_reference_bounds(const std::vector<bvh_build_prim> &refs, aabb &bbox, aabb &centroid_bounds)
+  {
+    bbox = aabb::empty;
+    centroid_bounds = aabb::empty;
+    for (const auto &ref : refs)
+    {
+      bbox = aabb(bbox, ref.bbox);
+      centroid_bounds = aabb(centroid_bounds, aabb_of_point(ref.centroid));
+    }
+  };
+
+  // 참조 배열 전체를 담는 리프 노드 생성 (참조들이 가리키는 원본 인덱스를 prim_indices 끝에 추가)
+  void make_spatial_leaf(bvh_build_node &node, const std::vector<bvh_build_prim> &refs)
+  {
+    make_leaf(node, prim_indices.size(), refs.size());
+    for (const auto &ref : refs)
+    {
+      prim_indices.push_back(ref.index);
+    }
+  };
+
+  // 좌표 x 가 노드 AABB 의 axis 축 범위(extent)를 bin_count 등분한 구간 중 몇 번째에 속하는지 계산
+  int spatial_bin_index(double x, const interval &extent) const
+  {
+    int b = static_cast<int>(options.bin_count * ((x - extent.min) / extent.size()));
+    return b < 0 ? 0 : (b >= options.bin_count ? options.bin_count - 1 : b);
+  };
+
+  // b 번째 공간 분할 구간의 시작 좌표 (b == bin_count 이면 범위 끝)
+  double spatial_bin_min(int b, const interval &extent) const
+  {
+    return b >= options.bin_count ? extent.max : extent.min + extent.size() * b / options.bin_count;
+  };
+
+  // AABB 의 axis 축 범위를 [lo, hi] 로 잘라낸 AABB
+  static aabb clip_bounds(const aabb &box, int axis, double lo, double hi)
+  {
+    aabb clipped = box;
+    interval &ax = axis == 0 ? clipped.x : (axis == 1 ? clipped.y : clipped.z);
+    ax = interval(std::max(ax.min, lo), std::min(ax.max, hi));
+    return clipped;
+  };
+
+  // 빌드 방식 이름 (로그 출력용)
+  static const char *quality_name(bvh_build_quality quality)
+  {
+    switch (quality)
+    {
+    case bvh_build_quality::fast:
+      return "LBVH";
+    case bvh_build_quality::high:
+      return "SAH binned";
+    case bvh_build_quality::spatial:
+      return "SBVH";
+    }
+    return "unknown";
+  };
+
+  // Morton code 순서로 정렬된 prims[start, end) 를 서로 다른 최상위 비트 위치에서 분할 (code 가 모두 같으면 median 분할로 넘김)
+  bool split_morton(size_t start, size_t end, size_t &mid, int &axis) const
+  {
+    uint64_t first_code = morton_codes[start];
+    uint64_t last_code = morton_codes[end - 1];
+
+    // 구간 내 모든 code 가 같으면 공간적으로 더 나눌 기준이 없으므로 mid 를 start 로 두어 median 분할로 대체
+    if (first_code == last_code)
+    {
+      mid = start;
+      return true;
+    }
+
+    // 첫 code 와 마지막 code 가 처음으로 달라지는 최상위 비트 위치 -> 이 비트가 0 인 쪽과 1 인 쪽으로 분할
+    // (code 가 정렬되어 있으므로 해당 비트는 구간 내에서 0...0 1...1 형태로 나타남 -> 이진 탐색으로 경계 위치 탐색)
+    int bit = 63 - count_leading_zeros(first_code ^ last_code);
+    uint64_t mask = uint64_t(1) << bit;
+    size_t lo = start, hi = end - 1;
+    while (lo + 1 < hi)
+    {
+      size_t m = lo + (hi - lo) / 2;
+      if (morton_codes[m] & mask)
+        hi = m;
+      else
+        lo = m;
+    }
+    mid = hi;
+
+    // code 비트는 (x, y, z) 순서로 interleave 되어 있으므로 비트 위치로 분할 축을 알 수 있음
+    axis = 2 - (bit % 3);
+    return true;
+  };
+
+  // 모든 primitive 중심점의 Morton code 를 계산하고, (code, primitive) 쌍을 radix sort 하여 prims 를 code 순서로 재배치
+  void sort_by_morton_code(int thread_count)
+  {
+    size_t count = prims.size();
+    morton_codes.resize(count);
+    if (count == 0)
+    {
+      return;
+    }
+
+    // 1. 중심점 범위를 [0, 2^21) 정수 격자로 양자화할 수 있도록 전체 centroid bounds 계산
+    aabb bbox, centroid_bounds;
+    compute_bounds(0, count, count >= options.parallel_threshold ? thread_count : 1, bbox, centroid_bounds);
+
+    // 2. 각 primitive 의 Morton code 계산 (primitive 별로 독립적이므로 병렬 계산)
+    std::vector<uint64_t> keys(count);
+    std::vector<uint32_t> order(count);
+    parallel_for_chunks(count, count >= options.parallel_threshold ? thread_count : 1,
+                        [&](int, size_t begin, size_t end)
+                        {
+                          for (size_t i = begin; i < end; i++)
+                          {
+                            keys[i] = morton_code(prims[i].centroid, centroid_bounds);
+                            order[i] = static_cast<uint32_t>(i);
+                          }
+                        });
+
+    // 3. 8 비트씩 LSD radix sort (비교 정렬 없이 O(n) * 8 pass, 모든 key 의 해당 자릿수가 같은 pass 는 건너뜀)
+    std::vector<uint64_t> keys_tmp(count);
+    std::vector<uint32_t> order_tmp(count);
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+      size_t histogram[257] = {0};
+      for (size_t i = 0; i < count; i++)
+      {
+        histogram[((keys[i] >> shift) & 0xff) + 1]++;
+      }
+      if (histogram[((keys[0] >> shift) & 0xff) + 1] == count)
+      {
+        continue;
+      }
+      for (int d = 0; d < 256; d++)
+      {
+        histogram[d + 1] += histogram[d];
+      }
+      for (size_t i = 0; i < count; i++)
+      {
+        size_t dst = histogram[(keys[i] >> shift) & 0xff]++;
+        keys_tmp[dst] = keys[i];
+        order_tmp[dst] = order[i];
+      }
+      keys.swap(keys_tmp);
+      order.swap(order_tmp);
+    }
+
+    // 4. 정렬된 순서대로 prims 재배치
+    std::vector<bvh_build_prim> sorted(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      sorted[i] = prims[order[i]];
+    }
+    prims.swap(sorted);
+    morton_codes.swap(keys);
+  };
+
+  // 점 p 의 63 비트 Morton code 계산 (centroid_bounds 기준으로 각 축을 21 비트 정수로 양자화한 뒤 비트 interleave)
+  static uint64_t morton_code(const point3 &p, const aabb &centroid_bounds)
+  {
+    const double scale = double(uint64_t(1) << morton_bits_per_axis);
+    uint64_t q[3];
+    for (int axis = 0; axis < 3; axis++)
+    {
+      const interval &extent = centroid_bounds.axis_interval(axis);
+      double t = extent.size() > 0.0f ? (p[axis] - extent.min) / extent.size() : 0.0f;
+      double v = t * scale;
+      q[axis] = v <= 0.0f ? 0 : (v >= scale - 1.0f ? (uint64_t(1) << morton_bits_per_axis) - 1 : static_cast<uint64_t>(v));
+    }
+    return (expand_bits(q[0]) << 2) | (expand_bits(q[1]) << 1) | expand_bits(q[2]);
+  };
+
+  // 21 비트 정수의 각 비트 사이에 0 비트 2개씩을 끼워 넣어 63 비트로 확장 (ex> b2 b1 b0 -> b2 0 0 b1 0 0 b0)
+  static uint64_t expand_bits(uint64_t v)
+  {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffull;
+    v = (v | v << 16) & 0x1f0000ff0000ffull;
+    v = (v | v << 8) & 0x100f00f00f00f00full;
+    v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+  };
+
+  // 64 비트 정수의 최상위 1 비트 앞에 있는 0 비트 개수 (x != 0)
+  static int count_leading_zeros(uint64_t x)
+  {
+    int n = 0;
+    while (!(x & (uint64_t(1) << 63)))
+    {
+      x <<= 1;
+      n++;
+    }
+    return n;
+  };
+
+  // 중심점 c 가 axis 축 방향으로 몇 번째 bin 에 속하는지 계산
+  int bin_index(const point3 &c, const aabb &centroid_bounds, int axis) const
+  {
+    const interval &extent = centroid_bounds.axis_interval(axis);
+    int b = static_cast<int>(options.bin_count * ((c[axis] - extent.min) / extent.size()));
+    return b < 0 ? 0 : (b >= options.bin_count ? options.bin_count - 1 : b);
+  };
+
+  // n 개의 primitive 를 절반씩 나눴을 때 필요한 트리 깊이 (ceil(log2(n)))
+  static int ceil_log2(size_t n)
+  {
+    int depth = 0;
+    while ((size_t(1) << depth) < n)
+    {
+      depth++;
+    }
+    return depth;
+  };
+
+  // prims[start, start + count) 범위를 참조하는 리프 노드로 설정
+  static void make_leaf(bvh_build_node &node, size_t start, size_t count)
+  {
+    node.first = start;
+    node.count = count;
+  };
+
+  // 별도의 배열에서 구성한 서브트리 노드들을 out 뒤에 이어 붙이고, 서브트리 루트의 새 인덱스를 반환
+  static int append_nodes(std::vector<bvh_build_node> &out, const std::vector<bvh_build_node> &subtree)
+  {
+    int offset = static_cast<int>(out.size());
+    for (bvh_build_node node : subtree)
+    {
+      if (node.left >= 0)
+      {
+        node.left += offset;
+        node.right += offset;
+      }
+      out.push_back(node);
+    }
+    return offset;
+  };
+
+  // 점 하나를 감싸는 (두께 없는) AABB 생성 -> aabb(point3, point3) 생성자의 최소 두께 보정(pad_to_minimums) 없이 centroid bounds 를 누적하기 위함
+  static aabb aabb_of_point(const point3 &p)
+  {
+    aabb box;
+    box.x = interval(p.x(), p.x());
+    box.y = interval(p.y(), p.y());
+    box.z = interval(p.z(), p.z());
+    return box;
+  };
+
+  static double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+  {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+  };
+
+private:
+  bvh_build_options options;
+  std::vector<bvh_build_prim> prims;  // 빌드 중 분할 순서대로 재배치되는 primitive 정보 배열
+  std::vector<uint64_t> morton_codes; // LBVH 빌드: prims 와 같은 순서로 정렬된 각 primitive 의 Morton code
+  double root_area = 0.0f;            // SBVH 빌드: 루트 AABB 표면적 (공간 분할 시도 여부 판단 기준)
+  size_t reference_count = 0;         // SBVH 빌드: 현재까지의 primitive 참조 수 (공간 분할로 복제될 때마다 증가)
+  size_t reference_budget = 0;        // SBVH 빌드: 허용하는 최대 참조 수 (duplication_budget 으로 결정)
+};
+
+/**
+ * SAH(Surface Area Heuristic) 와 binning
+ *
+ *
+ * 광선이 부모 노드 AABB 를 통과했을 때 자식 노드 AABB 도 통과할 조건부 확률은
+ * 대략 두 AABB 의 표면적 비율(A_child / A_parent)에 비례한다.
+ * 따라서 어떤 분할의 기대 비용은 다음과 같이 추정할 수 있다.
+ *
+ *   cost = C_trav + C_isect * (A_L * N_L + A_R * N_R) / A_parent
+ *
+ *   - C_trav  : 내부 노드 방문 비용 (traversal_cost)
+ *   - C_isect : primitive 교차 검사 비용 (intersection_cost)
+ *   - A_L, A_R : 좌/우 자식 AABB 의 표면적
+ *   - N_L, N_R : 좌/우 자식에 속한 primitive 개수
+ *
+ * 이 비용을 분할하지 않고 리프로 남기는 비용(C_isect * N)과 비교해서,
+ * 리프가 더 저렴하면 분할을 멈춘다. (단, 리프 크기가 max_leaf_size 를 넘으면 강제로 분할)
+ *
+ * 모든 후보 분할 평면을 검사하려면 primitive 를 축마다 정렬해야 하지만,
+ * binning 방식은 중심점 범위를 고정된 개수(bin_count)의 구간으로 나누고
+ * 구간 경계(bin_count - 1 개)만 후보로 평가하므로, 노드 하나의 분할이 정렬 없이 O(n) 에 끝난다.
+ * 따라서 전체 빌드 비용은 O(n log n) 이 되며, 트리 품질은 완전 탐색 SAH 와 거의 차이가 없다.
+ *
+ * 분할 기준을 longest axis 의 object median 에서 SAH 로 바꾸면
+ * 크기가 제각각인 primitive(ex> 반지름 1000 인 지면 구체 + 반지름 0.2 인 작은 구체들)를 분리하는 트리가 만들어져
+ * 광선 하나당 방문하는 노드 수가 줄어든다.
+ */
+
+/**
+ * SBVH(Spatial split BVH)
+ *
+ *
+ * object 분할(SAH binning, LBVH)은 primitive 하나를 반드시 한쪽 자식에만 넣으므로,
+ * cornell box 의 555x555 벽/바닥 quad 처럼 노드 전체에 걸쳐 있는 큰 primitive 가 있으면 어느 쪽으로 보내든 그 자식 AABB 가 부모만큼 커지고
+ * 두 자식 AABB 가 크게 겹치게 된다. -> 겹친 영역을 지나는 광선은 양쪽 서브트리를 모두 방문해야 함
+ *
+ * 공간 분할(spatial split)은 primitive 대신 '공간'을 평면으로 나눈다.
+ * 분할 평면에 걸친 primitive 는 평면 양쪽 부분으로 잘린(clipped) AABB 를 가진 참조(reference)로 복제되어 두 자식에 모두 들어가므로,
+ * 자식 AABB 가 분할 평면을 넘지 않아 서로 겹치지 않는다.
+ *
+ * 매 노드에서 object 분할과 공간 분할의 SAH 비용을 모두 계산해서 더 저렴한 쪽을 선택하며,
+ * - 공간 분할 탐색은 object 분할 자식들의 겹침이 루트 표면적의 spatial_split_alpha 배보다 클 때만 수행하고 (겹침이 없으면 공간 분할 이득도 없음)
+ * - 평면에 걸친 참조도 한쪽에만 넣는 것이 더 저렴하면 복제하지 않으며 (reference unsplitting)
+ * - 전체 참조 수가 (1 + duplication_budget) * primitive 수를 넘으면 더 이상 복제하지 않는다. (메모리 및 리프 크기 증가 제한)
+ *
+ * hittable 은 AABB 외에 기하 정보를 노출하지 않으므로, 참조의 AABB 를 정확한 primitive 단면으로 다시 계산하지 않고
+ * 기존 AABB 를 분할 평면으로 자르기만 한다. (항상 실제 primitive 조각을 포함하므로 안전하며, 축 정렬 quad 는 정확히 잘림)
+ * 같은 primitive 가 여러 리프에서 검사될 수 있지만, 가장 가까운 교차점 탐색 결과는 동일하다.
+ */
+
+/**
+ * LBVH(Linear BVH) 와 Morton code
+ *
+ *
+ * Morton code 는 3차원 정수 좌표 (x, y, z) 의 비트를 x y z x y z ... 순서로 번갈아 끼워 넣어(interleave) 만든 하나의 정수이다.
+ * Morton code 순서로 점들을 정렬하면 Z-order 공간 채움 곡선(space-filling curve)을 따라 나열되므로,
+ * 정렬된 배열에서 인접한 primitive 들은 공간상으로도 가까이 있게 된다.
+ *
+ * 또한 code 의 최상위 비트는 공간을 x 축 기준 절반으로, 그다음 비트는 y 축 기준 절반으로 ... 나누는 것과 같으므로,
+ * 정렬된 구간에서 '첫 code 와 마지막 code 가 처음으로 달라지는 비트'를 경계로 나누는 것만으로 공간 분할 트리가 만들어진다.
+ *
+ * 따라서 LBVH 빌드는
+ *   1. primitive 마다 Morton code 계산 (병렬)
+ *   2. radix sort (비교 없이 O(n))
+ *   3. 정렬된 배열을 이진 탐색으로 분할
+ * 만으로 끝나며, SAH 비용 평가가 전혀 없어서 SAH 빌드보다 훨씬 빠르다.
+ * 대신 primitive 크기를 전혀 고려하지 않으므로 트리 품질(= 광선당 방문 노드 수)은 SAH 빌드보다 떨어진다.
+ */
+
+/**
+ * 병렬 BVH 빌드
+ *
+ *
+ * 어떤 노드를 좌/우로 분할하고 나면, 두 서브트리는 prims 배열의 서로 겹치지 않는 구간만 다루므로 완전히 독립적으로 구성할 수 있다.
+ * 따라서 primitive 수가 많은 상위 노드에서는 좌측 서브트리를 새 thread 에 맡기고, 우측 서브트리는 현재 thread 에서 구성한다.
+ * thread_budget 을 절반씩 나눠 내려보내므로, 트리 상위 log2(thread 수) 단계에서만 thread 가 생성된다.
+ *
+ * 단, 루트 근처의 노드는 서브트리 병렬화의 혜택을 받지 못하고(루트 노드 하나의 binning 은 한 thread 가 전체 primitive 를 훑어야 함)
+ * 이 부분이 전체 빌드 시간의 상당 부분을 차지한다.
+ * 그래서 상위 노드에서는 binning 자체도 primitive 구간을 나눠서 thread 별 bin 배열에 누적한 뒤 합치는 방식으로 병렬 처리한다.
+ */
+
+#endif /* BVH_BUILD_HPP */
@@ -0,0 +1,314 @@
+#ifndef BVH_FLAT_HPP
+#define BVH_FLAT_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_cache.hpp"
+#include "bvh_stats.hpp"
+#include "bvh_traversal.hpp"
+#include "leaf_primitives.hpp"
+#include "common/aligned_allocator.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * 평탄화된(flattened) BVH 의 노드
+ *
+ * - 32 바이트 크기로 고정하여 캐시 라인(64 바이트) 하나에 노드 2개가 정확히 들어가도록 함.
+ * - AABB 는 double 대신 float 로 저장하되, float 변환 시 min 은 아래로, max 는 위로 반올림(outward rounding)해서
+ *   원래 double AABB 를 항상 포함하도록 보장한다. (교차 검사는 다시 double 로 변환해서 수행)
+ * - 내부 노드의 첫 번째(좌측) 자식은 항상 배열에서 바로 다음 위치(index + 1)에 있으므로 저장하지 않고,
+ *   두 번째(우측) 자식의 인덱스만 offset 에 저장한다.
+ */
+class alignas(32) bvh_flat_node
+{
+public:
+  float bounds_min[3]; // AABB 각 축의 최솟값 (아래로 반올림)
+  uint32_t offset;     // 내부 노드: 두 번째(우측) 자식 노드 인덱스 / 리프 노드: flat_bvh::primitives 내 첫 번째 primitive 인덱스
+  float bounds_max[3]; // AABB 각 축의 최댓값 (위로 반올림)
+  uint16_t count;      // 리프 노드의 primitive 개수 (0 이면 내부 노드)
+  uint8_t axis;        // 내부 노드의 분할 축 (0: x, 1: y, 2: z)
+  uint8_t pad;         // 32 바이트 크기를 맞추기 위한 padding
+
+  bool is_leaf() const { return count > 0; };
+
+  // double AABB 를 float 로 변환할 때 원래 범위를 항상 포함하도록 바깥 방향으로 반올림하여 저장
+  void set_bounds(const aabb &box)
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      const interval &ax = box.axis_interval(axis);
+      bounds_min[axis] = round_down(ax.min);
+      bounds_max[axis] = round_up(ax.max);
+    }
+  };
+};
+
+static_assert(sizeof(bvh_flat_node) == 32, "bvh_flat_node must be 32 bytes");
+
+using bvh_flat_node_array = std::vector<bvh_flat_node, aligned_allocator<bvh_flat_node, 32>>; // 32 바이트 경계에 정렬된 노드 배열
+
+/**
+ * 빌드 결과 트리의 build_index 번째 노드를 노드 배열 끝에 추가하고, 서브트리 전체를 재귀적으로 이어 붙인 뒤 추가된 노드의 인덱스를 반환
+ * → 리프 노드의 primitive 범위(offset, count)는 leaf(build_node, node) 가 기록한다. (primitive 를 재배치하는 방식이 구조마다 다르므로)
+ */
+template <typename LEAF>
+inline uint32_t flatten_bvh(const bvh_builder &builder, int build_index, bvh_flat_node_array &nodes, const LEAF &leaf)
+{
+  const bvh_build_node &build_node = builder.nodes[build_index];
+
+  uint32_t index = static_cast<uint32_t>(nodes.size());
+  nodes.push_back(bvh_flat_node());
+  nodes[index].set_bounds(build_node.bbox);
+
+  if (build_node.is_leaf() || build_node.left < 0)
+  {
+    leaf(build_node, nodes[index]);
+    return index;
+  }
+
+  // 첫 번째 자식은 바로 다음 위치(index + 1)에 추가되므로 따로 저장하지 않고, 두 번째 자식의 인덱스만 기록
+  // (push_back 으로 nodes 가 재할당될 수 있으므로 참조 대신 인덱스로 접근)
+  flatten_bvh(builder, build_node.left, nodes, leaf);
+  uint32_t right = flatten_bvh(builder, build_node.right, nodes, leaf);
+  nodes[index].offset = right;
+  nodes[index].axis = static_cast<uint8_t>(build_node.axis);
+  nodes[index].count = 0;
+  return index;
+};
+
+// 리프 노드가 빌드 결과 primitive 순서의 [first, first + count) 범위를 그대로 참조하는 경우의 평탄화
+inline uint32_t flatten_bvh(const bvh_builder &builder, int build_index, bvh_flat_node_array &nodes)
+{
+  return flatten_bvh(builder, build_index, nodes,
+                     [](const bvh_build_node &build_node, bvh_flat_node &node)
+                     {
+                       node.offset = static_cast<uint32_t>(build_node.first);
+                       node.count = static_cast<uint16_t>(build_node.count);
+                     });
+};
+
+// bvh_flat_node 배열의 가장 가까운 교차점 탐색 (노드 AABB 는 float 경계 그대로 branchless slab_test() 로 검사, bvh_traversal.hpp 참고)
+template <typename LEAF>
+inline bool bvh_traverse_closest(const bvh_flat_node *nodes, const traversal_ray &tr, interval &ray_t, LEAF leaf)
+{
+  return bvh_traverse_closest(nodes, 0, tr, ray_t,
+                              [&tr](const bvh_flat_node &node, interval ray_t, double &t_entry)
+                              { return slab_test(tr, node.bounds_min, node.bounds_max, ray_t, t_entry); },
+                              leaf);
+};
+
+// bvh_flat_node 배열의 차폐 검사
+template <typename LEAF>
+inline bool bvh_traverse_any(const bvh_flat_node *nodes, const traversal_ray &tr, interval ray_t, LEAF leaf)
+{
+  return bvh_traverse_any(nodes, 0, tr, ray_t,
+                          [&tr](const bvh_flat_node &node, interval ray_t, double &t_entry)
+                          { return slab_test(tr, node.bounds_min, node.bounds_max, ray_t, t_entry); },
+                          leaf);
+};
+
+/**
+ * 평탄화된(flattened) BVH 클래스
+ *
+ * - bvh_node 와 동일하게 hittable_list 를 입력으로 받아 bvh_builder(SAH + binning)로 트리를 구성한 뒤,
+ *   포인터 트리 대신 깊이 우선(depth-first) 순서로 나열된 하나의 연속된 노드 배열로 변환한다.
+ * - 리프 노드는 primitives 배열의 [offset, offset + count) 범위를 참조한다.
+ *   primitives 는 빌드 결과의 primitive 인덱스 순서대로 타입별 값 배열에 복사해두었으므로, 리프 하나의 primitive 들이 메모리상에 연속으로 놓인다.
+ * - 노드 방문 시 가상 함수 호출 없이 반복문으로 순회하며, 리프의 sphere / quad 도 가상 함수 대신 직접 호출로 검사한다.
+ */
+class flat_bvh : public hittable
+{
+public:
+  flat_bvh(hittable_list list, const bvh_build_options &options = bvh_build_options())
+  {
+    // 순회 스택 크기를 넘지 않도록 트리 최대 깊이 제한
+    bvh_build_options build_options = options;
+    if (build_options.max_depth > bvh_stack_capacity)
+    {
+      build_options.max_depth = bvh_stack_capacity;
+    }
+
+    if (options.cache_path.empty())
+    {
+      build(list, build_options);
+      return;
+    }
+
+    // 캐시 파일이 현재 scene 과 일치하면 빌드 없이 mmap 한 노드 배열을 그대로 사용하고, 아니면 빌드 후 캐시 파일 갱신 (bvh_cache.hpp 참고)
+    uint64_t scene_hash = bvh_scene_hash(list.objects, build_options);
+    if (load_cache(list, options.cache_path, scene_hash))
+    {
+      return;
+    }
+    std::vector<size_t> prim_indices = build(list, build_options);
+    write_bvh_cache(options.cache_path, scene_hash, nodes.data(), sizeof(bvh_flat_node), nodes.size(), prim_indices);
+  };
+
+  // node_array 가 멤버 nodes 또는 매핑된 캐시 파일을 가리키므로 복사 금지
+  flat_bvh(const flat_bvh &) = delete;
+  flat_bvh &operator=(const flat_bvh &) = delete;
+
+  // 광선과의 교차 여부 검사
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    // 광선 방향벡터의 역수와 각 축의 방향 부호를 노드마다 계산하지 않고 광선 하나당 한 번만 계산
+    const traversal_ray tr(r);
+
+    // near child first 순회 (bvh_traversal.hpp 참고), 리프에서는 가장 가까운 교차 primitive 의 리프 순서 인덱스만 기록
+    uint32_t closest = 0;
+    bool hit_anything = bvh_traverse_closest(node_array, tr, ray_t,
+                                             [&](const bvh_flat_node &node, interval &ray_t)
+                                             { return primitives.intersect(node.offset, node.count, r, ray_t, rec, closest); });
+
+    // 순회가 끝난 뒤 가장 가까운 교차점 하나에 대해서만 교차점, normal, uv, material 계산
+    if (hit_anything)
+    {
+      primitives.finalize(closest, r, ray_t.max, rec);
+    }
+    return hit_anything;
+  };
+
+  // 차폐 검사: 교차하는 primitive 를 하나라도 찾으면 즉시 종료 (스택에 넣은 노드의 진입 거리 비교 불필요)
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    return bvh_traverse_any(node_array, tr, ray_t,
+                            [&](const bvh_flat_node &node, interval ray_t)
+                            { return primitives.occluded(node.offset, node.count, r, ray_t); });
+  };
+
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (!primitives.empty())
+    {
+      collect_stats(result, 0, 0);
+    }
+    return result;
+  };
+
+  // 전체 BVH 를 감싸는 AABB 반환 함수
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  bvh_flat_node_array nodes;                                              // 깊이 우선 순서로 나열된 노드 배열 (32 바이트 경계 정렬, 캐시에서 불러온 경우 비어 있음)
+  const bvh_flat_node *node_array = nullptr;                              // 순회에 사용할 노드 배열 (nodes.data() 또는 mmap 된 캐시 파일 내부 주소)
+  std::shared_ptr<mapped_file> cache_file;                                // node_array 가 가리키는 매핑된 캐시 파일 (캐시를 사용하지 않으면 nullptr)
+  leaf_primitives primitives;                                             // 리프 노드 범위 순서대로 타입별 배열에 재배치된 primitive (leaf_primitives.hpp 참고)
+  aabb bbox;                                                              // 전체 BVH 를 감싸는 AABB (루트 노드의 double 정밀도 AABB)
+
+private:
+  // bvh_builder 로 트리를 빌드하고 노드 배열로 평탄화한 뒤, 빌드 결과 primitive 순서(원래 인덱스)를 반환
+  std::vector<size_t> build(const hittable_list &list, const bvh_build_options &build_options)
+  {
+    bvh_builder builder(list.objects, build_options);
+
+    // 리프 노드가 연속된 범위로 참조할 수 있도록 빌드 결과 순서대로 primitive 재배치
+    primitives.reserve(builder.prim_indices.size());
+    for (size_t index : builder.prim_indices)
+    {
+      primitives.add(list.objects[index]);
+    }
+
+    // 빌드 결과 트리를 깊이 우선 순서의 노드 배열로 변환
+    nodes.reserve(builder.nodes.size());
+    bbox = builder.nodes[builder.root].bbox;
+    flatten_bvh(builder, builder.root, nodes);
+    node_array = nodes.data();
+    return builder.prim_indices;
+  };
+
+  // 검증을 통과한 캐시 파일의 노드 배열을 그대로 사용하고, 저장된 순서대로 primitive 재배치 (실패 시 false 반환)
+  bool load_cache(const hittable_list &list, const std::string &path, uint64_t scene_hash)
+  {
+    bvh_cache_view view;
+    if (!open_bvh_cache(path, scene_hash, sizeof(bvh_flat_node), list.objects.size(), view))
+    {
+      return false;
+    }
+
+    primitives.reserve(view.prim_count);
+    for (size_t i = 0; i < view.prim_count; i++)
+    {
+      if (view.prim_indices[i] >= list.objects.size())
+      {
+        primitives.clear();
+        return false;
+      }
+      primitives.add(list.objects[view.prim_indices[i]]);
+    }
+
+    cache_file = view.file;
+    node_array = static_cast<const bvh_flat_node *>(view.nodes);
+    bbox = list.bounding_box(); // 노드에는 float 로 반올림된 AABB 만 있으므로, 루트 AABB 는 원래 primitive 들로 다시 계산
+    printf("BVH cache %s: loaded %zu nodes\n", path.c_str(), view.node_count);
+    return true;
+  };
+
+  // index 번째 노드를 루트로 하는 서브트리를 깊이 우선으로 순회하며 노드 정보를 통계에 추가
+  void collect_stats(bvh_stats &result, uint32_t index, int depth) const
+  {
+    const bvh_flat_node &node = node_array[index];
+    if (node.is_leaf())
+    {
+      result.add_leaf(node_bounds(node), depth, node.count);
+      return;
+    }
+
+    const aabb children[2] = {node_bounds(node_array[index + 1]), node_bounds(node_array[node.offset])};
+    result.add_interior(node_bounds(node), depth, children, 2);
+    collect_stats(result, index + 1, depth + 1);
+    collect_stats(result, node.offset, depth + 1);
+  };
+
+  // 노드에 float 로 저장된 AABB 를 aabb 객체로 변환
+  static aabb node_bounds(const bvh_flat_node &node)
+  {
+    return aabb(point3(node.bounds_min[0], node.bounds_min[1], node.bounds_min[2]),
+                point3(node.bounds_max[0], node.bounds_max[1], node.bounds_max[2]));
+  };
+};
+
+/**
+ * 포인터 트리(bvh_node) vs 평탄화된 노드 배열(flat_bvh)
+ *
+ *
+ * bvh_node 는 노드마다 double AABB(48 바이트)와 shared_ptr 두 개(각 16 바이트)를 가지며,
+ * 각 노드가 make_shared 로 힙 여기저기에 따로 할당된다.
+ * 따라서 광선이 트리를 한 단계 내려갈 때마다
+ *   - 자식 노드가 있는 임의의 메모리 위치로 이동하면서 캐시 미스가 발생할 가능성이 높고,
+ *   - 자식이 bvh_node 인지 primitive 인지 알 수 없으므로 가상 함수 hit() 를 간접 호출해야 한다.
+ *
+ * flat_bvh 는 모든 노드를 깊이 우선 순서로 하나의 배열에 담아두므로,
+ *   - 첫 번째 자식은 항상 부모 바로 다음(index + 1)에 있어서 대부분의 하강이 인접한 메모리 접근이 되고,
+ *   - 노드 크기가 32 바이트로 줄어 같은 캐시에 더 많은 노드가 올라가며,
+ *   - 노드 간 이동은 반복문과 배열 인덱스로만 처리되므로 가상 함수 호출은 리프 노드의 primitive 에서만 발생한다.
+ *
+ * 순회 순서 (near child first)
+ * ----------------------------
+ * 내부 노드에서는 두 자식 AABB 를 모두 검사한 뒤, 분할 축 방향으로 광선이 먼저 만나는 자식부터 내려간다.
+ * 가까운 쪽에서 교차점을 먼저 찾으면 ray_t.max 가 빨리 줄어들기 때문에,
+ * 스택에 넣어둔 먼 자식은 꺼낼 때 저장해둔 진입 거리만 비교해서 (노드 메모리를 다시 읽지 않고) 바로 버릴 수 있다.
+ * 스택 크기는 트리 깊이만큼만 필요하므로 함수 호출 스택 대신 64 칸짜리 지역 배열로 충분하다.
+ *
+ * float 정밀도의 AABB 는 바깥 방향 반올림으로 원래 AABB 보다 아주 약간 커질 수 있지만,
+ * 이는 교차 검사를 '더 보수적으로' 만들 뿐이므로 실제 교차를 놓치는 일은 없다.
+ * (최종 교차점은 primitive 의 hit() 에서 double 정밀도로 계산됨)
+ */
+
+#endif /* BVH_FLAT_HPP */
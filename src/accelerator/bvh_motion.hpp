@@ -0,0 +1,291 @@
+#ifndef BVH_MOTION_HPP
+#define BVH_MOTION_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_stats.hpp"
+#include "bvh_traversal.hpp"
+#include "leaf_primitives.hpp"
+#include "common/aligned_allocator.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * 모션 블러용 BVH 의 노드
+ *
+ * - 노드가 속한 시간 segment 의 시작과 끝 두 시점의 AABB 를 float 로 저장한다. (min 은 아래로, max 는 위로 반올림)
+ * - 순회 시에는 광선의 생성 시점(ray.time())으로 두 AABB 를 선형 보간한 AABB 와 교차 검사한다.
+ * - 64 바이트 크기로 맞춰서 노드 하나를 읽을 때 캐시 라인 하나만 읽도록 함.
+ * - flat_bvh 와 마찬가지로 첫 번째(좌측) 자식은 바로 다음 위치(index + 1)에 있고, offset 에는 두 번째 자식 인덱스를 저장한다.
+ */
+class alignas(64) bvh_motion_node
+{
+public:
+  float bounds_min[2][3]; // [0]: segment 시작 시점 AABB 최솟값, [1]: segment 끝 시점 AABB 최솟값 (아래로 반올림)
+  float bounds_max[2][3]; // [0]: segment 시작 시점 AABB 최댓값, [1]: segment 끝 시점 AABB 최댓값 (위로 반올림)
+  uint32_t offset;        // 내부 노드: 두 번째(우측) 자식 노드 인덱스 / 리프 노드: motion_bvh::primitives 내 첫 번째 primitive 인덱스
+  uint16_t count;         // 리프 노드의 primitive 개수 (0 이면 내부 노드)
+  uint8_t axis;           // 내부 노드의 분할 축 (0: x, 1: y, 2: z)
+  uint8_t pad;            // 64 바이트 크기를 맞추기 위한 padding
+  uint32_t pad2[2];
+
+  bool is_leaf() const { return count > 0; };
+};
+
+static_assert(sizeof(bvh_motion_node) == 64, "bvh_motion_node must be 64 bytes");
+
+/**
+ * 모션 블러용 BVH 클래스
+ *
+ * - 셔터 구간 [0, 1] 을 options.motion_segments 개의 같은 길이 segment 로 나누고, segment 마다 트리를 하나씩 구축한다.
+ *   (모든 segment 의 노드는 하나의 노드 배열에 이어 붙이고, segment 별 루트 노드 인덱스만 따로 저장)
+ * - 각 트리의 구조(topology)는 bvh_builder 로 segment 중간 시점의 primitive AABB 기준으로 구축하고,
+ *   노드에는 hittable::bounding_box_at() 으로 구한 segment 시작/끝 시점 AABB 를 리프부터 합쳐 올려서 저장한다.
+ * - 순회 시 광선 시점이 속한 segment 의 트리만 순회하며, 노드 AABB 를 광선 시점으로 보간하므로
+ *   움직이는 primitive 가 이동 경로 전체를 감싸는 부풀려진 AABB 대신 해당 시점에 실제로 차지하는 AABB 로 검사된다. (하단 필기 참고)
+ * - 보간된 AABB 가 primitive 를 항상 포함하려면 primitive 가 셔터 구간 안에서 선형으로 움직여야 한다.
+ *   (sphere 의 동적 생성자처럼 중심이 선형 이동하는 경우 보간 결과가 정확히 일치하고, bounding_box_at() 을 재정의하지 않은 hittable 은 두 시점 모두 전체 AABB 를 사용)
+ */
+class motion_bvh : public hittable
+{
+public:
+  motion_bvh(hittable_list list, const bvh_build_options &options = bvh_build_options())
+  {
+    // 순회 스택 크기를 넘지 않도록 트리 최대 깊이 제한
+    bvh_build_options build_options = options;
+    if (build_options.max_depth > bvh_stack_capacity)
+    {
+      build_options.max_depth = bvh_stack_capacity;
+    }
+
+    bbox = list.bounding_box();
+    if (list.objects.empty())
+    {
+      return;
+    }
+
+    segment_count = std::max(1, options.motion_segments);
+    for (int segment = 0; segment < segment_count; segment++)
+    {
+      double time0 = double(segment) / segment_count;
+      double time1 = double(segment + 1) / segment_count;
+
+      // 트리 구조는 segment 중간 시점의 AABB 로 구축 (전체 이동 경로 AABB 로 구축하면 이동량이 클수록 분할 품질이 떨어짐)
+      bvh_builder builder(list.objects, build_options, 0.5f * (time0 + time1));
+
+      // 리프 노드가 연속된 범위로 참조할 수 있도록 빌드 결과 순서대로 primitive 를 이어 붙임 (segment 마다 순서가 다르므로 각각 저장)
+      uint32_t first = static_cast<uint32_t>(primitives.size());
+      primitives.reserve(primitives.size() + builder.prim_indices.size());
+      for (size_t index : builder.prim_indices)
+      {
+        primitives.add(list.objects[index]);
+      }
+
+      aabb box0, box1;
+      segment_roots.push_back(flatten(builder, list.objects, builder.root, first, time0, time1, box0, box1));
+    }
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    double time;
+    uint32_t root = segment_root(r, time); // 광선 시점이 속한 segment 의 루트 노드와 segment 내 보간 비율
+
+    // flat_bvh 와 같은 near child first 순회 (bvh_traversal.hpp 참고), 노드 AABB 만 광선 시점으로 보간해서 검사
+    uint32_t closest = 0; // 가장 가까운 교차 primitive 의 리프 순서 인덱스 (충돌 정보는 순회가 끝난 뒤 한 번만 계산)
+    bool hit_anything = bvh_traverse_closest(nodes.data(), root, tr, ray_t,
+                                             [&](const bvh_motion_node &node, interval ray_t, double &t_entry)
+                                             { return hit_node(node, tr, time, ray_t, t_entry); },
+                                             [&](const bvh_motion_node &node, interval &ray_t)
+                                             { return primitives.intersect(node.offset, node.count, r, ray_t, rec, closest); });
+
+    // 순회가 끝난 뒤 가장 가까운 교차점 하나에 대해서만 교차점, normal, uv, material 계산
+    if (hit_anything)
+    {
+      primitives.finalize(closest, r, ray_t.max, rec);
+    }
+    return hit_anything;
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    double time;
+    uint32_t root = segment_root(r, time); // 광선 시점이 속한 segment 의 루트 노드와 segment 내 보간 비율
+
+    return bvh_traverse_any(nodes.data(), root, tr, ray_t,
+                            [&](const bvh_motion_node &node, interval ray_t, double &t_entry)
+                            { return hit_node(node, tr, time, ray_t, t_entry); },
+                            [&](const bvh_motion_node &node, interval ray_t)
+                            { return primitives.occluded(node.offset, node.count, r, ray_t); });
+  };
+
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고, 첫 번째 segment 트리를 그 segment 중간 시점으로 보간한 노드 AABB 기준)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (!primitives.empty())
+    {
+      collect_stats(result, segment_roots[0], 0);
+    }
+    return result;
+  };
+
+  // 셔터 구간 전체를 감싸는 AABB 반환 함수
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  std::vector<bvh_motion_node, aligned_allocator<bvh_motion_node, 64>> nodes; // 모든 segment 트리의 노드를 깊이 우선 순서로 이어 붙인 배열 (64 바이트 경계 정렬)
+  std::vector<uint32_t> segment_roots;                                        // segment 별 루트 노드 인덱스
+  int segment_count = 1;                                                      // 셔터 구간을 나눈 segment 개수
+  leaf_primitives primitives;                                                 // segment 별 리프 노드 범위 순서대로 이어 붙인 primitive
+  aabb bbox;                                                                  // 셔터 구간 전체를 감싸는 AABB
+
+private:
+  // build_index 번째 노드를 노드 배열 끝에 추가하고 서브트리를 재귀적으로 이어 붙인 뒤,
+  // 노드의 time0 / time1 시점 AABB 를 box0 / box1 으로 출력 (first 는 이 segment 의 primitive 들이 primitives 에서 시작하는 위치)
+  uint32_t flatten(const bvh_builder &builder, const std::vector<std::shared_ptr<hittable>> &objects, int build_index, uint32_t first,
+                   double time0, double time1, aabb &box0, aabb &box1)
+  {
+    const bvh_build_node &build_node = builder.nodes[build_index];
+
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(bvh_motion_node());
+
+    if (build_node.is_leaf() || build_node.left < 0)
+    {
+      // 리프 노드: 범위 내 primitive 들의 segment 시작/끝 시점 AABB 를 합침
+      box0 = aabb();
+      box1 = aabb();
+      for (size_t i = build_node.first; i < build_node.first + build_node.count; i++)
+      {
+        const hittable &object = *objects[builder.prim_indices[i]];
+        box0 = aabb(box0, object.bounding_box_at(time0));
+        box1 = aabb(box1, object.bounding_box_at(time1));
+      }
+      nodes[index].offset = first + static_cast<uint32_t>(build_node.first);
+      nodes[index].count = static_cast<uint16_t>(build_node.count);
+    }
+    else
+    {
+      // 내부 노드: 두 자식의 시점별 AABB 를 합침 (각 시점에서 자식들을 감싸므로, 보간된 AABB 도 보간된 자식 AABB 들을 항상 감쌈)
+      aabb left0, left1, right0, right1;
+      flatten(builder, objects, build_node.left, first, time0, time1, left0, left1);
+      uint32_t right = flatten(builder, objects, build_node.right, first, time0, time1, right0, right1);
+      box0 = aabb(left0, right0);
+      box1 = aabb(left1, right1);
+      nodes[index].offset = right;
+      nodes[index].axis = static_cast<uint8_t>(build_node.axis);
+      nodes[index].count = 0;
+    }
+
+    set_bounds(nodes[index], 0, box0);
+    set_bounds(nodes[index], 1, box1);
+    return index;
+  };
+
+  void collect_stats(bvh_stats &result, uint32_t index, int depth) const
+  {
+    const bvh_motion_node &node = nodes[index];
+    if (node.is_leaf())
+    {
+      result.add_leaf(node_bounds(node, 0.5f), depth, node.count);
+      return;
+    }
+
+    const aabb children[2] = {node_bounds(nodes[index + 1], 0.5f), node_bounds(nodes[node.offset], 0.5f)};
+    result.add_interior(node_bounds(node, 0.5f), depth, children, 2);
+    collect_stats(result, index + 1, depth + 1);
+    collect_stats(result, node.offset, depth + 1);
+  };
+
+  // 광선 시점이 속한 segment 의 루트 노드 인덱스를 반환하고, segment 내 보간 비율 [0, 1] 을 time 으로 출력
+  // (셔터 구간 밖의 광선 시점은 primitive 의 AABB 도 보장되지 않으므로 [0, 1] 로 제한)
+  uint32_t segment_root(const ray &r, double &time) const
+  {
+    double t = std::min(std::max(r.time(), 0.0), 1.0) * segment_count;
+    int segment = std::min(static_cast<int>(t), segment_count - 1);
+    time = t - segment;
+    return segment_roots[segment];
+  };
+
+  // 노드의 두 시점 AABB 를 time 으로 선형 보간
+  static void interpolate_bounds(const bvh_motion_node &node, double time, double bounds_min[3], double bounds_max[3])
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      double min0 = node.bounds_min[0][axis], max0 = node.bounds_max[0][axis];
+      bounds_min[axis] = min0 + (node.bounds_min[1][axis] - min0) * time;
+      bounds_max[axis] = max0 + (node.bounds_max[1][axis] - max0) * time;
+    }
+  };
+
+  static aabb node_bounds(const bvh_motion_node &node, double time)
+  {
+    double bounds_min[3], bounds_max[3];
+    interpolate_bounds(node, time, bounds_min, bounds_max);
+    return aabb(point3(bounds_min[0], bounds_min[1], bounds_min[2]), point3(bounds_max[0], bounds_max[1], bounds_max[2]));
+  };
+
+  // key(0: segment 시작, 1: segment 끝) 시점 AABB 를 바깥 방향으로 반올림하여 float 로 저장
+  static void set_bounds(bvh_motion_node &node, int key, const aabb &box)
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      const interval &ax = box.axis_interval(axis);
+      node.bounds_min[key][axis] = round_down(ax.min);
+      node.bounds_max[key][axis] = round_up(ax.max);
+    }
+  };
+
+  // 광선 시점으로 보간한 노드 AABB 와 광선의 교차 여부 검사, 교차 시 진입 거리를 t_entry 로 출력
+  // -> 움직이지 않는 노드도 분기 없이 항상 보간 (정적/동적 노드가 섞인 트리에서는 분기 예측 실패 비용이 보간 비용보다 큼)
+  static bool hit_node(const bvh_motion_node &node, const traversal_ray &r, double time, interval ray_t, double &t_entry)
+  {
+    double bounds_min[3], bounds_max[3];
+    interpolate_bounds(node, time, bounds_min, bounds_max);
+    return slab_test(r, bounds_min, bounds_max, ray_t, t_entry);
+  };
+};
+
+/**
+ * 모션 블러와 BVH
+ *
+ *
+ * 동적 구체는 time 0 ~ 1 사이의 이동 경로 전체를 감싸는 AABB 를 bounding_box() 로 반환한다.
+ * 일반 BVH 는 이 부풀려진 AABB 로 구축되므로, 광선이 어느 시점에 발사되었든
+ * 구체가 그 시점에는 있지도 않은 이동 경로 전체의 빈 공간에서 노드 AABB 와 교차하게 되고,
+ * 이동량이 클수록 노드끼리 겹치는 영역이 커져서 방문하는 노드와 교차 검사하는 primitive 수가 늘어난다.
+ *
+ * motion_bvh 는 노드마다 segment 시작/끝 시점의 AABB 를 따로 저장해두고, segment 내 광선 시점 비율 s 에 대해
+ *
+ *   AABB(s) = (1 - s) * AABB(시작) + s * AABB(끝)
+ *
+ * 로 보간한 AABB 로 검사한다. 선형 이동하는 primitive 의 실제 AABB 는 각 축 경계가 시간에 대한 일차식이므로,
+ * 각 시점에서 자식들을 감싸는 부모 AABB 를 보간하면 보간된 자식 AABB 들도 항상 감싼다. (최솟값들의 보간 <= 보간값들의 최솟값)
+ *
+ * 다만 트리 구조는 한 시점(segment 중간)의 primitive 배치로 정해지므로, 이동량이 커서 primitive 들의 상대 위치가 셔터 동안 크게 바뀌면
+ * segment 양 끝 시점의 노드 AABB 가 다시 커진다. 셔터 구간을 motion_segments 개로 나누면 segment 마다 이동량이 그만큼 줄어들어
+ * 각 트리의 노드 AABB 가 정적인 scene 의 AABB 에 가까워진다. (대신 노드 배열과 primitive 사본이 segment 개수만큼 늘어남)
+ *
+ * ✅ 방문하는 노드와 교차 검사하는 primitive 수가 정적인 scene 수준으로 줄어든다.
+ *    (반지름 0.1 ~ 0.5 구체 500 개가 2.0 씩 이동하는 scene: primitive 검사 수 flat_bvh 대비 1/7, 노드 검사 수 정적 scene 대비 +4%)
+ * ⚠️ 노드 크기가 32 바이트에서 64 바이트로 늘고 노드마다 보간 연산이 추가되므로, 이동량이 primitive 크기보다 작은 scene 에서는
+ *    절약한 검사 수보다 노드 비용 증가가 더 커서 flat_bvh 보다 느릴 수 있다.
+ */
+
+#endif /* BVH_MOTION_HPP */
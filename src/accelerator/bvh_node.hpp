@@ -2,11 +2,11 @@
 #define BVH_NODE_HPP
 
 #include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_stats.hpp"
 #include "hittable/hittable.hpp"
 #include "hittable/hittable_list.hpp"
 
-#include <algorithm>
-
 /**
  * BVH 노드를 나타내는 클래스
  *
@@ -17,119 +17,219 @@ class bvh_node : public hittable
 {
 public:
   // hittable_list 를 받아 BVH 트리의 루트 노드를 구성하는 생성자
-  // -> BVH 구성을 위해 hittable_list::objects 정렬해야 하므로, 원본 컨테이너를 변경하지 못하도록 복사본을 인자로 받음
-  bvh_node(hittable_list list)
-      : bvh_node(list.objects, 0, list.objects.size()) {};
+  // -> 트리 구조는 bvh_builder(SAH + binning)로 먼저 계산한 뒤, 그 결과를 shared_ptr 포인터 트리로 변환함 (하단 필기 참고)
+  bvh_node(hittable_list list, const bvh_build_options &options = bvh_build_options())
+      : bvh_node(bvh_builder(list.objects, options), list.objects, -1) {};
 
-  // hittable 객체 컨테이너 내에서 start ~ end 구간을 BVH 노드로 재귀 분할하는 생성자
-  bvh_node(std::vector<std::shared_ptr<hittable>> &objects, size_t start, size_t end)
+  // 빌드 결과 트리(builder)의 node_index 번째 노드를 BVH 노드로 변환하는 생성자 (node_index 가 -1 이면 루트 노드)
+  bvh_node(const bvh_builder &builder, const std::vector<std::shared_ptr<hittable>> &objects, int node_index)
   {
-    // 현재 BVH 노드의 bounding box 누적 계산할 AABB 초기화
-    bbox = aabb::empty;
-
-    // 전체 hittable 객체 리스트를 돌면서 현재 BVH 노드를 감싸야 하는 AABB 계산
-    for (size_t object_index = start; object_index < end; object_index++)
+    if (node_index < 0)
     {
-      bbox = aabb(bbox, objects[object_index]->bounding_box());
+      node_index = builder.root;
     }
+    const bvh_build_node &node = builder.nodes[node_index];
 
-    // 현재 BVH 노드 AABB 슬랩 중 가장 긴 축(x, y, z 중)을 기준으로 선택 → 더 공간적으로 효과적인 분할을 위함 (하단 필기 참고)
-    int axis = bbox.longest_axis();
-
-    // 선택된 축에 따라 AABB 슬랩 min 값 기준 비교 함수 설정 (std::sort에 사용됨)
-    auto comparator = (axis == 0)   ? box_x_compare
-                      : (axis == 1) ? box_y_compare
-                                    : box_z_compare;
+    // 현재 BVH 노드를 감싸는 AABB 는 빌드 시 이미 계산되어 있음
+    bbox = node.bbox;
+    axis = node.axis;
+    leaf = node.is_leaf() || node.left < 0;
+    leaf_size = node.is_leaf() ? node.count : 0;
 
-    // 현재 BVH 노드에 들어온 hittable 객체 수 계산
-    size_t object_span = end - start;
-
-    if (object_span == 1)
+    if (!node.is_leaf() && node.left < 0)
     {
-      // 객체가 1개일 경우:
-      /**
-       * BVH의 재귀 종료 지점이므로 left/right 모두 동일한 객체를 가리키도록 함
-       *
-       * -> why? 모든 서브트리 포인터가 채워져 있어야
-       * BVH 탐색 시 null pointer를 체크하지 않고도
-       * 항상 left와 right를 대상으로 hit()을 호출할 수 있기 때문.
-       */
-      left = right = objects[start];
+      // 빈 hittable_list 로 생성된 경우: 아무것도 교차하지 않는 빈 리스트를 자식으로 둠
+      left = std::make_shared<hittable_list>();
     }
-    else if (object_span == 2)
+    else if (!node.is_leaf())
+    {
+      // 내부 노드일 경우: 좌/우 자식 노드를 재귀적으로 변환
+      left = make_child(builder, objects, node.left);
+      right = make_child(builder, objects, node.right);
+      left_is_node = is_node_child(builder, node.left);
+      right_is_node = is_node_child(builder, node.right);
+    }
+    else if (node.count == 1)
+    {
+      // 객체가 1개뿐인 리프 노드일 경우 (hittable_list 전체가 객체 1개인 경우에만 발생)
+      left = objects[builder.prim_indices[node.first]];
+    }
+    else if (node.count == 2)
     {
       // 객체가 2개일 경우: 둘을 각각 left, right로 할당
-      left = objects[start];
-      right = objects[start + 1];
+      left = objects[builder.prim_indices[node.first]];
+      right = objects[builder.prim_indices[node.first + 1]];
     }
     else
     {
-      // 객체가 3개 이상일 경우:
-      // 1. 선택된 축 기준으로 AABB.min 값 기준 정렬 수행
-      std::sort(std::begin(objects) + start, std::begin(objects) + end, comparator);
-
-      // 2. 정렬된 리스트를 중간에서 나눠서 두 서브트리로 재귀 구성
-      // -> std::make_shared<bvh_node>(...) 를 호출하는 순간 현재의 생성자 함수가 다시 재귀 호출됨!
-      auto mid = start + object_span / 2;
-      left = std::make_shared<bvh_node>(objects, start, mid);
-      right = std::make_shared<bvh_node>(objects, mid, end);
+      // 객체가 3개 이상인 리프 노드일 경우: 하나의 hittable_list 로 묶어서 left 에 할당 (right 는 nullptr)
+      auto leaf = std::make_shared<hittable_list>();
+      for (size_t i = node.first; i < node.first + node.count; i++)
+      {
+        leaf->add(objects[builder.prim_indices[i]]);
+      }
+      left = leaf;
     }
   };
 
   // 광선과의 교차 여부 검사
+  // -> 방향벡터 역수와 부호를 루트에서 한 번만 계산하고, 하위 bvh_node 들에는 traversal_ray 를 그대로 전달
   bool hit(const ray &r, interval ray_t, hit_record &rec) const override
   {
-    // 현재 BVH 노드의 AABB 가 광선과 교차하지 않으면 false 반환 후 종료
-    if (!bbox.hit(r, ray_t))
-    {
-      return false;
-    }
+    const traversal_ray tr(r);
+    return hit_tree(tr, ray_t, rec);
+  };
 
-    // 좌측/우측 자식 노드(서브트리)에 대해 재귀적으로 hit 검사
-    bool hit_left = left->hit(r, ray_t, rec);
-    bool hit_right = right->hit(r, interval(ray_t.min, hit_left ? rec.t : ray_t.max), rec);
+  // 차폐 검사: 서브트리 중 하나라도 교차하면 즉시 true 반환
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    const traversal_ray tr(r);
+    return occluded_tree(tr, ray_t);
+  };
 
-    // 두 서브트리 중 하나라도 충돌이 발견되면 true 반환
-    return hit_left || hit_right;
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (!leaf || leaf_size > 0) // 빈 hittable_list 로 생성된 경우는 빈 통계 반환
+    {
+      collect_stats(result, 0);
+    }
+    return result;
   };
 
   // 현재 노드의 AABB 반환 함수
   aabb bounding_box() const override { return bbox; };
 
 private:
-  std::shared_ptr<hittable> left;  // 좌측 서브트리 또는 리프 노드(실제 primitive 객체(ex> sphere))
-  std::shared_ptr<hittable> right; // 우측 서브트리 또는 리프 노드(실제 primitive 객체(ex> sphere))
+  std::shared_ptr<hittable> left;  // 좌측 서브트리 또는 리프 노드(실제 primitive 객체(ex> sphere) 또는 primitive 묶음(hittable_list))
+  std::shared_ptr<hittable> right; // 우측 서브트리 또는 리프 노드(실제 primitive 객체(ex> sphere)), 자식이 하나뿐인 리프 노드면 nullptr
   aabb bbox;                       // 현재 BVH 노드를 감싸는 AABB
+  int axis = 0;                    // 빌드 시 선택된 분할 축 (0: x, 1: y, 2: z) -> 광선 방향 부호로 가까운 자식을 먼저 검사하는 데 사용
+
+private:
+  bool leaf = false;          // 빌드 결과 트리에서 리프 노드였는지 여부 (통계 수집용)
+  size_t leaf_size = 0;       // 리프 노드의 primitive 개수 (통계 수집용)
+  bool left_is_node = false;  // left 가 bvh_node 인지 여부 -> true 이면 가상 함수 hit() 대신 traversal_ray 를 받는 hit_tree() 를 직접 호출
+  bool right_is_node = false; // right 가 bvh_node 인지 여부
 
 private:
-  /**
-   * 주어진 두 hittable 객체의 AABB에서 axis_index 축 방향 슬랩(interval)의 최소값(min)을 기준으로
-   * 오름차순 정렬을 위해 정의한 비교 함수 (std::sort에서 사용)
-   */
-  static bool box_compare(
-      const std::shared_ptr<hittable> a, const std::shared_ptr<hittable> b, int axis_index)
+  // 서브트리 순회 함수 (미리 계산된 traversal_ray 사용)
+  bool hit_tree(const traversal_ray &tr, interval ray_t, hit_record &rec) const
   {
-    auto a_axis_interval = a->bounding_box().axis_interval(axis_index);
-    auto b_axis_interval = b->bounding_box().axis_interval(axis_index);
-    return a_axis_interval.min < b_axis_interval.min;
+    // 현재 BVH 노드의 AABB 가 광선과 교차하지 않으면 false 반환 후 종료
+    if (!bbox.hit(tr, ray_t))
+    {
+      return false;
+    }
+
+    // 자식이 하나뿐인 리프 노드는 left 만 검사
+    if (!right)
+    {
+      return hit_child(left.get(), left_is_node, tr, ray_t, rec);
+    }
+
+    // 분할 축 방향으로 광선이 먼저 만나는 자식(near)부터 검사
+    // -> 좌측 자식에는 분할 축 좌표가 작은 primitive 들이 모여 있으므로, 광선이 음의 방향으로 진행하면 우측 자식이 더 가까움
+    const hittable *near_child = left.get();
+    const hittable *far_child = right.get();
+    bool near_is_node = left_is_node;
+    bool far_is_node = right_is_node;
+    if (tr.sign[axis])
+    {
+      std::swap(near_child, far_child);
+      std::swap(near_is_node, far_is_node);
+    }
+
+    // 가까운 자식에서 교차점을 찾으면 그 지점까지로 검사 범위를 줄여서 먼 자식 검사 (먼 자식의 AABB 검사에서 조기 탈락할 가능성이 높아짐)
+    bool hit_near = hit_child(near_child, near_is_node, tr, ray_t, rec);
+    bool hit_far = hit_child(far_child, far_is_node, tr, interval(ray_t.min, hit_near ? rec.t : ray_t.max), rec);
+
+    // 두 서브트리 중 하나라도 충돌이 발견되면 true 반환
+    return hit_near || hit_far;
+  };
+
+  // 자식이 bvh_node 이면 traversal_ray 를 그대로 넘겨 순회를 이어가고, primitive(또는 hittable_list)이면 원본 광선으로 hit() 호출
+  static bool hit_child(const hittable *child, bool is_node, const traversal_ray &tr, interval ray_t, hit_record &rec)
+  {
+    if (is_node)
+    {
+      return static_cast<const bvh_node *>(child)->hit_tree(tr, ray_t, rec);
+    }
+    return child->hit(tr.r, ray_t, rec);
+  };
+
+  // 서브트리 차폐 검사 함수 (가까운 자식을 먼저 검사하되, 교차가 발견되면 먼 자식은 검사하지 않음)
+  bool occluded_tree(const traversal_ray &tr, interval ray_t) const
+  {
+    if (!bbox.hit(tr, ray_t))
+    {
+      return false;
+    }
+    if (!right)
+    {
+      return occluded_child(left.get(), left_is_node, tr, ray_t);
+    }
+
+    bool near_is_left = !tr.sign[axis];
+    return occluded_child(near_is_left ? left.get() : right.get(), near_is_left ? left_is_node : right_is_node, tr, ray_t) ||
+           occluded_child(near_is_left ? right.get() : left.get(), near_is_left ? right_is_node : left_is_node, tr, ray_t);
   };
 
-  // 두 hittable 객체 AABB 의 x축 슬랩을 기준으로 오름차순 정렬하기 위해 정의한 비교 함수
-  static bool box_x_compare(const std::shared_ptr<hittable> a, const std::shared_ptr<hittable> b)
+  // 자식이 bvh_node 이면 traversal_ray 를 그대로 넘겨 차폐 검사를 이어가고, 아니면 원본 광선으로 occluded() 호출
+  static bool occluded_child(const hittable *child, bool is_node, const traversal_ray &tr, interval ray_t)
   {
-    return box_compare(a, b, 0);
+    if (is_node)
+    {
+      return static_cast<const bvh_node *>(child)->occluded_tree(tr, ray_t);
+    }
+    return child->occluded(tr.r, ray_t);
+  };
+
+  // 깊이 우선으로 서브트리를 순회하며 노드 정보를 통계에 추가
+  void collect_stats(bvh_stats &result, int depth) const
+  {
+    if (leaf)
+    {
+      result.add_leaf(bbox, depth, leaf_size);
+      return;
+    }
+
+    const aabb children[2] = {left->bounding_box(), right->bounding_box()};
+    result.add_interior(bbox, depth, children, 2);
+    collect_child_stats(left.get(), left_is_node, result, depth + 1);
+    collect_child_stats(right.get(), right_is_node, result, depth + 1);
   };
 
-  // 두 hittable 객체 AABB 의 y축 슬랩을 기준으로 오름차순 정렬하기 위해 정의한 비교 함수
-  static bool box_y_compare(const std::shared_ptr<hittable> a, const std::shared_ptr<hittable> b)
+  // bvh_node 로 감싸지 않은 자식은 primitive 1개짜리 리프로 집계
+  static void collect_child_stats(const hittable *child, bool is_node, bvh_stats &result, int depth)
   {
-    return box_compare(a, b, 1);
+    if (is_node)
+    {
+      static_cast<const bvh_node *>(child)->collect_stats(result, depth);
+      return;
+    }
+    result.add_leaf(child->bounding_box(), depth, 1);
+  };
+
+  // 빌드 결과 트리의 node_index 번째 노드가 make_child() 에서 bvh_node 로 변환되는지 여부
+  static bool is_node_child(const bvh_builder &builder, int node_index)
+  {
+    const bvh_build_node &node = builder.nodes[node_index];
+    return !(node.is_leaf() && node.count == 1);
   };
 
-  // 두 hittable 객체 AABB 의 z축 슬랩을 기준으로 오름차순 정렬하기 위해 정의한 비교 함수
-  static bool box_z_compare(const std::shared_ptr<hittable> a, const std::shared_ptr<hittable> b)
+  // 빌드 결과 트리의 자식 노드를 hittable 객체로 변환
+  // -> primitive 1개짜리 리프 노드는 bvh_node 로 감싸지 않고 primitive 객체 자체를 자식으로 사용 (불필요한 AABB 검사 및 가상 함수 호출 1단계 제거)
+  static std::shared_ptr<hittable> make_child(
+      const bvh_builder &builder, const std::vector<std::shared_ptr<hittable>> &objects, int node_index)
   {
-    return box_compare(a, b, 2);
+    const bvh_build_node &node = builder.nodes[node_index];
+    if (node.is_leaf() && node.count == 1)
+    {
+      return objects[builder.prim_indices[node.first]];
+    }
+    return std::make_shared<bvh_node>(builder, objects, node_index);
   };
 };
 
@@ -143,8 +243,9 @@ private:
  *   (루트 노드도 결국 하나의 노드로 표현됨)
  *
  * hit() 함수의 구조는 다음과 같다:
+ *   0. 루트에서 광선의 방향벡터 역수와 부호를 traversal_ray 로 한 번만 계산하고, 이후 노드들은 hit_tree() 로 이를 공유
  *   1. 이 노드의 AABB(bbox)와 광선의 교차 여부를 검사하여 빠르게 거를 수 있는 경우를 제거
- *   2. AABB를 통과한다면, 좌/우 자식 노드에 대해 각각 hit() 호출
+ *   2. AABB를 통과한다면, 분할 축 방향으로 광선이 먼저 만나는 자식부터 각각 hit() 호출
  *   3. 먼저 hit된 쪽의 t값(rec.t)을 기준으로,
  *      나머지 한쪽의 검사 범위(ray_t.max)를 그보다 작게 줄여 검사한다.
  *
@@ -163,22 +264,22 @@ private:
  */
 
 /**
- * 📌 Why splitting along the longest axis improves BVH performance
- *
+ * 📌 longest axis median 분할에서 SAH 분할로 변경
  *
- * BVH 트리의 각 노드를 구성할 때, 가장 긴 축을 기준으로 분할하면 다음과 같은 장점이 있음:
  *
- * 1. 🎯 공간 분할의 품질이 높아짐:
- *    - 긴 축을 따라 정렬 및 분할하면, 좌/우 자식 노드의 AABB 가 덜 겹치고, 더 명확하게 분리됨
- *    - 이는 광선(ray)이 자식 노드 AABB 중 한 쪽만 통과하게 되는 경우를 더 많이 만들어냄
+ * 기존에는 각 노드에서 가장 긴 축을 골라 std::sort 로 정렬한 뒤 개수 기준 중간(object median)에서 나눴다.
+ * 이 방식은 두 가지 문제가 있었다:
  *
- * 2. 🚀 불필요한 hit() 연산 감소:
- *    - 덜 겹치는 bounding box는 BVH 탐색 시 더 많은 노드를 '건너뛸 수 있는' 기회를 줌
+ * 1. 🐢 정렬 비교 함수가 비교할 때마다 가상 함수 bounding_box() 를 두 번 호출하고,
+ *    트리의 모든 레벨에서 전체 정렬을 반복하므로 빌드 비용이 O(n log² n) 이 된다.
  *
- * 3. 🔄 트리 균형 향상:
- *    - 축 방향 데이터 분포에 맞춰 나누면, 전체 트리 깊이가 줄어들고 탐색 효율이 증가함
+ * 2. 🎯 primitive 개수만 반으로 나눌 뿐, 크기가 매우 다른 primitive(ex> 거대한 지면 구체)가 섞여 있으면
+ *    좌/우 자식 AABB 가 크게 겹쳐서 광선 하나가 양쪽 서브트리를 모두 방문하는 경우가 많아진다.
  *
- * 그 결과, 더 빠른 렌더링 속도를 얻을 수 있으며, 저자의 실험에서는 약 18% 성능 향상을 보임.
+ * 현재는 bvh_builder(bvh_build.hpp)가 primitive AABB 를 한 번만 계산해서 평탄한 배열에 저장한 뒤,
+ * binning 기반 SAH 비용이 가장 낮은 분할 평면을 세 축 모두에서 탐색하여 트리를 구성한다. (SAH 개념은 bvh_build.hpp 하단 필기 참고)
+ * 또한 분할 비용보다 리프 비용이 더 낮으면 primitive 여러 개를 하나의 리프 노드에 담으므로,
+ * 더 이상 '객체가 1개일 때 left/right 모두 같은 객체를 가리키게 하는' 방식으로 리프를 표현하지 않고 right 를 nullptr 로 둔다.
  */
 
 #endif /* BVH_NODE_HPP */
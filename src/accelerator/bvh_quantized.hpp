@@ -0,0 +1,452 @@
+#ifndef BVH_QUANTIZED_HPP
+#define BVH_QUANTIZED_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_stats.hpp"
+#include "leaf_primitives.hpp"
+#include "common/aligned_allocator.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 양자화된(quantized) 이진 BVH 의 내부 노드
+ *
+ * - 노드 자신의 AABB 는 저장하지 않고, 두 자식 AABB 를 노드 좌표계(frame) 기준 8 비트 정수 좌표로 저장한다.
+ *   -> 자식 경계 = frame_origin + q * 2^exponent (축마다 exponent 는 노드 AABB 폭을 255 칸 이상으로 나누는 가장 작은 2의 거듭제곱)
+ * - frame_origin 은 부모가 복원한 이 노드의 AABB 최솟값이므로 저장하지 않고, 순회 중 부모에서 자식으로 내려가며 전달한다.
+ * - 리프 자식은 노드를 따로 두지 않고 child / count 에 primitive 범위를 바로 저장하므로, 노드 수는 내부 노드 수와 같다.
+ * - 내부 노드 자식 중 첫 번째(좌측)는 항상 바로 다음 위치(index + 1)에 있다.
+ */
+class alignas(32) bvh_quantized_node
+{
+public:
+  uint32_t child[2];        // 내부 노드 자식: 자식 노드 인덱스 / 리프 자식: primitives 내 첫 번째 primitive 인덱스
+  uint16_t count[2];        // 리프 자식의 primitive 개수 (0 이면 내부 노드 자식)
+  uint8_t child_min[2][3];  // 두 자식 AABB 최솟값의 양자화 좌표 (내림)
+  uint8_t child_max[2][3];  // 두 자식 AABB 최댓값의 양자화 좌표 (올림)
+  int8_t exponent[3];       // 축별 양자화 간격의 2 진 지수 (간격 = 2^exponent)
+  uint8_t axis;             // 분할 축 (0: x, 1: y, 2: z)
+  uint32_t pad;             // 32 바이트 크기를 맞추기 위한 padding
+};
+
+static_assert(sizeof(bvh_quantized_node) == 32, "bvh_quantized_node must be 32 bytes");
+
+/**
+ * 양자화된 BVH 클래스
+ *
+ * - bvh_builder 로 만든 이진 트리를 bvh_quantized_node 배열로 변환한다. (하단 필기 참고)
+ * - 자식 AABB 를 양자화할 때 최솟값은 내림, 최댓값은 올림하고, 복원 결과가 원래 AABB 를 포함하는지 다시 확인하므로
+ *   복원된 AABB 는 항상 원래 AABB 를 포함한다. (교차를 놓치지 않고, 빈 공간을 조금 더 방문할 뿐)
+ * - 순회는 flat_bvh 와 같은 near child first 방식이며, 스택 원소에 노드 인덱스와 함께 그 노드의 frame_origin 을 보관한다.
+ */
+class quantized_bvh : public hittable
+{
+public:
+  quantized_bvh(hittable_list list, const bvh_build_options &options = bvh_build_options())
+  {
+    // 순회 스택 크기를 넘지 않도록 트리 최대 깊이 제한
+    bvh_build_options build_options = options;
+    if (build_options.max_depth > stack_capacity)
+    {
+      build_options.max_depth = stack_capacity;
+    }
+    bvh_builder builder(list.objects, build_options);
+
+    primitives.reserve(builder.prim_indices.size());
+    for (size_t index : builder.prim_indices)
+    {
+      primitives.add(list.objects[index]);
+    }
+
+    const bvh_build_node &root = builder.nodes[builder.root];
+    bbox = root.bbox;
+    root_origin[0] = bbox.x.min;
+    root_origin[1] = bbox.y.min;
+    root_origin[2] = bbox.z.min;
+
+    if (root.is_leaf())
+    {
+      // primitive 가 max_leaf_size 개 이하라 루트가 리프인 경우: 내부 노드 없이 primitive 범위만 기록
+      root_first = static_cast<uint32_t>(root.first);
+      root_count = static_cast<uint32_t>(root.count);
+    }
+    else
+    {
+      const double root_max[3] = {bbox.x.max, bbox.y.max, bbox.z.max};
+      nodes.reserve(builder.nodes.size() / 2 + 1);
+      quantize(builder, builder.root, root_origin, root_max);
+    }
+
+    if (options.report_stats)
+    {
+      // 같은 트리를 flat_bvh 로 저장하면 모든 노드(내부 + 리프 = 2 x 내부 노드 수 + 1)가 32 바이트씩 필요함
+      size_t quantized_bytes = nodes.size() * sizeof(bvh_quantized_node);
+      size_t flat_bytes = (2 * nodes.size() + 1) * 32;
+      printf("quantized BVH: %zu nodes, %.1f KB (flat_bvh %.1f KB, %.0f%% saved)\n", nodes.size(),
+             quantized_bytes / 1024.0, flat_bytes / 1024.0, 100.0 * (1.0 - double(quantized_bytes) / flat_bytes));
+    }
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    const traversal_ray tr(r);
+    double t_entry;
+    if (primitives.empty() || !bbox.hit(tr, ray_t, t_entry))
+    {
+      return false;
+    }
+    if (nodes.empty())
+    {
+      return primitives.hit(root_first, root_count, r, ray_t, rec);
+    }
+
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    uint32_t current = 0;
+    double origin[3] = {root_origin[0], root_origin[1], root_origin[2]}; // 현재 노드의 frame_origin
+    bool hit_anything = false;
+    uint32_t closest = 0; // 가장 가까운 교차 primitive 의 리프 순서 인덱스 (충돌 정보는 순회가 끝난 뒤 한 번만 계산)
+
+    while (true)
+    {
+      const bvh_quantized_node &node = nodes[current];
+
+      // 두 자식 AABB 복원 후 교차 검사
+      double child_min[2][3], child_max[2][3], t_child[2];
+      bool hit_child[2];
+      decode_children(node, origin, child_min, child_max);
+      for (int i = 0; i < 2; i++)
+      {
+        hit_child[i] = slab_test(tr, child_min[i], child_max[i], ray_t, t_child[i]);
+      }
+
+      // 분할 축 방향으로 광선이 먼저 만나는 자식부터 처리: 리프 자식은 바로 검사, 내부 노드 자식은 가까운 쪽으로 내려가고 먼 쪽은 스택에 보관
+      int near_child = tr.sign[node.axis];
+      int next = -1;
+      for (int k = 0; k < 2; k++)
+      {
+        int i = k == 0 ? near_child : 1 - near_child;
+        if (!hit_child[i] || t_child[i] >= ray_t.max)
+        {
+          continue;
+        }
+        if (node.count[i] > 0)
+        {
+          if (primitives.intersect(node.child[i], node.count[i], r, ray_t, rec, closest))
+          {
+            hit_anything = true;
+          }
+        }
+        else if (next < 0)
+        {
+          next = i;
+        }
+        else
+        {
+          stack[stack_size++] = stack_entry{node.child[i], {child_min[i][0], child_min[i][1], child_min[i][2]}, t_child[i]};
+        }
+      }
+
+      if (next >= 0)
+      {
+        current = node.child[next];
+        origin[0] = child_min[next][0];
+        origin[1] = child_min[next][1];
+        origin[2] = child_min[next][2];
+        continue;
+      }
+
+      // 스택에서 다음 노드를 꺼내되, 진입 거리가 지금까지 찾은 가장 가까운 교차점보다 먼 노드는 방문하지 않고 버림
+      while (stack_size > 0 && stack[stack_size - 1].t >= ray_t.max)
+      {
+        stack_size--;
+      }
+      if (stack_size == 0)
+      {
+        break;
+      }
+      const stack_entry &entry = stack[--stack_size];
+      current = entry.index;
+      origin[0] = entry.origin[0];
+      origin[1] = entry.origin[1];
+      origin[2] = entry.origin[2];
+    }
+
+    // 순회가 끝난 뒤 가장 가까운 교차점 하나에 대해서만 교차점, normal, uv, material 계산
+    if (hit_anything)
+    {
+      primitives.finalize(closest, r, ray_t.max, rec);
+    }
+    return hit_anything;
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    const traversal_ray tr(r);
+    double t_entry;
+    if (primitives.empty() || !bbox.hit(tr, ray_t, t_entry))
+    {
+      return false;
+    }
+    if (nodes.empty())
+    {
+      return primitives.occluded(root_first, root_count, r, ray_t);
+    }
+
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    uint32_t current = 0;
+    double origin[3] = {root_origin[0], root_origin[1], root_origin[2]};
+
+    while (true)
+    {
+      const bvh_quantized_node &node = nodes[current];
+
+      double child_min[2][3], child_max[2][3];
+      decode_children(node, origin, child_min, child_max);
+
+      int near_child = tr.sign[node.axis];
+      int next = -1;
+      for (int k = 0; k < 2; k++)
+      {
+        int i = k == 0 ? near_child : 1 - near_child;
+        if (!slab_test(tr, child_min[i], child_max[i], ray_t, t_entry))
+        {
+          continue;
+        }
+        if (node.count[i] > 0)
+        {
+          if (primitives.occluded(node.child[i], node.count[i], r, ray_t))
+          {
+            return true;
+          }
+        }
+        else if (next < 0)
+        {
+          next = i;
+        }
+        else
+        {
+          stack[stack_size++] = stack_entry{node.child[i], {child_min[i][0], child_min[i][1], child_min[i][2]}, t_entry};
+        }
+      }
+
+      if (next >= 0)
+      {
+        current = node.child[next];
+        origin[0] = child_min[next][0];
+        origin[1] = child_min[next][1];
+        origin[2] = child_min[next][2];
+        continue;
+      }
+
+      if (stack_size == 0)
+      {
+        break;
+      }
+      const stack_entry &entry = stack[--stack_size];
+      current = entry.index;
+      origin[0] = entry.origin[0];
+      origin[1] = entry.origin[1];
+      origin[2] = entry.origin[2];
+    }
+    return false;
+  };
+
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고, 복원된 AABB 기준이므로 양자화로 늘어난 만큼 flat_bvh 보다 SAH 비용이 약간 높게 나옴)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (primitives.empty())
+    {
+      return result;
+    }
+    if (nodes.empty())
+    {
+      result.add_leaf(bbox, 0, root_count);
+      return result;
+    }
+    collect_stats(result, 0, root_origin, bbox, 0);
+    return result;
+  };
+
+  // 노드 배열이 차지하는 메모리 크기 (바이트)
+  size_t node_bytes() const { return nodes.size() * sizeof(bvh_quantized_node); };
+
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  // 순회 스택 원소: 나중에 방문할 노드 인덱스, 그 노드의 frame_origin, 진입 거리
+  struct stack_entry
+  {
+    uint32_t index;
+    double origin[3];
+    double t;
+  };
+
+  static const int stack_capacity = 64; // 순회 스택 크기 (= 허용하는 트리 최대 깊이)
+
+  std::vector<bvh_quantized_node, aligned_allocator<bvh_quantized_node, 32>> nodes; // 깊이 우선 순서로 나열된 내부 노드 배열
+  leaf_primitives primitives;                                                       // 리프 범위 순서대로 타입별 배열에 재배치된 primitive
+  aabb bbox;                                                                        // 전체 BVH 를 감싸는 AABB (루트 frame)
+  double root_origin[3] = {0.0f, 0.0f, 0.0f};                                       // 루트 노드의 frame_origin (= bbox 최솟값)
+  uint32_t root_first = 0;                                                          // 루트가 리프인 경우의 primitive 범위
+  uint32_t root_count = 0;
+
+private:
+  // 노드에 저장된 두 자식의 양자화 좌표를 frame_origin 기준 double 좌표로 복원
+  // -> 빌드 시 quantize() 도 이 함수로 복원 결과를 검증하므로, 순회와 빌드의 부동소수점 계산 순서가 항상 같음
+  static void decode_children(const bvh_quantized_node &node, const double origin[3], double child_min[2][3], double child_max[2][3])
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      double step = exponent_step(node.exponent[axis]);
+      for (int i = 0; i < 2; i++)
+      {
+        child_min[i][axis] = origin[axis] + node.child_min[i][axis] * step;
+        child_max[i][axis] = origin[axis] + node.child_max[i][axis] * step;
+      }
+    }
+  };
+
+  // 빌드 결과 트리의 내부 노드(build_index)를 frame [frame_min, frame_max] 기준으로 양자화하여 노드 배열 끝에 추가하고, 추가된 인덱스 반환
+  uint32_t quantize(const bvh_builder &builder, int build_index, const double frame_min[3], const double frame_max[3])
+  {
+    const bvh_build_node &build_node = builder.nodes[build_index];
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(bvh_quantized_node());
+
+    bvh_quantized_node node = bvh_quantized_node();
+    node.axis = static_cast<uint8_t>(build_node.axis);
+
+    // 1. 축마다 frame 폭을 255 칸 이내로 나누는 가장 작은 2의 거듭제곱 간격 선택 (2의 거듭제곱이면 q * step 이 정확히 계산됨)
+    for (int axis = 0; axis < 3; axis++)
+    {
+      double extent = frame_max[axis] - frame_min[axis];
+      int e = extent > 0.0f ? static_cast<int>(std::ceil(std::log2(extent / 255.0))) : -126;
+      e = std::max(e, -126);
+      while (e < 127 && std::ldexp(255.0, e) < extent)
+      {
+        e++;
+      }
+      node.exponent[axis] = static_cast<int8_t>(e);
+    }
+
+    // 2. 두 자식 AABB 를 보수적으로 양자화 (최솟값은 내림, 최댓값은 올림 후 복원값으로 포함 여부 재확인)
+    const int children[2] = {build_node.left, build_node.right};
+    for (int i = 0; i < 2; i++)
+    {
+      const aabb &box = builder.nodes[children[i]].bbox;
+      for (int axis = 0; axis < 3; axis++)
+      {
+        const interval &ax = box.axis_interval(axis);
+        double step = exponent_step(node.exponent[axis]);
+        int lo = clamp_code(std::floor((ax.min - frame_min[axis]) / step));
+        int hi = clamp_code(std::ceil((ax.max - frame_min[axis]) / step));
+        while (lo > 0 && frame_min[axis] + lo * step > ax.min)
+        {
+          lo--;
+        }
+        while (hi < 255 && frame_min[axis] + hi * step < ax.max)
+        {
+          hi++;
+        }
+        node.child_min[i][axis] = static_cast<uint8_t>(lo);
+        node.child_max[i][axis] = static_cast<uint8_t>(hi);
+      }
+    }
+
+    // 3. 리프 자식은 primitive 범위를 바로 기록하고, 내부 노드 자식은 복원된 자식 AABB 를 frame 으로 재귀 양자화
+    double child_min[2][3], child_max[2][3];
+    decode_children(node, frame_min, child_min, child_max);
+    nodes[index] = node;
+    for (int i = 0; i < 2; i++)
+    {
+      const bvh_build_node &child = builder.nodes[children[i]];
+      if (child.is_leaf())
+      {
+        nodes[index].child[i] = static_cast<uint32_t>(child.first);
+        nodes[index].count[i] = static_cast<uint16_t>(child.count);
+      }
+      else
+      {
+        // 첫 번째 자식은 바로 다음 위치(index + 1)에 추가됨 (push_back 으로 nodes 가 재할당될 수 있으므로 인덱스로 접근)
+        uint32_t child_index = quantize(builder, children[i], child_min[i], child_max[i]);
+        nodes[index].child[i] = child_index;
+        nodes[index].count[i] = 0;
+      }
+    }
+    return index;
+  };
+
+  // 2^e 를 double 지수 비트로 직접 구성 (std::ldexp 는 라이브러리 호출이라 노드마다 부르기엔 느림, -126 <= e <= 127 이므로 항상 정규화 수)
+  static double exponent_step(int e)
+  {
+    uint64_t bits = static_cast<uint64_t>(e + 1023) << 52;
+    double step;
+    std::memcpy(&step, &bits, sizeof(step));
+    return step;
+  };
+
+  static int clamp_code(double q)
+  {
+    return q < 0.0f ? 0 : (q > 255.0f ? 255 : static_cast<int>(q));
+  };
+
+  // index 번째 노드(frame_origin 은 origin, AABB 는 box)를 루트로 하는 서브트리를 깊이 우선으로 순회하며 통계 누적
+  void collect_stats(bvh_stats &result, uint32_t index, const double origin[3], const aabb &box, int depth) const
+  {
+    const bvh_quantized_node &node = nodes[index];
+    double child_min[2][3], child_max[2][3];
+    decode_children(node, origin, child_min, child_max);
+
+    aabb children[2];
+    for (int i = 0; i < 2; i++)
+    {
+      children[i] = aabb(point3(child_min[i][0], child_min[i][1], child_min[i][2]),
+                         point3(child_max[i][0], child_max[i][1], child_max[i][2]));
+    }
+    result.add_interior(box, depth, children, 2);
+
+    for (int i = 0; i < 2; i++)
+    {
+      if (node.count[i] > 0)
+      {
+        result.add_leaf(children[i], depth + 1, node.count[i]);
+      }
+      else
+      {
+        collect_stats(result, node.child[i], child_min[i], children[i], depth + 1);
+      }
+    }
+  };
+};
+
+/**
+ * BVH 노드 양자화 (quantization)
+ *
+ *
+ * 수백만 primitive scene 에서는 노드 배열이 수십~수백 MB 가 되어 캐시에 거의 올라가지 않으므로,
+ * 순회 시간의 대부분이 노드 메모리를 읽는 대기 시간이 된다. 노드를 작게 만들면 같은 캐시/메모리 대역폭으로 더 많은 노드를 읽을 수 있다.
+ *
+ * 자식 AABB 는 항상 부모 AABB 안에 있으므로, 부모 AABB 를 기준 좌표계(frame)로 삼으면
+ * 자식 경계를 부모 폭의 1/255 단위 8 비트 정수로 표현할 수 있다.
+ *
+ *   float AABB 1개 = 24 바이트  ->  8 비트 양자화 AABB 1개 = 6 바이트
+ *
+ * 또한 리프 자식을 부모 노드 안에 직접 기록하므로 리프 노드가 사라져서,
+ * flat_bvh (노드 2n - 1 개 x 32 바이트) 대비 노드 배열 크기가 약 절반(내부 노드 n - 1 개 x 32 바이트)이 된다.
+ *
+ * ✅ 보수적 반올림 : 양자화 간격을 2의 거듭제곱으로 고르고 최솟값은 내림, 최댓값은 올림한 뒤,
+ *                  순회와 완전히 같은 계산식(decode_children)으로 복원해서 원래 AABB 를 포함하는지 확인한다.
+ *                  자식 frame 도 이 복원값을 그대로 사용하므로 양자화 오차가 깊이에 따라 누적되어도 포함 관계는 항상 유지된다.
+ * ⚠️ 복원된 AABB 는 원래보다 최대 한 칸(부모 폭의 1/255)씩 커지므로 빈 공간을 조금 더 방문하고,
+ *    노드마다 정수 -> double 복원 연산이 추가된다. 노드 배열이 캐시에 다 들어가는 작은 scene 에서는 flat_bvh 보다 느릴 수 있다.
+ */
+
+#endif /* BVH_QUANTIZED_HPP */
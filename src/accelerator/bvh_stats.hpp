@@ -0,0 +1,255 @@
+#ifndef BVH_STATS_HPP
+#define BVH_STATS_HPP
+
+#include "aabb.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * BVH 품질 통계 클래스
+ *
+ * - 각 가속 구조(bvh_node, flat_bvh, wide_bvh)가 자신의 노드를 깊이 우선으로 순회하면서
+ *   add_interior() / add_leaf() 로 노드 정보를 넘겨주면, 트리 형태와 품질 지표를 누적한다.
+ * - 가속 구조마다 노드 표현 방식은 다르지만 같은 지표로 비교할 수 있도록 통계 수집 로직은 이 클래스 하나로 통일한다.
+ * - print() 로 콘솔에 요약을 출력하고, write_obj() 로 노드 AABB 를 OBJ wireframe 파일로 저장할 수 있다. (하단 필기 참고)
+ */
+class bvh_stats
+{
+public:
+  // SAH 비용 계산에 사용할 상대 비용 (bvh_build_options 와 같은 의미)
+  bvh_stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f)
+      : traversal_cost(traversal_cost), intersection_cost(intersection_cost) {};
+
+  // 내부 노드 추가 (box: 노드 AABB, children: 자식 AABB 배열) -> 자식 AABB 간 겹침 비율 누적
+  void add_interior(const aabb &box, int depth, const aabb *children, int child_count)
+  {
+    add_node(box, depth);
+    interior_count++;
+    interior_area += box.surface_area();
+
+    // 형제 자식 쌍마다 교집합 AABB 의 표면적을 부모 표면적으로 나눈 값을 겹침 비율로 사용
+    double parent_area = box.surface_area();
+    if (parent_area <= 0.0f)
+    {
+      return;
+    }
+    for (int i = 0; i < child_count; i++)
+    {
+      for (int j = i + 1; j < child_count; j++)
+      {
+        double ratio = overlap_area(children[i], children[j]) / parent_area;
+        overlap_sum += ratio;
+        overlap_max = std::max(overlap_max, ratio);
+        sibling_pairs++;
+      }
+    }
+  };
+
+  // 리프 노드 추가 (primitive_count: 리프에 담긴 primitive 개수)
+  void add_leaf(const aabb &box, int depth, size_t primitive_count)
+  {
+    add_node(box, depth);
+    leaf_count++;
+    primitive_total += primitive_count;
+    leaf_area_weighted += box.surface_area() * primitive_count;
+
+    if (leaf_size_histogram.size() <= primitive_count)
+    {
+      leaf_size_histogram.resize(primitive_count + 1, 0);
+    }
+    leaf_size_histogram[primitive_count]++;
+    leaf_depth_sum += depth;
+  };
+
+  // 노드 개수
+  size_t node_count() const { return boxes.size(); };
+
+  // 트리 최대 깊이 (루트 깊이 0)
+  int max_depth() const { return static_cast<int>(depth_histogram.size()) - 1; };
+
+  // 리프당 평균 primitive 개수
+  double average_leaf_size() const { return leaf_count > 0 ? double(primitive_total) / leaf_count : 0.0f; };
+
+  // 트리 전체 SAH 비용 = Σ(내부 노드 SA / 루트 SA) * C_trav + Σ(리프 SA / 루트 SA) * N_leaf * C_isect
+  double sah_cost() const
+  {
+    double root_area = boxes.empty() ? 0.0f : boxes[0].surface_area();
+    if (root_area <= 0.0f)
+    {
+      return 0.0f;
+    }
+    return (interior_area * traversal_cost + leaf_area_weighted * intersection_cost) / root_area;
+  };
+
+  // 형제 자식 AABB 간 평균 겹침 비율 (교집합 표면적 / 부모 표면적)
+  double average_overlap() const { return sibling_pairs > 0 ? overlap_sum / sibling_pairs : 0.0f; };
+
+  // 통계 요약을 콘솔에 출력
+  void print(const char *name) const
+  {
+    printf("BVH stats [%s]\n", name);
+    if (boxes.empty())
+    {
+      printf("  (empty)\n");
+      return;
+    }
+
+    const aabb &root = boxes[0];
+    printf("  root bounds : (%.3f, %.3f, %.3f) - (%.3f, %.3f, %.3f), surface area %.3f\n",
+           root.x.min, root.y.min, root.z.min, root.x.max, root.y.max, root.z.max, root.surface_area());
+    printf("  nodes %zu (interior %zu, leaves %zu), primitives %zu, max depth %d, average leaf depth %.2f\n",
+           node_count(), interior_count, leaf_count, primitive_total, max_depth(),
+           leaf_count > 0 ? double(leaf_depth_sum) / leaf_count : 0.0f);
+    printf("  SAH cost %.3f (traversal %.2f, intersection %.2f)\n", sah_cost(), traversal_cost, intersection_cost);
+    printf("  sibling overlap: average %.4f, max %.4f over %zu pairs\n", average_overlap(), overlap_max, sibling_pairs);
+
+    printf("  primitives per leaf: average %.2f |", average_leaf_size());
+    for (size_t n = 0; n < leaf_size_histogram.size(); n++)
+    {
+      if (leaf_size_histogram[n] > 0)
+      {
+        printf(" %zu:%zu", n, leaf_size_histogram[n]);
+      }
+    }
+    printf("\n");
+
+    printf("  nodes per depth:");
+    for (size_t d = 0; d < depth_histogram.size(); d++)
+    {
+      printf(" %zu", depth_histogram[d]);
+    }
+    printf("\n");
+  };
+
+  // 노드 AABB 들을 OBJ wireframe(정점 8개 + 선분 12개) 파일로 저장 (max_depth 이하 깊이의 노드만, 음수이면 전체)
+  // -> 깊이별로 그룹(g depth_N)을 나눠두므로 OBJ 뷰어에서 깊이 단위로 켜고 끌 수 있음
+  bool write_obj(const std::string &path, int max_depth = -1) const
+  {
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+      fprintf(stderr, "Error: could not open file %s for writing.\n", path.c_str());
+      return false;
+    }
+
+    fprintf(file, "# BVH node bounds: %zu nodes\n", boxes.size());
+    size_t vertex_base = 1; // OBJ 정점 인덱스는 1 부터 시작
+    for (int depth = 0; depth <= this->max_depth(); depth++)
+    {
+      if (max_depth >= 0 && depth > max_depth)
+      {
+        break;
+      }
+      fprintf(file, "g depth_%d\n", depth);
+      for (size_t i = 0; i < boxes.size(); i++)
+      {
+        if (depths[i] != depth)
+        {
+          continue;
+        }
+        write_box(file, boxes[i], vertex_base);
+        vertex_base += 8;
+      }
+    }
+
+    fclose(file);
+    return true;
+  };
+
+private:
+  double traversal_cost;
+  double intersection_cost;
+
+  std::vector<aabb> boxes;                // 순회 순서대로 기록한 노드 AABB (0 번이 루트)
+  std::vector<int> depths;                // boxes 와 같은 순서의 노드 깊이
+  std::vector<size_t> depth_histogram;    // 깊이별 노드 개수
+  std::vector<size_t> leaf_size_histogram; // primitive 개수별 리프 개수
+  size_t interior_count = 0;
+  size_t leaf_count = 0;
+  size_t primitive_total = 0;
+  size_t leaf_depth_sum = 0;
+  double interior_area = 0.0f;      // 내부 노드 표면적 합
+  double leaf_area_weighted = 0.0f; // 리프 표면적 * primitive 개수 합
+  double overlap_sum = 0.0f;
+  double overlap_max = 0.0f;
+  size_t sibling_pairs = 0;
+
+private:
+  void add_node(const aabb &box, int depth)
+  {
+    boxes.push_back(box);
+    depths.push_back(depth);
+    if (depth_histogram.size() <= static_cast<size_t>(depth))
+    {
+      depth_histogram.resize(depth + 1, 0);
+    }
+    depth_histogram[depth]++;
+  };
+
+  // 두 AABB 교집합의 표면적 (겹치지 않으면 0)
+  static double overlap_area(const aabb &a, const aabb &b)
+  {
+    double dx = std::min(a.x.max, b.x.max) - std::max(a.x.min, b.x.min);
+    double dy = std::min(a.y.max, b.y.max) - std::max(a.y.min, b.y.min);
+    double dz = std::min(a.z.max, b.z.max) - std::max(a.z.min, b.z.min);
+    if (dx <= 0.0f || dy <= 0.0f || dz <= 0.0f)
+    {
+      return 0.0f;
+    }
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+  };
+
+  // AABB 하나를 정점 8개와 모서리 12개로 기록
+  static void write_box(FILE *file, const aabb &box, size_t base)
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      fprintf(file, "v %g %g %g\n",
+              (i & 1) ? box.x.max : box.x.min,
+              (i & 2) ? box.y.max : box.y.min,
+              (i & 4) ? box.z.max : box.z.min);
+    }
+
+    // 정점 인덱스 비트(x: 1, y: 2, z: 4)가 하나만 다른 두 꼭짓점을 잇는 선분이 AABB 모서리
+    static const int edges[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7},
+                                     {0, 2}, {1, 3}, {4, 6}, {5, 7},
+                                     {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+    for (int e = 0; e < 12; e++)
+    {
+      fprintf(file, "l %zu %zu\n", base + edges[e][0], base + edges[e][1]);
+    }
+  };
+};
+
+/**
+ * BVH 품질 지표
+ *
+ *
+ * 1. SAH 비용
+ *   - 광선이 노드 AABB 에 맞을 확률이 AABB 표면적에 비례한다는 가정(bvh_build.hpp 하단 필기 참고)으로 트리 전체의 기대 순회 비용을 추정한 값.
+ *   - 같은 scene 에서 빌더(SAH binning, LBVH 등)끼리 비교할 때 낮을수록 좋은 트리이다.
+ *     (단, 루트 표면적으로 정규화하므로 서로 다른 scene 끼리는 비교할 수 없음)
+ *
+ * 2. 형제 겹침 비율 (sibling overlap)
+ *   - 형제 자식 AABB 의 교집합 표면적 / 부모 표면적
+ *   - 겹친 영역을 지나는 광선은 두 서브트리를 모두 방문해야 하므로, 값이 클수록 순회 중 불필요한 방문이 많아진다.
+ *
+ * 3. 깊이 분포와 리프 크기 분포
+ *   - 특정 깊이에 노드가 몰려 있거나 최대 깊이가 primitive 수에 비해 지나치게 깊으면 한쪽으로 치우친(불균형) 트리이다.
+ *   - 빌더는 binning 으로 나눌 수 없는 노드(ex> centroid 가 모두 같은 위치)도 object median 으로 분할하므로, 리프 크기는 항상 max_leaf_size 이하이다.
+ *     대신 이런 퇴화된(degenerate) 입력은 최대 깊이가 primitive 수에 비해 깊어지거나 형제 겹침 비율이 커지는 것으로 드러난다.
+ *
+ * 4. 루트 bounds
+ *   - bouncing_spheres 의 반지름 1000 짜리 지면 구처럼 거대한 primitive 가 하나만 있어도 루트 AABB 가 수천 배로 커지고,
+ *     그 primitive 를 담은 리프의 표면적이 SAH 비용 대부분을 차지하게 된다. 루트 bounds 와 SAH 비용을 함께 보면 이런 경우를 바로 찾을 수 있다.
+ *
+ *
+ * OBJ wireframe 덤프
+ *
+ *
+ * OBJ 포맷은 'v x y z' 로 정점을, 'l a b' 로 두 정점을 잇는 선분을 정의할 수 있으므로
+ * AABB 하나를 정점 8개 + 모서리 12개로 기록하면 대부분의 3D 뷰어(Blender, MeshLab 등)에서 바로 열어볼 수 있다.
+ */
+
+#endif /* BVH_STATS_HPP */
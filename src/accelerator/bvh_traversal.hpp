@@ -0,0 +1,194 @@
+#ifndef BVH_TRAVERSAL_HPP
+#define BVH_TRAVERSAL_HPP
+
+#include "aabb.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+/**
+ * 깊이 우선 순서로 평탄화된 이진 BVH 노드 배열의 공통 순회 함수
+ *
+ * - flat_bvh, motion_bvh, triangle_mesh, sphere_set 처럼 "좌측 자식 = 다음 인덱스, 우측 자식 = offset" 규칙을 따르는
+ *   노드 배열을 near child first 순서로 순회한다. (bvh_flat.hpp 하단 필기 '순회 순서' 참고)
+ * - 노드 타입과 노드 AABB 검사 방법(node_test), 리프 검사 방법(leaf)은 템플릿 인자로 받으므로,
+ *   호출하는 쪽은 lambda 만 넘기고 순회 루프는 인라인되어 가상 함수 호출 없이 동작한다.
+ * - 노드 타입 NODE 는 offset, axis 멤버와 is_leaf() 를 가져야 한다.
+ */
+
+const int bvh_stack_capacity = 64; // 순회 스택 크기 (= 허용하는 트리 최대 깊이)
+
+// 순회 스택 원소: 나중에 방문할 노드 인덱스와 그 노드 AABB 의 진입 거리
+struct bvh_stack_entry
+{
+  uint32_t index;
+  double t;
+};
+
+/**
+ * root 노드를 루트로 하는 트리에서 가장 가까운 교차점 탐색
+ *
+ * node_test(node, ray_t, t_entry) : 노드 AABB 와 광선의 교차 여부 (교차 시 진입 거리 출력)
+ * leaf(node, ray_t)               : 리프 노드의 primitive 들을 검사하고, 교차하면 ray_t.max 를 교차 t 로 좁힌 뒤 true 반환
+ * → 하나라도 교차하면 true 를 반환하며, 이때 ray_t.max 는 가장 가까운 교차 t 이다.
+ */
+template <typename NODE, typename NODE_TEST, typename LEAF>
+inline bool bvh_traverse_closest(const NODE *nodes, uint32_t root, const traversal_ray &tr, interval &ray_t, NODE_TEST node_test, LEAF leaf)
+{
+  // 루트 노드 AABB 와 교차하지 않으면 바로 종료
+  double t_entry;
+  if (!node_test(nodes[root], ray_t, t_entry))
+  {
+    return false;
+  }
+
+  // 나중에 방문할 먼 자식 노드 인덱스와 그 진입 거리를 쌓아두는 고정 크기 스택 (트리 깊이는 빌드 시 max_depth 이하로 제한됨)
+  bvh_stack_entry stack[bvh_stack_capacity];
+  int stack_size = 0;
+  uint32_t current = root; // 현재 방문 중인 노드 (항상 광선과 AABB 가 교차하는 것이 확인된 노드)
+  bool hit_anything = false;
+
+  while (true)
+  {
+    const NODE &node = nodes[current];
+
+    if (node.is_leaf())
+    {
+      // 리프 노드: 범위 내 primitive 들과 교차 검사하며 가장 가까운 교차점으로 ray_t.max 를 좁혀나감
+      if (leaf(node, ray_t))
+      {
+        hit_anything = true;
+      }
+    }
+    else
+    {
+      // 내부 노드: 분할 축 방향으로 광선이 먼저 만나는 자식(near)과 나중에 만나는 자식(far) 결정
+      // -> 좌측 자식에는 분할 축 좌표가 작은 primitive 들이 모여 있으므로, 광선이 음의 방향으로 진행하면 우측 자식이 더 가까움
+      uint32_t near_child = current + 1;
+      uint32_t far_child = node.offset;
+      if (tr.sign[node.axis])
+      {
+        std::swap(near_child, far_child);
+      }
+
+      double t_near, t_far;
+      bool hit_near = node_test(nodes[near_child], ray_t, t_near);
+      bool hit_far = node_test(nodes[far_child], ray_t, t_far);
+
+      if (hit_near)
+      {
+        // 가까운 자식으로 바로 내려가고, 먼 자식도 교차하면 진입 거리와 함께 스택에 보관
+        if (hit_far)
+        {
+          stack[stack_size++] = bvh_stack_entry{far_child, t_far};
+        }
+        current = near_child;
+        continue;
+      }
+      if (hit_far)
+      {
+        current = far_child;
+        continue;
+      }
+    }
+
+    // 스택에서 다음 노드를 꺼내되, 진입 거리가 지금까지 찾은 가장 가까운 교차점보다 먼 노드는 방문하지 않고 버림
+    while (stack_size > 0 && stack[stack_size - 1].t >= ray_t.max)
+    {
+      stack_size--;
+    }
+    if (stack_size == 0)
+    {
+      break;
+    }
+    current = stack[--stack_size].index;
+  }
+
+  return hit_anything;
+};
+
+/**
+ * root 노드를 루트로 하는 트리에서 차폐 검사: 교차하는 primitive 를 하나라도 찾으면 즉시 종료
+ *
+ * leaf(node, ray_t) : 리프 노드의 primitive 중 하나라도 ray_t 범위 안에서 교차하면 true 반환
+ * → 스택에 넣은 노드의 진입 거리 비교가 필요 없으므로 노드 인덱스만 보관
+ */
+template <typename NODE, typename NODE_TEST, typename LEAF>
+inline bool bvh_traverse_any(const NODE *nodes, uint32_t root, const traversal_ray &tr, interval ray_t, NODE_TEST node_test, LEAF leaf)
+{
+  double t_entry;
+  if (!node_test(nodes[root], ray_t, t_entry))
+  {
+    return false;
+  }
+
+  uint32_t stack[bvh_stack_capacity];
+  int stack_size = 0;
+  uint32_t current = root;
+
+  while (true)
+  {
+    const NODE &node = nodes[current];
+
+    if (node.is_leaf())
+    {
+      if (leaf(node, ray_t))
+      {
+        return true;
+      }
+    }
+    else
+    {
+      // 가까운 자식을 먼저 방문하면 차폐물을 더 일찍 만날 가능성이 높으므로 bvh_traverse_closest() 와 같은 순서로 순회
+      uint32_t near_child = current + 1;
+      uint32_t far_child = node.offset;
+      if (tr.sign[node.axis])
+      {
+        std::swap(near_child, far_child);
+      }
+
+      bool hit_near = node_test(nodes[near_child], ray_t, t_entry);
+      bool hit_far = node_test(nodes[far_child], ray_t, t_entry);
+      if (hit_near)
+      {
+        if (hit_far)
+        {
+          stack[stack_size++] = far_child;
+        }
+        current = near_child;
+        continue;
+      }
+      if (hit_far)
+      {
+        current = far_child;
+        continue;
+      }
+    }
+
+    if (stack_size == 0)
+    {
+      break;
+    }
+    current = stack[--stack_size];
+  }
+
+  return false;
+};
+
+// double 경계값을 float 로 저장할 때 원래 값보다 커지지 않도록 아래로 반올림 (AABB 최솟값용)
+inline float round_down(double x)
+{
+  float f = static_cast<float>(x);
+  return static_cast<double>(f) > x ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+};
+
+// double 경계값을 float 로 저장할 때 원래 값보다 작아지지 않도록 위로 반올림 (AABB 최댓값용)
+inline float round_up(double x)
+{
+  float f = static_cast<float>(x);
+  return static_cast<double>(f) < x ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+};
+
+#endif /* BVH_TRAVERSAL_HPP */
@@ -0,0 +1,405 @@
+#ifndef BVH_WIDE_HPP
+#define BVH_WIDE_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_stats.hpp"
+#include "bvh_traversal.hpp"
+#include "leaf_primitives.hpp"
+#include "common/aligned_allocator.hpp"
+#include "common/simd.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * 4-wide BVH(BVH4) 의 노드
+ *
+ * - 최대 4개 자식 노드의 AABB 를 축/경계별로 모아둔 SoA(Structure of Arrays) 형태로 저장한다.
+ *   -> ex> bounds_min_x[0..3] 은 4개 자식 AABB 의 x 축 최솟값들
+ *   -> 따라서 lanes<float, 4>::load() 한 번으로 4개 자식의 같은 경계값을 SIMD 레지스터에 올릴 수 있다.
+ * - AABB 는 flat_bvh 와 동일하게 float 로 바깥 방향 반올림하여 저장하고, 교차 검사는 double 로 변환해서 수행한다.
+ * - 128 바이트(캐시 라인 2개) 크기이며, 노드 배열은 64 바이트 경계에 정렬한다.
+ */
+class alignas(64) bvh_wide_node
+{
+public:
+  float bounds_min_x[4]; // 4개 자식 AABB 의 x 축 최솟값 (아래로 반올림)
+  float bounds_min_y[4];
+  float bounds_min_z[4];
+  float bounds_max_x[4]; // 4개 자식 AABB 의 x 축 최댓값 (위로 반올림)
+  float bounds_max_y[4];
+  float bounds_max_z[4];
+  uint32_t child[4];     // 내부 노드 자식: 자식 노드 인덱스 / 리프 자식: wide_bvh::primitives 내 첫 번째 primitive 인덱스
+  uint16_t count[4];     // 리프 자식의 primitive 개수 (0 이면 내부 노드 자식)
+  uint32_t child_count;  // 유효한 자식 개수 (1 ~ 4)
+  uint32_t pad;          // 128 바이트 크기를 맞추기 위한 padding
+};
+
+static_assert(sizeof(bvh_wide_node) == 128, "bvh_wide_node must be 128 bytes");
+
+/**
+ * 4-wide BVH 클래스
+ *
+ * - bvh_builder(SAH + binning)로 만든 이진 트리에서, 표면적이 가장 큰 내부 노드 자식을 그 자식들로 대체하는 과정을
+ *   자식이 4개가 될 때까지 반복하여 이진 트리의 2단계를 노드 하나로 접는다(collapse). (하단 필기 참고)
+ * - 노드 하나를 방문할 때 4개 자식 AABB 와의 slab test 를 lanes<double, 4> 연산 한 번에 수행하고,
+ *   교차한 자식들을 진입 거리(entry distance)가 가까운 순서대로 방문한다.
+ */
+class wide_bvh : public hittable
+{
+public:
+  wide_bvh(hittable_list list, const bvh_build_options &options = bvh_build_options())
+  {
+    // 순회 스택 크기를 넘지 않도록 트리 최대 깊이 제한 (노드 하나를 방문할 때마다 최대 3개의 자식이 스택에 남음)
+    bvh_build_options build_options = options;
+    if (build_options.max_depth > (stack_capacity - 1) / 3)
+    {
+      build_options.max_depth = (stack_capacity - 1) / 3;
+    }
+    bvh_builder builder(list.objects, build_options);
+
+    // 리프 노드가 연속된 범위로 참조할 수 있도록 빌드 결과 순서대로 primitive 재배치
+    primitives.reserve(builder.prim_indices.size());
+    for (size_t index : builder.prim_indices)
+    {
+      primitives.add(list.objects[index]);
+    }
+
+    bbox = builder.nodes[builder.root].bbox;
+    if (!primitives.empty())
+    {
+      collapse(builder, builder.root);
+    }
+  };
+
+  // 광선과의 교차 여부 검사
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    // 광선 출발점과 방향벡터 역수를 4개 lane 모두에 broadcast (광선 하나당 한 번만 계산)
+    const traversal_ray tr(r);
+    const lane_type origin_x(tr.origin.x()), origin_y(tr.origin.y()), origin_z(tr.origin.z());
+    const lane_type inv_dir_x(tr.inv_dir[0]), inv_dir_y(tr.inv_dir[1]), inv_dir_z(tr.inv_dir[2]);
+
+    // 방문할 자식(내부 노드 또는 리프 primitive 범위)과 그 진입 거리를 쌓아두는 고정 크기 스택
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    stack[stack_size++] = stack_entry{0, 0, -infinity};
+    bool hit_anything = false;
+    uint32_t closest = 0; // 가장 가까운 교차 primitive 의 리프 순서 인덱스 (충돌 정보는 순회가 끝난 뒤 한 번만 계산)
+
+    while (stack_size > 0)
+    {
+      const stack_entry entry = stack[--stack_size];
+
+      // 스택에 넣은 뒤에 더 가까운 교차점이 발견되었다면, 진입 거리가 그보다 먼 자식은 방문할 필요 없음
+      if (entry.t >= ray_t.max)
+      {
+        continue;
+      }
+
+      if (entry.count > 0)
+      {
+        // 리프 자식: 범위 내 primitive 들과 교차 검사하며 가장 가까운 교차점으로 ray_t.max 를 좁혀나감
+        if (primitives.intersect(entry.index, entry.count, r, ray_t, rec, closest))
+        {
+          hit_anything = true;
+        }
+        continue;
+      }
+
+      // 내부 노드: 4개 자식 AABB 와의 slab test 를 한 번에 수행
+      const bvh_wide_node &node = nodes[entry.index];
+      lane_type t_near;
+      int hit_mask = intersect_children(node, tr.sign, origin_x, origin_y, origin_z, inv_dir_x, inv_dir_y, inv_dir_z, ray_t, t_near);
+      if (hit_mask == 0)
+      {
+        continue;
+      }
+
+      // 교차한 자식들을 진입 거리 내림차순으로 정렬한 뒤 스택에 push -> 가장 가까운 자식이 스택 top 에 오므로 먼저 방문됨
+      stack_entry hits[4];
+      int hit_count = 0;
+      for (int i = 0; i < 4; i++)
+      {
+        if (hit_mask & (1 << i))
+        {
+          stack_entry e{node.child[i], node.count[i], t_near[i]};
+          int j = hit_count++;
+          while (j > 0 && hits[j - 1].t < e.t)
+          {
+            hits[j] = hits[j - 1];
+            j--;
+          }
+          hits[j] = e;
+        }
+      }
+      for (int i = 0; i < hit_count; i++)
+      {
+        stack[stack_size++] = hits[i];
+      }
+    }
+
+    // 순회가 끝난 뒤 가장 가까운 교차점 하나에 대해서만 교차점, normal, uv, material 계산
+    if (hit_anything)
+    {
+      primitives.finalize(closest, r, ray_t.max, rec);
+    }
+    return hit_anything;
+  };
+
+  // 차폐 검사: 교차하는 primitive 를 하나라도 찾으면 즉시 종료 (자식 진입 거리 정렬 생략)
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    if (primitives.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    const lane_type origin_x(tr.origin.x()), origin_y(tr.origin.y()), origin_z(tr.origin.z());
+    const lane_type inv_dir_x(tr.inv_dir[0]), inv_dir_y(tr.inv_dir[1]), inv_dir_z(tr.inv_dir[2]);
+
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    stack[stack_size++] = stack_entry{0, 0, -infinity};
+
+    while (stack_size > 0)
+    {
+      const stack_entry entry = stack[--stack_size];
+
+      if (entry.count > 0)
+      {
+        if (primitives.occluded(entry.index, entry.count, r, ray_t))
+        {
+          return true;
+        }
+        continue;
+      }
+
+      const bvh_wide_node &node = nodes[entry.index];
+      lane_type t_near;
+      int hit_mask = intersect_children(node, tr.sign, origin_x, origin_y, origin_z, inv_dir_x, inv_dir_y, inv_dir_z, ray_t, t_near);
+      for (int i = 0; i < 4; i++)
+      {
+        if (hit_mask & (1 << i))
+        {
+          stack[stack_size++] = stack_entry{node.child[i], node.count[i], t_near[i]};
+        }
+      }
+    }
+
+    return false;
+  };
+
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (!primitives.empty())
+    {
+      collect_stats(result, 0, 0, bbox);
+    }
+    return result;
+  };
+
+  // 전체 BVH 를 감싸는 AABB 반환 함수
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  using lane_type = lanes<double, 4>;
+
+  // 순회 스택 원소: index/count 는 bvh_wide_node::child/count 와 같은 의미, t 는 자식 AABB 의 진입 거리
+  struct stack_entry
+  {
+    uint32_t index;
+    uint32_t count;
+    double t;
+  };
+
+  // 노드 하나를 방문할 때마다 최대 3개의 자식이 스택에 남으므로, 트리 깊이(max_depth) * 3 + 1 이상이어야 함 (생성자에서 max_depth 제한)
+  static const int stack_capacity = 256;
+
+  std::vector<bvh_wide_node, aligned_allocator<bvh_wide_node, 64>> nodes; // 깊이 우선 순서로 나열된 4-wide 노드 배열 (루트는 0번)
+  leaf_primitives primitives;                                             // 리프 범위 순서대로 타입별 배열에 재배치된 primitive (leaf_primitives.hpp 참고)
+  aabb bbox;                                                              // 전체 BVH 를 감싸는 AABB
+
+private:
+  // index 번째 노드(AABB 는 box)를 루트로 하는 서브트리를 깊이 우선으로 순회하며 노드 정보를 통계에 추가
+  void collect_stats(bvh_stats &result, uint32_t index, int depth, const aabb &box) const
+  {
+    const bvh_wide_node &node = nodes[index];
+    aabb children[4];
+    for (uint32_t i = 0; i < node.child_count; i++)
+    {
+      children[i] = aabb(point3(node.bounds_min_x[i], node.bounds_min_y[i], node.bounds_min_z[i]),
+                         point3(node.bounds_max_x[i], node.bounds_max_y[i], node.bounds_max_z[i]));
+    }
+    result.add_interior(box, depth, children, static_cast<int>(node.child_count));
+
+    for (uint32_t i = 0; i < node.child_count; i++)
+    {
+      if (node.count[i] > 0)
+      {
+        result.add_leaf(children[i], depth + 1, node.count[i]);
+      }
+      else
+      {
+        collect_stats(result, node.child[i], depth + 1, children[i]);
+      }
+    }
+  };
+
+  // 4개 자식 AABB 와 광선의 slab test 를 SIMD 로 수행하고, 교차한 자식 lane 을 비트로 모아 반환 (진입 거리는 t_near 로 출력)
+  static int intersect_children(const bvh_wide_node &node, const int *sign,
+                                const lane_type &origin_x, const lane_type &origin_y, const lane_type &origin_z,
+                                const lane_type &inv_dir_x, const lane_type &inv_dir_y, const lane_type &inv_dir_z,
+                                const interval &ray_t, lane_type &t_near)
+  {
+    // 축별 방향 부호로 광선이 먼저 만나는 경계면(near)과 나중에 만나는 경계면(far) 배열을 미리 선택 (aabb.hpp 의 slab_test() 와 동일)
+    // -> lane 별로 t0, t1 을 min/max 로 정렬하는 연산이 필요 없어짐
+    const float *near_x = sign[0] ? node.bounds_max_x : node.bounds_min_x;
+    const float *far_x = sign[0] ? node.bounds_min_x : node.bounds_max_x;
+    const float *near_y = sign[1] ? node.bounds_max_y : node.bounds_min_y;
+    const float *far_y = sign[1] ? node.bounds_min_y : node.bounds_max_y;
+    const float *near_z = sign[2] ? node.bounds_max_z : node.bounds_min_z;
+    const float *far_z = sign[2] ? node.bounds_min_z : node.bounds_max_z;
+
+    // float 로 저장된 경계값을 double 로 변환해서 슬랩 경계면과의 교차 시점 계산
+    lane_type t_near_x = (widen(lanes<float, 4>::load(near_x)) - origin_x) * inv_dir_x;
+    lane_type t_far_x = (widen(lanes<float, 4>::load(far_x)) - origin_x) * inv_dir_x;
+    lane_type t_near_y = (widen(lanes<float, 4>::load(near_y)) - origin_y) * inv_dir_y;
+    lane_type t_far_y = (widen(lanes<float, 4>::load(far_y)) - origin_y) * inv_dir_y;
+    lane_type t_near_z = (widen(lanes<float, 4>::load(near_z)) - origin_z) * inv_dir_z;
+    lane_type t_far_z = (widen(lanes<float, 4>::load(far_z)) - origin_z) * inv_dir_z;
+
+    // 각 축의 진입/탈출 시점 중 가장 늦은 진입, 가장 빠른 탈출 시점을 lane 별로 누적
+    // -> min/max 는 NaN 이 섞이면 두 번째 피연산자를 반환하므로, 누적값을 두 번째 피연산자로 두어 NaN 인 축은 무시되도록 함
+    lane_type t_min = max(t_near_x, lane_type(ray_t.min));
+    t_min = max(t_near_y, t_min);
+    t_min = max(t_near_z, t_min);
+    lane_type t_max = min(t_far_x, lane_type(ray_t.max));
+    t_max = min(t_far_y, t_max);
+    t_max = min(t_far_z, t_max);
+
+    t_near = t_min;
+    return (t_min < t_max).bits() & ((1 << node.child_count) - 1);
+  };
+
+  // 이진 트리의 build_index 번째 노드를 루트로 하는 서브트리를 4-wide 노드로 접어서 노드 배열에 추가하고, 추가된 노드의 인덱스를 반환
+  uint32_t collapse(const bvh_builder &builder, int build_index)
+  {
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(bvh_wide_node());
+
+    // 1. 현재 노드의 자식 후보 수집
+    int children[4];
+    int child_count = 0;
+    const bvh_build_node &build_node = builder.nodes[build_index];
+    if (build_node.is_leaf())
+    {
+      // 전체 primitive 가 리프 하나에 들어간 경우(루트가 리프) -> 자식이 하나뿐인 노드로 표현
+      children[child_count++] = build_index;
+    }
+    else
+    {
+      children[child_count++] = build_node.left;
+      children[child_count++] = build_node.right;
+    }
+
+    // 2. 자식이 4개가 될 때까지, 표면적이 가장 큰 내부 노드 자식을 그 두 자식으로 대체
+    // -> 광선이 통과할 확률이 가장 높은 자식부터 펼쳐야 노드 하나의 SIMD 검사로 걸러낼 수 있는 범위가 커짐
+    while (child_count < 4)
+    {
+      int best = -1;
+      double best_area = -1.0f;
+      for (int i = 0; i < child_count; i++)
+      {
+        const bvh_build_node &child = builder.nodes[children[i]];
+        if (!child.is_leaf() && child.bbox.surface_area() > best_area)
+        {
+          best = i;
+          best_area = child.bbox.surface_area();
+        }
+      }
+      if (best < 0)
+      {
+        break;
+      }
+
+      const bvh_build_node &expanded = builder.nodes[children[best]];
+      children[best] = expanded.left;
+      children[child_count++] = expanded.right;
+    }
+
+    // 3. 자식 AABB 를 SoA 형태로 기록하고, 내부 노드 자식은 재귀적으로 접어서 인덱스를 기록
+    // (재귀 호출 중 push_back 으로 nodes 가 재할당될 수 있으므로 참조 대신 인덱스로 접근)
+    for (int i = 0; i < 4; i++)
+    {
+      if (i >= child_count)
+      {
+        // 사용하지 않는 lane 은 비어 있는 AABB 로 채우고 child_count 마스크로 걸러냄
+        set_child_bounds(nodes[index], i, aabb::empty);
+        nodes[index].child[i] = 0;
+        nodes[index].count[i] = 0;
+        continue;
+      }
+
+      const bvh_build_node &child = builder.nodes[children[i]];
+      set_child_bounds(nodes[index], i, child.bbox);
+      if (child.is_leaf())
+      {
+        nodes[index].child[i] = static_cast<uint32_t>(child.first);
+        nodes[index].count[i] = static_cast<uint16_t>(child.count);
+      }
+      else
+      {
+        uint32_t child_index = collapse(builder, children[i]);
+        nodes[index].child[i] = child_index;
+        nodes[index].count[i] = 0;
+      }
+    }
+    nodes[index].child_count = static_cast<uint32_t>(child_count);
+    nodes[index].pad = 0;
+    return index;
+  };
+
+  // slot 번째 lane 에 자식 AABB 를 float 로 바깥 방향 반올림하여 기록
+  static void set_child_bounds(bvh_wide_node &node, int slot, const aabb &box)
+  {
+    node.bounds_min_x[slot] = round_down(box.x.min);
+    node.bounds_min_y[slot] = round_down(box.y.min);
+    node.bounds_min_z[slot] = round_down(box.z.min);
+    node.bounds_max_x[slot] = round_up(box.x.max);
+    node.bounds_max_y[slot] = round_up(box.y.max);
+    node.bounds_max_z[slot] = round_up(box.z.max);
+  };
+};
+
+/**
+ * 이진 BVH 를 4-wide BVH 로 접기(collapse)
+ *
+ *
+ * 이진 BVH 는 노드 하나를 방문할 때마다 AABB 1개와 교차 검사를 하므로, SIMD 레지스터의 나머지 lane 이 놀게 된다.
+ * 이진 트리의 부모-자식 2단계를 하나의 노드로 합치면 노드 하나가 최대 4개의 자식을 가지게 되고,
+ * 4개 자식 AABB 의 같은 축 경계값들을 SoA 로 모아두면 slab test 한 번을 4개 lane 에 대해 동시에 수행할 수 있다.
+ *
+ *   - 트리 깊이가 약 절반으로 줄어들어 순회 시 노드 방문(= 스택 push/pop, 분기) 횟수가 줄어들고,
+ *   - 노드 하나를 방문할 때 필요한 AABB 데이터가 연속된 128 바이트에 모여 있어 메모리 접근이 효율적이다.
+ *
+ * 교차한 자식들은 진입 거리(t_near)가 가까운 순서대로 방문한다.
+ * 가까운 자식에서 교차점을 먼저 찾으면 ray_t.max 가 빨리 줄어들고,
+ * 스택에 남아 있던 먼 자식들은 pop 되는 시점에 진입 거리가 ray_t.max 보다 크면 바로 버려진다.
+ *
+ * SIMD 백엔드가 켜진 빌드(RTW_USE_SIMD)에서는 lanes<double, 4> 가 AVX 레지스터 하나로 처리되고,
+ * 그렇지 않으면 포터블 구현(배열 반복문)으로 동일한 결과를 계산한다.
+ */
+
+#endif /* BVH_WIDE_HPP */
@@ -0,0 +1,349 @@
+#ifndef GRID_HPP
+#define GRID_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * 균일 격자(uniform grid) 가속 구조 클래스
+ *
+ * - scene AABB 를 같은 크기의 cell 들로 나누고, 각 cell 에 AABB 가 겹치는 primitive 인덱스 목록을 저장한다.
+ * - 광선은 3D-DDA(Amanatides & Woo)로 지나가는 cell 들을 광선 진행 순서대로 방문하므로,
+ *   가까운 cell 에서 교차점을 찾으면 나머지 cell 은 방문하지 않는다. (하단 필기 참고)
+ * - cell 별 primitive 목록은 cell_start / cell_prims 두 배열(CSR 형식)에 연속으로 저장한다.
+ * - 지면 sphere 처럼 scene 대부분을 덮는 큰 primitive 는 격자에 넣으면 거의 모든 cell 에 등록되므로,
+ *   따로 large_primitives 목록에 두고 격자 순회 전에 항상 검사한다.
+ */
+class uniform_grid : public hittable
+{
+public:
+  uniform_grid(hittable_list list, const bvh_build_options &options = bvh_build_options())
+  {
+    auto build_start = std::chrono::high_resolution_clock::now();
+    bbox = list.bounding_box();
+    if (list.objects.empty())
+    {
+      return;
+    }
+
+    // 1. primitive 중심점 분포 크기에 비해 너무 큰 primitive 를 격자에서 제외
+    aabb centroid_bounds = aabb::empty;
+    for (const auto &object : list.objects)
+    {
+      point3 c = object->bounding_box().centroid();
+      centroid_bounds = aabb(centroid_bounds, aabb(c, c));
+    }
+    double large_diagonal = large_primitive_ratio * diagonal(centroid_bounds);
+
+    std::vector<aabb> boxes;
+    grid_bounds = aabb::empty;
+    for (const auto &object : list.objects)
+    {
+      aabb box = object->bounding_box();
+      if (diagonal(box) > large_diagonal)
+      {
+        large_primitives.push_back(object);
+        continue;
+      }
+      primitives.push_back(object);
+      boxes.push_back(box);
+      grid_bounds = aabb(grid_bounds, box);
+    }
+
+    if (!primitives.empty())
+    {
+      // 2. 해상도 결정: 축마다 cell 크기가 같도록, 전체 cell 개수가 grid_density * primitive 수가 되도록 설정
+      double volume = grid_bounds.x.size() * grid_bounds.y.size() * grid_bounds.z.size();
+      double cells_per_unit = std::cbrt(options.grid_density * primitives.size() / volume);
+      for (int axis = 0; axis < 3; axis++)
+      {
+        const interval &extent = grid_bounds.axis_interval(axis);
+        int n = static_cast<int>(std::round(extent.size() * cells_per_unit));
+        resolution[axis] = n < 1 ? 1 : (n > max_resolution ? max_resolution : n);
+        origin[axis] = extent.min;
+        cell_size[axis] = extent.size() / resolution[axis];
+      }
+
+      // 3. cell 마다 겹치는 primitive 개수를 센 뒤, 누적합으로 각 cell 목록의 시작 위치를 정하고 인덱스 채우기
+      size_t cell_count = static_cast<size_t>(resolution[0]) * resolution[1] * resolution[2];
+      cell_start.assign(cell_count + 1, 0);
+      for (size_t i = 0; i < boxes.size(); i++)
+      {
+        for_each_cell(boxes[i], [this](size_t cell)
+                      { cell_start[cell + 1]++; });
+      }
+      for (size_t cell = 0; cell < cell_count; cell++)
+      {
+        cell_start[cell + 1] += cell_start[cell];
+      }
+
+      cell_prims.resize(cell_start[cell_count]);
+      std::vector<uint32_t> fill(cell_start.begin(), cell_start.end() - 1);
+      for (size_t i = 0; i < boxes.size(); i++)
+      {
+        for_each_cell(boxes[i], [this, &fill, i](size_t cell)
+                      { cell_prims[fill[cell]++] = static_cast<uint32_t>(i); });
+      }
+    }
+
+    if (options.report_timings || options.report_stats)
+    {
+      auto build_end = std::chrono::high_resolution_clock::now();
+      size_t cell_count = cell_start.empty() ? 0 : cell_start.size() - 1;
+      size_t empty_cells = 0;
+      for (size_t cell = 0; cell < cell_count; cell++)
+      {
+        empty_cells += cell_start[cell] == cell_start[cell + 1];
+      }
+      printf("grid build: %zu prims (%zu large) -> %d x %d x %d cells (%.1f%% empty), %.2f references per prim | total %.2f ms\n",
+             list.objects.size(), large_primitives.size(), resolution[0], resolution[1], resolution[2],
+             cell_count > 0 ? 100.0 * empty_cells / cell_count : 0.0,
+             primitives.empty() ? 0.0 : double(cell_prims.size()) / primitives.size(),
+             std::chrono::duration<double, std::milli>(build_end - build_start).count());
+    }
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    bool hit_anything = false;
+
+    // 큰 primitive 를 먼저 검사해서 ray_t.max 를 좁혀두면 격자 순회도 그만큼 일찍 끝남
+    for (const auto &object : large_primitives)
+    {
+      if (object->hit(r, ray_t, rec))
+      {
+        hit_anything = true;
+        ray_t.max = rec.t;
+      }
+    }
+
+    // 광선이 지나가는 cell 들을 가까운 순서로 방문하며 cell 의 primitive 들과 교차 검사
+    grid_walker walker(*this, r, ray_t);
+    while (walker.valid())
+    {
+      for (uint32_t i = cell_start[walker.cell]; i < cell_start[walker.cell + 1]; i++)
+      {
+        if (primitives[cell_prims[i]]->hit(r, ray_t, rec))
+        {
+          hit_anything = true;
+          ray_t.max = rec.t;
+        }
+      }
+
+      // 여러 cell 에 걸친 primitive 는 현재 cell 밖의 교차점을 반환할 수 있으므로,
+      // 교차점이 현재 cell 안쪽(= 다음 cell 진입 전)일 때만 더 가까운 교차점이 없다고 확정할 수 있음
+      if (walker.exit_t() >= ray_t.max)
+      {
+        break;
+      }
+      walker.advance();
+    }
+
+    return hit_anything;
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    for (const auto &object : large_primitives)
+    {
+      if (object->occluded(r, ray_t))
+      {
+        return true;
+      }
+    }
+
+    grid_walker walker(*this, r, ray_t);
+    while (walker.valid())
+    {
+      for (uint32_t i = cell_start[walker.cell]; i < cell_start[walker.cell + 1]; i++)
+      {
+        if (primitives[cell_prims[i]]->occluded(r, ray_t))
+        {
+          return true;
+        }
+      }
+      if (walker.exit_t() >= ray_t.max)
+      {
+        break;
+      }
+      walker.advance();
+    }
+    return false;
+  };
+
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  /**
+   * 3D-DDA 로 광선이 지나가는 cell 을 순서대로 방문하는 반복자
+   *
+   * - t_next[axis] : 광선이 axis 축 방향으로 다음 cell 경계를 넘는 시점
+   * - t_delta[axis] : axis 축 방향으로 cell 하나를 가로지르는 데 걸리는 t 값
+   * -> 매 단계 t_next 가 가장 작은 축으로 한 cell 이동하면 광선이 지나가는 cell 을 빠짐없이 진행 순서대로 방문함
+   */
+  class grid_walker
+  {
+  public:
+    grid_walker(const uniform_grid &grid, const ray &r, interval ray_t) : grid(grid)
+    {
+      const traversal_ray tr(r);
+      double t_entry, t_exit;
+      if (grid.primitives.empty() || !grid.grid_bounds.hit(tr, ray_t, t_entry, t_exit))
+      {
+        cell = invalid_cell;
+        return;
+      }
+
+      // 격자 진입 지점이 속한 cell 좌표 (경계 위의 부동소수점 오차는 clamp 로 보정)
+      for (int axis = 0; axis < 3; axis++)
+      {
+        double p = tr.origin[axis] + t_entry * tr.direction[axis];
+        int c = static_cast<int>((p - grid.origin[axis]) / grid.cell_size[axis]);
+        index[axis] = c < 0 ? 0 : (c >= grid.resolution[axis] ? grid.resolution[axis] - 1 : c);
+
+        if (tr.direction[axis] == 0.0f)
+        {
+          // 이 축으로는 이동하지 않음
+          step[axis] = 0;
+          t_next[axis] = infinity;
+          t_delta[axis] = infinity;
+        }
+        else if (tr.sign[axis] == 0)
+        {
+          step[axis] = 1;
+          t_next[axis] = (grid.origin[axis] + (index[axis] + 1) * grid.cell_size[axis] - tr.origin[axis]) * tr.inv_dir[axis];
+          t_delta[axis] = grid.cell_size[axis] * tr.inv_dir[axis];
+        }
+        else
+        {
+          step[axis] = -1;
+          t_next[axis] = (grid.origin[axis] + index[axis] * grid.cell_size[axis] - tr.origin[axis]) * tr.inv_dir[axis];
+          t_delta[axis] = -grid.cell_size[axis] * tr.inv_dir[axis];
+        }
+      }
+      t_end = t_exit;
+      cell = grid.cell_index(index[0], index[1], index[2]);
+    };
+
+    bool valid() const { return cell != invalid_cell; };
+
+    // 현재 cell 을 빠져나가는 시점
+    double exit_t() const { return std::fmin(std::fmin(t_next[0], t_next[1]), t_next[2]); };
+
+    // t_next 가 가장 작은 축으로 한 cell 이동 (격자를 벗어나거나 광선 구간이 끝나면 종료)
+    void advance()
+    {
+      int axis = t_next[0] < t_next[1] ? (t_next[0] < t_next[2] ? 0 : 2) : (t_next[1] < t_next[2] ? 1 : 2);
+      if (t_next[axis] >= t_end)
+      {
+        cell = invalid_cell;
+        return;
+      }
+
+      index[axis] += step[axis];
+      if (index[axis] < 0 || index[axis] >= grid.resolution[axis])
+      {
+        cell = invalid_cell;
+        return;
+      }
+      t_next[axis] += t_delta[axis];
+      cell = grid.cell_index(index[0], index[1], index[2]);
+    };
+
+  public:
+    size_t cell; // 현재 cell 의 1차원 인덱스
+
+  private:
+    static const size_t invalid_cell = static_cast<size_t>(-1);
+
+    const uniform_grid &grid;
+    int index[3];      // 현재 cell 좌표
+    int step[3];       // 축별 이동 방향 (+1, -1, 0)
+    double t_next[3];  // 축별 다음 cell 경계 통과 시점
+    double t_delta[3]; // 축별 cell 하나를 가로지르는 t 간격
+    double t_end;      // 광선이 격자(또는 ray_t 구간)를 벗어나는 시점
+  };
+
+  static const int max_resolution = 256;           // 축 하나당 최대 cell 개수 (전체 cell 수 상한)
+  static constexpr double large_primitive_ratio = 0.5f; // AABB 대각선이 중심점 분포 대각선의 이 비율보다 큰 primitive 는 격자에서 제외
+
+  std::vector<std::shared_ptr<hittable>> primitives;       // 격자에 등록된 primitive
+  std::vector<std::shared_ptr<hittable>> large_primitives; // 격자 밖에서 항상 검사하는 큰 primitive
+  std::vector<uint32_t> cell_start;                        // cell i 의 primitive 목록 = cell_prims[cell_start[i], cell_start[i + 1])
+  std::vector<uint32_t> cell_prims;                        // 모든 cell 의 primitive 인덱스(primitives 기준)를 cell 순서대로 이어 붙인 배열
+  aabb grid_bounds;                                        // 격자가 덮는 영역 (large_primitives 제외)
+  aabb bbox;                                               // 전체 AABB
+  int resolution[3] = {0, 0, 0};                           // 축별 cell 개수
+  double origin[3] = {0.0f, 0.0f, 0.0f};                   // 격자 최소 꼭짓점
+  double cell_size[3] = {0.0f, 0.0f, 0.0f};                // 축별 cell 크기
+
+private:
+  size_t cell_index(int x, int y, int z) const
+  {
+    return (static_cast<size_t>(z) * resolution[1] + y) * resolution[0] + x;
+  };
+
+  // AABB 가 겹치는 모든 cell 에 대해 f(cell 인덱스) 호출
+  template <typename F>
+  void for_each_cell(const aabb &box, F f) const
+  {
+    int lo[3], hi[3];
+    for (int axis = 0; axis < 3; axis++)
+    {
+      const interval &extent = box.axis_interval(axis);
+      lo[axis] = clamp_cell(axis, (extent.min - origin[axis]) / cell_size[axis]);
+      hi[axis] = clamp_cell(axis, (extent.max - origin[axis]) / cell_size[axis]);
+    }
+    for (int z = lo[2]; z <= hi[2]; z++)
+    {
+      for (int y = lo[1]; y <= hi[1]; y++)
+      {
+        for (int x = lo[0]; x <= hi[0]; x++)
+        {
+          f(cell_index(x, y, z));
+        }
+      }
+    }
+  };
+
+  int clamp_cell(int axis, double c) const
+  {
+    int i = static_cast<int>(c);
+    return i < 0 ? 0 : (i >= resolution[axis] ? resolution[axis] - 1 : i);
+  };
+
+  static double diagonal(const aabb &box)
+  {
+    return std::sqrt(box.x.size() * box.x.size() + box.y.size() * box.y.size() + box.z.size() * box.z.size());
+  };
+};
+
+/**
+ * 균일 격자와 3D-DDA
+ *
+ *
+ * BVH 는 primitive 를 나누는 구조(object 분할)이고, 균일 격자는 공간을 같은 크기의 cell 로 나누는 구조(공간 분할)이다.
+ *
+ * ✅ 장점 : 빌드가 primitive 당 몇 번의 cell 등록으로 끝나 매우 빠르고,
+ *          순회가 트리 탐색 없이 '다음 cell 로 한 칸 이동' 의 반복이므로 스택이 필요 없다.
+ *          bouncing_spheres 의 22 x 22 sphere 배열처럼 크기가 비슷한 primitive 가 고르게 분포한 scene 에서 효율적이다.
+ * ⚠️ 단점 : 해상도가 scene 전체에 하나이므로, 빈 공간이 넓거나 primitive 밀도가 고르지 않은 scene(teapot in a stadium)에서는
+ *          빈 cell 을 많이 지나거나 cell 하나에 primitive 가 몰린다.
+ *          또한 primitive 하나가 여러 cell 에 등록되므로 같은 primitive 를 여러 번 검사할 수 있다.
+ *          (광선별 mailbox 로 중복 검사를 피할 수 있지만, 여러 thread 가 공유하는 가속 구조에 광선별 상태를 두어야 하므로 생략)
+ *
+ * 해상도는 Cleary / Wyman 등이 제안한 방식대로 cell 을 정육면체에 가깝게 유지하면서
+ * 전체 cell 개수가 primitive 개수의 grid_density 배가 되도록 축별 cell 개수를 정한다.
+ *
+ * 3D-DDA(Amanatides & Woo, "A Fast Voxel Traversal Algorithm for Ray Tracing") 는 광선이 각 축의 cell 경계를 넘는 시점(t_next)을 유지하면서,
+ * 가장 먼저 경계를 넘는 축으로 한 칸씩 이동하는 방식으로 광선이 지나가는 cell 을 진행 순서대로 방문한다.
+ * 각 단계는 비교 2번과 덧셈 1번뿐이므로 매우 저렴하다.
+ */
+
+#endif /* GRID_HPP */
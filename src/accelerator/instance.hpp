@@ -0,0 +1,157 @@
+#ifndef INSTANCE_HPP
+#define INSTANCE_HPP
+
+#include "accelerator.hpp"
+#include "common/transform.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+#include "hittable/transformed.hpp"
+
+#include <vector>
+
+/**
+ * BLAS(Bottom-Level Acceleration Structure) 클래스
+ *
+ * - 하나의 고유한 object 묶음(ex> 상자와 구 등 여러 primitive 로 구성된 소품)을
+ *   object 로컬 좌표계 기준으로 한 번만 BVH 로 구축해두는 클래스.
+ * - 여러 instance 가 같은 BLAS 를 shared_ptr 로 공유하므로, 반복되는 geometry 는 메모리에 한 벌만 존재한다.
+ * - 빌드 후에는 변경되지 않으므로 instance 들은 const BLAS 를 참조한다.
+ */
+class blas
+{
+public:
+  // 로컬 좌표계 기준 object 묶음으로 지정한 종류의 가속 구조를 구축
+  blas(const hittable_list &objects, accelerator_type type = accelerator_type::bvh_flat,
+       const bvh_build_options &options = bvh_build_options())
+      : root(make_accelerator(objects, type, options)), bbox(objects.bounding_box()), primitive_count(objects.objects.size()) {};
+
+public:
+  std::shared_ptr<hittable> root; // 로컬 좌표계 기준 가속 구조
+  aabb bbox;                      // 로컬 좌표계 기준 AABB
+  size_t primitive_count;         // BLAS 에 포함된 primitive 개수 (통계 출력용)
+};
+
+/**
+ * instance 클래스
+ *
+ * - 공유 BLAS 하나와 그 BLAS 를 월드 좌표계에 배치하는 아핀 변환(object_to_world)을 가지는 hittable.
+ * - 광선 역변환과 충돌 정보 복원은 BLAS 의 가속 구조를 감싼 transformed 에 그대로 맡긴다.
+ *   (instance 는 BLAS 공유와 배치 변경(set_transform)만 추가로 담당)
+ * - 월드 -> 로컬 역변환 행렬은 변환을 설정할 때 한 번만 계산해서 캐싱한다.
+ */
+class instance : public hittable
+{
+public:
+  instance(std::shared_ptr<const blas> geometry, const transform &object_to_world)
+      : geometry(geometry), placement(geometry->root, object_to_world) {};
+
+  // 월드 좌표계 배치 변환을 변경 (역변환 행렬과 월드 좌표계 AABB 를 다시 계산)
+  void set_transform(const transform &object_to_world)
+  {
+    placement = transformed(geometry->root, object_to_world);
+  };
+
+  // 현재 월드 좌표계 배치 변환 반환
+  const transform &object_to_world() const { return placement.object_to_world(); };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    return placement.hit(r, ray_t, rec);
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    return placement.occluded(r, ray_t);
+  };
+
+  // 월드 좌표계 기준 AABB 반환 (상위 TLAS 의 BVH 구축에 사용)
+  aabb bounding_box() const override { return placement.bounding_box(); };
+
+private:
+  std::shared_ptr<const blas> geometry; // 공유 BLAS
+  transformed placement;                // BLAS 가속 구조를 월드 좌표계에 배치한 변환 래퍼
+};
+
+/**
+ * TLAS(Top-Level Acceleration Structure) 클래스
+ *
+ * - instance 들의 월드 좌표계 AABB 위에 BVH 를 구축하는 상위 가속 구조.
+ * - instance 의 배치를 바꾸면(set_transform()) BLAS 는 그대로 두고 instance 개수만큼의 작은 TLAS 만 rebuild() 로 다시 구축한다.
+ * - add() / set_transform() 이후 렌더링 전에 반드시 rebuild() 를 호출해야 한다. (hit() 은 마지막으로 구축된 TLAS 를 사용)
+ */
+class tlas : public hittable
+{
+public:
+  tlas(accelerator_type type = accelerator_type::bvh_flat, const bvh_build_options &options = bvh_build_options())
+      : type(type), options(options) {};
+
+  // 공유 BLAS 를 object_to_world 변환으로 배치한 instance 를 추가하고, 그 instance 의 인덱스를 반환
+  size_t add(std::shared_ptr<const blas> geometry, const transform &object_to_world)
+  {
+    instances.push_back(std::make_shared<instance>(geometry, object_to_world));
+    return instances.size() - 1;
+  };
+
+  // index 번째 instance 의 배치 변환 변경 (rebuild() 호출 전까지 TLAS 에는 반영되지 않음)
+  void set_transform(size_t index, const transform &object_to_world)
+  {
+    instances[index]->set_transform(object_to_world);
+  };
+
+  // instance 들의 현재 월드 좌표계 AABB 로 TLAS 만 다시 구축 (BLAS 는 재사용)
+  void rebuild()
+  {
+    hittable_list list;
+    for (const auto &inst : instances)
+    {
+      list.add(inst);
+    }
+    top = make_accelerator(list, type, options);
+    bbox = list.bounding_box();
+  };
+
+  // 추가된 instance 개수 반환
+  size_t instance_count() const { return instances.size(); };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    return top && top->hit(r, ray_t, rec);
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    return top && top->occluded(r, ray_t);
+  };
+
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  std::vector<std::shared_ptr<instance>> instances; // TLAS 에 배치된 instance 목록
+  std::shared_ptr<hittable> top;                    // instance 들로 구축한 상위 가속 구조
+  accelerator_type type;                            // 상위 가속 구조 종류
+  bvh_build_options options;                        // 상위 가속 구조 빌드 옵션
+  aabb bbox;                                        // 전체 instance 를 감싸는 월드 좌표계 AABB
+};
+
+/**
+ * 2단계 가속 구조 (TLAS / BLAS)
+ *
+ *
+ * 같은 모양의 소품(ex> 상자, 나무, 의자)이 수천 개 반복되는 scene 을 단일 BVH 로 구성하면,
+ * 소품 하나마다 primitive 들을 새로 생성해야 하므로 메모리 사용량과 BVH 빌드 시간이 '소품 개수 x 소품당 primitive 수' 에 비례한다.
+ * 또한 소품 하나만 움직여도 전체 BVH 를 다시 빌드해야 한다.
+ *
+ * 2단계 구조에서는 이를 두 계층으로 분리한다:
+ *
+ * 1. BLAS : 고유한 geometry 마다 로컬 좌표계 기준 BVH 를 한 번만 구축 (instance 들이 공유)
+ * 2. TLAS : 각 instance 의 월드 좌표계 AABB(BLAS AABB 를 아핀 변환한 AABB) 위에 구축한 작은 BVH
+ *
+ * 광선 순회 시에는 TLAS 에서 후보 instance 를 찾고, 광선을 그 instance 의 로컬 좌표계로 역변환한 뒤 BLAS 를 순회한다.
+ *
+ * ✅ 메모리 : geometry 한 벌 + instance 개수 x (변환 행렬 2개 + AABB)
+ * ✅ 갱신 : instance 를 움직이면 BLAS 는 그대로 두고 instance 개수 규모의 TLAS 만 다시 구축
+ * ⚠️ 비용 : instance 진입마다 광선 변환(3x4 행렬 곱 2번)이 추가되고,
+ *          회전된 instance 의 월드 AABB 는 원래보다 느슨해지므로 TLAS 의 컬링 효율이 단일 BVH 보다 다소 떨어질 수 있다.
+ */
+
+#endif /* INSTANCE_HPP */
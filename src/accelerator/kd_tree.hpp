@@ -0,0 +1,427 @@
+#ifndef KD_TREE_HPP
+#define KD_TREE_HPP
+
+#include "aabb.hpp"
+#include "bvh_build.hpp"
+#include "bvh_stats.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * kd-tree 노드
+ *
+ * - 내부 노드: axis 축의 split 평면으로 공간을 둘로 나누며, 아래쪽(below) 자식은 배열에서 바로 다음 위치(index + 1)에,
+ *   위쪽(above) 자식은 offset 위치에 있다.
+ * - 리프 노드(axis == 3): kd_tree::prim_refs 의 [offset, offset + count) 범위를 참조한다.
+ */
+class kd_tree_node
+{
+public:
+  double split;    // 내부 노드의 분할 평면 좌표
+  uint32_t offset; // 내부 노드: 위쪽 자식 노드 인덱스 / 리프 노드: prim_refs 내 첫 번째 primitive 위치
+  uint32_t count;  // 리프 노드의 primitive 개수
+  int axis;        // 분할 축 (0: x, 1: y, 2: z, 3: 리프 노드)
+
+  bool is_leaf() const { return axis == 3; };
+};
+
+/**
+ * SAH kd-tree 가속 구조 클래스
+ *
+ * - 노드마다 x, y, z 축의 primitive AABB 경계(event)들을 정렬하고 모든 경계 위치에서 SAH 비용을 계산하여 분할 평면을 고른다.
+ *   (bvh_builder 의 binning 과 달리 후보 평면을 근사하지 않음, O(N log^2 N) 빌드)
+ * - BVH 와 달리 두 자식의 공간이 겹치지 않으며, 분할 평면에 걸친 primitive 는 양쪽 자식에 모두 등록된다.
+ * - 순회는 광선 구간 [t_min, t_max] 를 분할 평면에서 잘라 가까운 자식부터 방문하며,
+ *   앞쪽 리프에서 찾은 교차점이 남은 구간보다 가까우면 바로 종료한다. (하단 필기 참고)
+ */
+class kd_tree : public hittable
+{
+public:
+  kd_tree(hittable_list list, const bvh_build_options &options = bvh_build_options())
+      : primitives(list.objects), bbox(list.bounding_box()),
+        traversal_cost(options.traversal_cost), intersection_cost(options.intersection_cost)
+  {
+    auto build_start = std::chrono::high_resolution_clock::now();
+    if (primitives.empty())
+    {
+      return;
+    }
+
+    // 트리 최대 깊이: 8 + 1.3 log2(N) (pbrt 의 경험식), 순회 스택 크기와 옵션의 max_depth 를 넘지 않도록 제한
+    max_depth = static_cast<int>(std::round(8 + 1.3f * std::log2(double(primitives.size()))));
+    max_depth = std::min(max_depth, std::min(options.max_depth, stack_capacity));
+
+    prim_bounds.reserve(primitives.size());
+    std::vector<uint32_t> prims(primitives.size());
+    for (size_t i = 0; i < primitives.size(); i++)
+    {
+      prim_bounds.push_back(primitives[i]->bounding_box());
+      prims[i] = static_cast<uint32_t>(i);
+    }
+    build(bbox, prims, 0, 0);
+
+    if (options.report_timings)
+    {
+      auto build_end = std::chrono::high_resolution_clock::now();
+      printf("kd-tree build: %zu prims (%zu references) -> %zu nodes | total %.2f ms\n",
+             primitives.size(), prim_refs.size(), nodes.size(),
+             std::chrono::duration<double, std::milli>(build_end - build_start).count());
+    }
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    const traversal_ray tr(r);
+    double t_min, t_max;
+    if (nodes.empty() || !bbox.hit(tr, ray_t, t_min, t_max))
+    {
+      return false;
+    }
+
+    // 나중에 방문할 먼 자식 노드와 그 노드에 해당하는 광선 구간을 쌓아두는 스택
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    uint32_t current = 0;
+    bool hit_anything = false;
+
+    while (true)
+    {
+      // 지금까지 찾은 가장 가까운 교차점이 현재 노드 구간보다 앞에 있으면 남은 노드는 모두 더 멀리 있으므로 종료
+      if (ray_t.max < t_min)
+      {
+        break;
+      }
+
+      const kd_tree_node &node = nodes[current];
+      if (!node.is_leaf())
+      {
+        descend(tr, node, current, t_min, t_max, stack, stack_size);
+        continue;
+      }
+
+      // 리프 노드: 등록된 primitive 들과 교차 검사 (분할 평면에 걸친 primitive 는 리프 구간 밖의 교차점을 반환할 수 있음)
+      for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+      {
+        if (primitives[prim_refs[i]]->hit(r, ray_t, rec))
+        {
+          hit_anything = true;
+          ray_t.max = rec.t;
+        }
+      }
+
+      if (stack_size == 0)
+      {
+        break;
+      }
+      const stack_entry &entry = stack[--stack_size];
+      current = entry.index;
+      t_min = entry.t_min;
+      t_max = entry.t_max;
+    }
+
+    return hit_anything;
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    const traversal_ray tr(r);
+    double t_min, t_max;
+    if (nodes.empty() || !bbox.hit(tr, ray_t, t_min, t_max))
+    {
+      return false;
+    }
+
+    stack_entry stack[stack_capacity];
+    int stack_size = 0;
+    uint32_t current = 0;
+
+    while (true)
+    {
+      const kd_tree_node &node = nodes[current];
+      if (!node.is_leaf())
+      {
+        descend(tr, node, current, t_min, t_max, stack, stack_size);
+        continue;
+      }
+
+      for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+      {
+        if (primitives[prim_refs[i]]->occluded(r, ray_t))
+        {
+          return true;
+        }
+      }
+
+      if (stack_size == 0)
+      {
+        break;
+      }
+      const stack_entry &entry = stack[--stack_size];
+      current = entry.index;
+      t_min = entry.t_min;
+      t_max = entry.t_max;
+    }
+    return false;
+  };
+
+  // 트리 품질 통계 수집 (bvh_stats.hpp 참고, kd-tree 는 형제 노드 공간이 겹치지 않으므로 overlap 은 항상 0)
+  bvh_stats stats(double traversal_cost = 1.0f, double intersection_cost = 1.0f) const
+  {
+    bvh_stats result(traversal_cost, intersection_cost);
+    if (!nodes.empty())
+    {
+      collect_stats(result, 0, bbox, 0);
+    }
+    return result;
+  };
+
+  aabb bounding_box() const override { return bbox; };
+
+private:
+  // 순회 스택 원소: 나중에 방문할 노드 인덱스와 그 노드 안에서의 광선 구간
+  struct stack_entry
+  {
+    uint32_t index;
+    double t_min;
+    double t_max;
+  };
+
+  // 빌드 중 정렬하는 primitive AABB 경계 (분할 평면 후보)
+  struct bound_edge
+  {
+    double t;      // 경계 좌표
+    uint32_t prim; // primitive 인덱스
+    bool is_end;   // false: AABB 시작(min) 경계, true: AABB 끝(max) 경계
+
+    // 좌표 순으로 정렬하되, 같은 좌표에서는 시작 경계를 먼저 둠 (두께 0 인 primitive 가 평면 양쪽에 모두 세어지지 않도록)
+    bool operator<(const bound_edge &other) const
+    {
+      return t != other.t ? t < other.t : (!is_end && other.is_end);
+    };
+  };
+
+  static const int stack_capacity = 64;           // 순회 스택 크기 (= 허용하는 트리 최대 깊이)
+  static constexpr double empty_bonus = 0.5f;     // 한쪽 자식이 빈 공간인 분할의 SAH 비용 할인 비율
+  static const int max_bad_refines = 3;           // 분할 비용이 리프 비용보다 높아도 계속 분할을 시도하는 최대 횟수 (경로 누적)
+
+  std::vector<kd_tree_node> nodes;                   // 깊이 우선 순서로 나열된 노드 배열
+  std::vector<uint32_t> prim_refs;                   // 리프 노드들이 참조하는 primitive 인덱스 (여러 리프에 중복 등록될 수 있음)
+  std::vector<std::shared_ptr<hittable>> primitives; // 원래 순서 그대로의 primitive 배열
+  std::vector<aabb> prim_bounds;                     // 빌드 중 사용하는 primitive AABB (빌드 후 해제)
+  aabb bbox;                                         // 루트 노드 공간 (전체 primitive AABB)
+  double traversal_cost;
+  double intersection_cost;
+  int max_depth = 0;
+
+private:
+  // 내부 노드에서 광선 구간을 분할 평면으로 잘라 가까운 자식으로 이동하고, 먼 자식도 방문해야 하면 스택에 보관
+  static void descend(const traversal_ray &tr, const kd_tree_node &node, uint32_t &current,
+                      double &t_min, double &t_max, stack_entry *stack, int &stack_size)
+  {
+    int axis = node.axis;
+    double t_plane = (node.split - tr.origin[axis]) * tr.inv_dir[axis];
+
+    // 광선 출발점이 평면 아래쪽에 있으면(평면 위에 있으면 진행 방향 기준) 아래쪽 자식이 가까운 자식
+    bool below_first = tr.origin[axis] < node.split || (tr.origin[axis] == node.split && tr.direction[axis] <= 0.0f);
+    uint32_t near_child = below_first ? current + 1 : node.offset;
+    uint32_t far_child = below_first ? node.offset : current + 1;
+
+    if (t_plane != t_plane)
+    {
+      // 광선이 평면 위에서 평면과 평행하게 진행하는 경우 (0 * inf = NaN) -> 평면에 닿은 primitive 가 어느 쪽에 있을지 모르므로 양쪽 모두 방문
+      stack[stack_size++] = stack_entry{far_child, t_min, t_max};
+      current = near_child;
+    }
+    else if (t_plane > t_max || t_plane <= 0.0f)
+    {
+      // 현재 구간 안에서 평면을 넘지 않음 -> 가까운 자식만 방문
+      current = near_child;
+    }
+    else if (t_plane < t_min)
+    {
+      // 구간 시작 전에 이미 평면을 넘음 -> 먼 자식만 방문
+      current = far_child;
+    }
+    else
+    {
+      // 구간이 평면에서 나뉨 -> 가까운 자식 [t_min, t_plane] 을 먼저, 먼 자식 [t_plane, t_max] 는 나중에 방문
+      stack[stack_size++] = stack_entry{far_child, t_plane, t_max};
+      current = near_child;
+      t_max = t_plane;
+    }
+  };
+
+  // bounds 공간과 그 공간에 걸친 primitive 목록(prims)으로 노드를 만들고, 필요하면 재귀적으로 분할
+  void build(const aabb &bounds, std::vector<uint32_t> &prims, int depth, int bad_refines)
+  {
+    size_t node_index = nodes.size();
+    nodes.push_back(kd_tree_node());
+
+    size_t count = prims.size();
+    if (count <= 1 || depth >= max_depth)
+    {
+      make_leaf(nodes[node_index], prims);
+      return;
+    }
+
+    // 1. 세 축의 모든 AABB 경계 위치에서 SAH 비용을 계산하여 가장 저렴한 분할 평면 선택
+    double leaf_cost = intersection_cost * count;
+    double best_cost = infinity;
+    int best_axis = -1;
+    double best_split = 0.0f;
+    double total_area = bounds.surface_area();
+    std::vector<bound_edge> edges(2 * count);
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+      sort_edges(prims, axis, edges);
+      const interval &extent = bounds.axis_interval(axis);
+
+      // 경계를 좌표 순으로 훑으면서 평면 아래/위에 걸친 primitive 수를 갱신
+      size_t below = 0, above = count;
+      for (const auto &edge : edges)
+      {
+        if (edge.is_end)
+        {
+          above--;
+        }
+        if (edge.t > extent.min && edge.t < extent.max)
+        {
+          double below_area = split_bounds(bounds, axis, extent.min, edge.t).surface_area();
+          double above_area = split_bounds(bounds, axis, edge.t, extent.max).surface_area();
+          double bonus = (below == 0 || above == 0) ? empty_bonus : 0.0f;
+          double cost = traversal_cost +
+                        intersection_cost * (1.0f - bonus) * (below_area * below + above_area * above) / total_area;
+          if (cost < best_cost)
+          {
+            best_cost = cost;
+            best_axis = axis;
+            best_split = edge.t;
+          }
+        }
+        if (!edge.is_end)
+        {
+          below++;
+        }
+      }
+    }
+
+    // 2. 분할 비용이 리프 비용보다 높으면 bad refine 으로 기록 (몇 번은 더 분할해보면 아래 단계에서 좋은 분할이 나올 수 있음)
+    if (best_cost > leaf_cost)
+    {
+      bad_refines++;
+    }
+    if (best_axis < 0 || (best_cost > 4.0f * leaf_cost && count < 16) || bad_refines >= max_bad_refines)
+    {
+      make_leaf(nodes[node_index], prims);
+      return;
+    }
+
+    // 3. 선택한 평면 기준으로 primitive 분류: 평면 아래에서 시작하면 아래쪽, 평면 위에서 끝나면 위쪽 (둘 다이면 양쪽 모두)
+    std::vector<uint32_t> below_prims, above_prims;
+    for (uint32_t prim : prims)
+    {
+      const interval &extent = prim_bounds[prim].axis_interval(best_axis);
+      if (extent.min < best_split || (extent.min == best_split && extent.max == best_split))
+      {
+        below_prims.push_back(prim);
+      }
+      if (extent.max > best_split)
+      {
+        above_prims.push_back(prim);
+      }
+    }
+    std::vector<uint32_t>().swap(prims); // 자식 목록으로 나눈 뒤에는 현재 노드의 목록이 필요 없으므로 메모리 해제
+
+    const interval &extent = bounds.axis_interval(best_axis);
+    nodes[node_index].axis = best_axis;
+    nodes[node_index].split = best_split;
+    build(split_bounds(bounds, best_axis, extent.min, best_split), below_prims, depth + 1, bad_refines);
+    nodes[node_index].offset = static_cast<uint32_t>(nodes.size());
+    build(split_bounds(bounds, best_axis, best_split, extent.max), above_prims, depth + 1, bad_refines);
+
+    if (node_index == 0)
+    {
+      std::vector<aabb>().swap(prim_bounds);
+    }
+  };
+
+  // prims 의 axis 축 AABB 시작/끝 경계를 edges 에 채우고 정렬
+  void sort_edges(const std::vector<uint32_t> &prims, int axis, std::vector<bound_edge> &edges) const
+  {
+    for (size_t i = 0; i < prims.size(); i++)
+    {
+      const interval &extent = prim_bounds[prims[i]].axis_interval(axis);
+      edges[2 * i] = bound_edge{extent.min, prims[i], false};
+      edges[2 * i + 1] = bound_edge{extent.max, prims[i], true};
+    }
+    std::sort(edges.begin(), edges.end());
+  };
+
+  void make_leaf(kd_tree_node &node, const std::vector<uint32_t> &prims)
+  {
+    node.axis = 3;
+    node.split = 0.0f;
+    node.offset = static_cast<uint32_t>(prim_refs.size());
+    node.count = static_cast<uint32_t>(prims.size());
+    prim_refs.insert(prim_refs.end(), prims.begin(), prims.end());
+  };
+
+  // bounds 의 axis 축 범위를 [lo, hi] 로 바꾼 공간
+  static aabb split_bounds(const aabb &bounds, int axis, double lo, double hi)
+  {
+    interval x = bounds.x, y = bounds.y, z = bounds.z;
+    (axis == 0 ? x : (axis == 1 ? y : z)) = interval(lo, hi);
+    aabb result;
+    result.x = x;
+    result.y = y;
+    result.z = z;
+    return result;
+  };
+
+  // index 번째 노드부터 깊이 우선으로 방문하며 통계 누적 (노드 공간은 부모 공간을 분할 평면으로 잘라서 계산)
+  void collect_stats(bvh_stats &result, uint32_t index, const aabb &bounds, int depth) const
+  {
+    const kd_tree_node &node = nodes[index];
+    if (node.is_leaf())
+    {
+      result.add_leaf(bounds, depth, node.count);
+      return;
+    }
+
+    const interval &extent = bounds.axis_interval(node.axis);
+    aabb children[2] = {split_bounds(bounds, node.axis, extent.min, node.split),
+                        split_bounds(bounds, node.axis, node.split, extent.max)};
+    result.add_interior(bounds, depth, children, 2);
+    collect_stats(result, index + 1, children[0], depth + 1);
+    collect_stats(result, node.offset, children[1], depth + 1);
+  };
+};
+
+/**
+ * SAH kd-tree
+ *
+ *
+ * kd-tree 는 축 정렬 평면으로 공간을 재귀적으로 둘로 나누는 공간 분할 구조이다.
+ * BVH 와 비교하면 다음과 같은 차이가 있다.
+ *
+ * ✅ 두 자식 공간이 겹치지 않으므로, 광선 구간을 평면에서 잘라 앞쪽 자식부터 방문하면 항상 엄밀한 front-to-back 순서가 된다.
+ *    -> 앞쪽 리프에서 교차점을 찾으면 (그 교차점이 리프 구간 안에 있는 한) 뒤쪽 노드는 AABB 검사 없이 모두 건너뛴다.
+ * ✅ 빈 공간을 잘라내는 분할(empty_bonus)을 선호하므로 primitive 주변을 촘촘하게 감싼다.
+ * ⚠️ 평면에 걸친 primitive 가 양쪽에 복제되므로 참조 수와 메모리가 늘고, 같은 primitive 를 여러 리프에서 다시 검사할 수 있다.
+ * ⚠️ 평면을 경계 위치마다 정확히 평가하기 위한 정렬 때문에 빌드가 BVH binning 보다 느리다.
+ *
+ * 분할 비용은 pbrt 와 같은 형태로 계산한다.
+ *
+ *   cost = C_trav + C_isect * (1 - empty_bonus) * (SA(below) * N_below + SA(above) * N_above) / SA(node)
+ *
+ * 분할 비용이 리프 비용(C_isect * N)보다 높은 분할도 경로마다 max_bad_refines 번까지는 허용하는데,
+ * 당장은 손해인 분할이 아래 단계에서 좋은 분할로 이어지는 경우가 있기 때문이다.
+ */
+
+#endif /* KD_TREE_HPP */
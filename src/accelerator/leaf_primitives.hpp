@@ -0,0 +1,228 @@
+#ifndef LEAF_PRIMITIVES_HPP
+#define LEAF_PRIMITIVES_HPP
+
+#include "hittable/box.hpp"
+#include "hittable/hittable.hpp"
+#include "hittable/quad.hpp"
+#include "hittable/sphere.hpp"
+
+#include <cstdint>
+#include <typeinfo>
+#include <vector>
+
+/**
+ * BVH 리프 노드가 참조하는 primitive 배열 (타입별 연속 저장)
+ *
+ * - primitive 를 shared_ptr<hittable> 배열 대신, 구체 타입(sphere, quad, axis_aligned_box)별 값 배열에 리프 순서대로 복사해서 저장한다.
+ *   -> 같은 리프의 primitive 들이 타입별 배열에서 서로 인접하므로, 리프 방문 시 포인터를 따라 힙 곳곳을 읽지 않는다.
+ * - slots 배열은 리프 범위 [first, first + count) 의 각 primitive 가 어느 타입 배열의 몇 번째 원소인지 가리키며,
+ *   교차 검사는 타입 태그로 분기한 뒤 가상 함수가 아닌 sphere::intersect() / quad::intersect() 등을 직접 호출한다. (인라인 가능)
+ * - sphere, quad, axis_aligned_box 가 아닌 primitive(하위 클래스, hittable_list, instance 등)는 기존처럼 shared_ptr 로 보관하고 가상 함수로 검사한다.
+ */
+class leaf_primitives
+{
+public:
+  // primitive 하나를 리프 순서의 끝에 추가
+  void add(const std::shared_ptr<hittable> &object)
+  {
+    // 하위 클래스가 hit() 을 재정의했을 수 있으므로 정확히 sphere / quad / axis_aligned_box 타입인 경우에만 값으로 복사
+    const hittable &p = *object;
+    if (typeid(p) == typeid(sphere))
+    {
+      slots.push_back(slot{sphere_slot, static_cast<uint32_t>(spheres.size())});
+      spheres.push_back(static_cast<const sphere &>(p));
+    }
+    else if (typeid(p) == typeid(quad))
+    {
+      slots.push_back(slot{quad_slot, static_cast<uint32_t>(quads.size())});
+      quads.push_back(static_cast<const quad &>(p));
+    }
+    else if (typeid(p) == typeid(axis_aligned_box))
+    {
+      slots.push_back(slot{box_slot, static_cast<uint32_t>(boxes.size())});
+      boxes.push_back(static_cast<const axis_aligned_box &>(p));
+    }
+    else
+    {
+      slots.push_back(slot{generic_slot, static_cast<uint32_t>(others.size())});
+      others.push_back(object);
+    }
+  };
+
+  void reserve(size_t count) { slots.reserve(count); };
+
+  void clear()
+  {
+    slots.clear();
+    spheres.clear();
+    quads.clear();
+    boxes.clear();
+    others.clear();
+  };
+
+  bool empty() const { return slots.empty(); };
+  size_t size() const { return slots.size(); };
+
+  // [first, first + count) 범위의 primitive 들과 교차 검사하며 가장 가까운 교차점으로 ray_t.max 를 좁혀나감 (충돌 정보까지 기록)
+  bool hit(uint32_t first, uint32_t count, const ray &r, interval &ray_t, hit_record &rec) const
+  {
+    uint32_t closest;
+    if (!intersect(first, count, r, ray_t, rec, closest))
+    {
+      return false;
+    }
+    finalize(closest, r, ray_t.max, rec);
+    return true;
+  };
+
+  /**
+   * [first, first + count) 범위의 primitive 들과 교차 검사하며 가장 가까운 교차점으로 ray_t.max 를 좁혀나가고,
+   * 그 primitive 의 리프 순서 인덱스를 closest 에 기록 (하단 필기 '교차 t 탐색과 충돌 정보 계산의 분리' 참고)
+   * → sphere / quad / axis_aligned_box 는 t 만 계산하며, 충돌 정보는 순회가 끝난 뒤 finalize() 로 한 번만 계산한다.
+   * → 그 밖의 primitive 는 hit() 으로 rec 에 바로 기록한다. (finalize() 에서는 아무것도 하지 않음)
+   */
+  bool intersect(uint32_t first, uint32_t count, const ray &r, interval &ray_t, hit_record &rec, uint32_t &closest) const
+  {
+    bool hit_anything = false;
+    for (uint32_t i = first; i < first + count; i++)
+    {
+      const slot &s = slots[i];
+      bool hit_this;
+      double t;
+      switch (s.type)
+      {
+      case sphere_slot:
+        hit_this = spheres[s.index].intersect(r, ray_t, t);
+        break;
+      case quad_slot:
+        hit_this = quads[s.index].intersect(r, ray_t, t);
+        break;
+      case box_slot:
+        hit_this = boxes[s.index].intersect(r, ray_t, t);
+        break;
+      default:
+        hit_this = others[s.index]->hit(r, ray_t, rec);
+        t = rec.t;
+        break;
+      }
+      if (hit_this)
+      {
+        hit_anything = true;
+        ray_t.max = t;
+        closest = i;
+      }
+    }
+    return hit_anything;
+  };
+
+  // intersect() 로 찾은 가장 가까운 primitive(리프 순서 인덱스 closest) 하나에 대해서만 교차점, normal, uv, material 을 rec 에 기록
+  void finalize(uint32_t closest, const ray &r, double t, hit_record &rec) const
+  {
+    const slot &s = slots[closest];
+    switch (s.type)
+    {
+    case sphere_slot:
+      spheres[s.index].finalize(r, t, rec);
+      break;
+    case quad_slot:
+      quads[s.index].finalize(r, t, rec);
+      break;
+    case box_slot:
+      boxes[s.index].finalize(r, t, rec);
+      break;
+    default:
+      break; // intersect() 에서 이미 hit() 으로 기록됨
+    }
+  };
+
+  // [first, first + count) 범위의 primitive 중 하나라도 ray_t 구간에서 교차하면 true 반환
+  bool occluded(uint32_t first, uint32_t count, const ray &r, interval ray_t) const
+  {
+    for (uint32_t i = first; i < first + count; i++)
+    {
+      const slot &s = slots[i];
+      bool blocked;
+      switch (s.type)
+      {
+      case sphere_slot:
+        blocked = spheres[s.index].sphere::occluded(r, ray_t);
+        break;
+      case quad_slot:
+        blocked = quads[s.index].quad::occluded(r, ray_t);
+        break;
+      case box_slot:
+        blocked = boxes[s.index].axis_aligned_box::occluded(r, ray_t);
+        break;
+      default:
+        blocked = others[s.index]->occluded(r, ray_t);
+        break;
+      }
+      if (blocked)
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+private:
+  enum slot_type : uint32_t
+  {
+    sphere_slot,
+    quad_slot,
+    box_slot,
+    generic_slot,
+  };
+
+  // 리프 순서의 primitive 하나: 타입 태그 + 타입별 배열 내 인덱스
+  struct slot
+  {
+    uint32_t type;
+    uint32_t index;
+  };
+
+  std::vector<slot> slots;                     // 리프 범위 순서대로 나열된 primitive 위치
+  std::vector<sphere> spheres;                 // sphere 값 배열 (리프 순서)
+  std::vector<quad> quads;                     // quad 값 배열 (리프 순서)
+  std::vector<axis_aligned_box> boxes;         // axis_aligned_box 값 배열 (리프 순서)
+  std::vector<std::shared_ptr<hittable>> others; // 그 밖의 primitive (가상 함수로 검사)
+};
+
+/**
+ * 리프 primitive 의 타입별 연속 저장
+ *
+ *
+ * shared_ptr<hittable> 배열로 primitive 를 저장하면 리프 하나를 방문할 때마다
+ * 1. 배열에서 포인터를 읽고, 2. 힙 어딘가에 따로 할당된 객체로 이동해서 vtable 포인터를 읽고, 3. 간접 호출로 hit() 에 진입한다.
+ * primitive 마다 할당 위치가 제각각이므로 캐시 미스가 잦고, 간접 호출은 인라인될 수 없어 호출 비용과 분기 예측 실패가 누적된다.
+ *
+ * 리프 순서대로 타입별 값 배열에 복사해두면
+ * ✅ 같은 리프의 sphere 들은 sphere 배열에서 바로 붙어 있으므로 연속된 캐시 라인에서 읽히고,
+ * ✅ 타입 태그 분기 후 sphere::hit() 처럼 한정된 이름으로 호출하면 가상 함수 디스패치 없이 직접 호출(인라인 가능)된다.
+ * ⚠️ primitive 를 값으로 복사하므로 원래 scene 객체를 나중에 수정해도 가속 구조에는 반영되지 않는다. (가속 구조를 다시 빌드해야 함)
+ *
+ * 리프에 몇 개의 primitive 를 담을지는 여전히 bvh_builder 의 SAH 비용 모델(traversal_cost, intersection_cost)과 max_leaf_size 가 결정한다.
+ */
+
+/**
+ * 교차 t 탐색과 충돌 정보 계산의 분리
+ *
+ *
+ * 가장 가까운 교차점을 찾는 동안 BVH 는 광선이 지나는 여러 리프의 primitive 를 검사하고, 더 가까운 교차점이 발견될 때마다 ray_t.max 를 좁힌다.
+ * 이때 primitive::hit() 은 교차할 때마다 교차점 좌표, normal(front_face 판정 포함), uv, material 까지 모두 계산하는데,
+ * 이 후보 교차점들 대부분은 나중에 더 가까운 교차점에 의해 덮어써지므로 최종적으로 쓰이는 것은 마지막 하나뿐이다.
+ * (ex> sphere 의 uv 계산은 acos + atan2, quad 의 uv 계산은 외적 두 번)
+ *
+ * 그래서 교차 검사를 두 단계로 나눈다:
+ *
+ * 1. intersect() : 유효 구간 내 가장 가까운 교차점의 t 만 계산 (순회 중 후보마다 호출)
+ *    → leaf_primitives 는 t 로 ray_t.max 를 좁히고 그 primitive 의 리프 순서 인덱스만 기억한다.
+ * 2. finalize()  : 순회가 끝난 뒤 기억해둔 primitive 하나에 대해서만 교차점, normal, front_face, uv, material 계산
+ *
+ * ✅ 광선당 충돌 정보 계산이 '교차 후보 수' 번에서 1 번으로 줄어든다. (triangle_mesh / sphere_set 내부 순회와 같은 방식)
+ * ✅ primitive::hit() 은 intersect() + finalize() 로 구현되어 있으므로, 단독으로 사용할 때의 결과도 이전과 동일하다.
+ * ⚠️ finalize() 는 intersect() 와 같은 광선, 같은 t 로 호출해야 한다. (quad 는 α, β 를, box 는 slab test 를 다시 계산하여 같은 값을 얻음)
+ * ⚠️ 전용 slot 이 없는 primitive(generic slot)는 여전히 hit() 으로 후보마다 충돌 정보를 기록한다.
+ */
+
+#endif /* LEAF_PRIMITIVES_HPP */
@@ -0,0 +1,155 @@
+#ifndef ACCELERATOR_BENCH_HPP
+#define ACCELERATOR_BENCH_HPP
+
+#include "common/rtweekend.hpp"
+#include "accelerator/accelerator.hpp"
+#include "core/camera.hpp"
+#include "hittable/hittable_list.hpp"
+
+#include <chrono>
+#include <vector>
+
+/**
+ * 가속 구조 비교 벤치마크
+ *
+ * - 각 built-in scene 을 모든 가속 구조 종류(accelerator_type)로 빌드하고, 같은 광선 집합에 대한 빌드 시간과 순회 속도를 측정한다.
+ * - 광선 집합은 scene 카메라의 primary ray(pinhole)와, primary ray 교차 지점에서 무작위 방향으로 튕겨나가는 secondary ray 로 구성한다.
+ *   (coherent 한 primary ray 와 incoherent 한 secondary ray 에서 가속 구조별 유불리가 다를 수 있으므로 함께 측정)
+ * - 가속 구조 없이(none) 구한 교차 결과와 교차 개수 및 t 합계를 비교해서, 결과가 다르면 MISMATCH 로 표시한다.
+ */
+
+// scene 의 world 와 camera 파라미터를 채우는 함수 (main.cpp 의 scene 함수들)
+typedef void (*scene_setup)(hittable_list &world, camera &cam);
+
+// 벤치마크 대상 scene (이름 + scene 구성 함수)
+class bench_scene
+{
+public:
+  const char *name;
+  scene_setup setup;
+};
+
+// 가속 구조 하나로 광선 집합 전체를 repeat 번 순회하는 데 걸린 시간(초) 측정 (교차 개수와 t 합계는 검증용으로 출력)
+inline double accelerator_trace_seconds(const hittable &world, const std::vector<ray> &rays, int repeat, size_t &hit_count, double &t_sum)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++)
+  {
+    hit_count = 0;
+    t_sum = 0.0f;
+    for (const auto &ray : rays)
+    {
+      hit_record rec;
+      if (world.hit(ray, interval(0.001f, infinity), rec))
+      {
+        hit_count++;
+        t_sum += rec.t;
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+};
+
+// scene 카메라 파라미터로 width x height 개의 pinhole primary ray 와, 그 교차 지점에서의 diffuse secondary ray 생성
+inline std::vector<ray> accelerator_bench_rays(const hittable_list &world, const camera &cam, int width)
+{
+  int height = std::max(1, static_cast<int>(width / cam.aspect_ratio));
+
+  // camera::initialize() 와 같은 방식으로 viewport 기저 계산 (defocus blur 는 무시)
+  vec3 w = unit_vector(cam.lookfrom - cam.lookat);
+  vec3 u = unit_vector(cross(cam.vup, w));
+  vec3 v = cross(w, u);
+  double viewport_height = 2.0f * std::tan(degrees_to_radians(cam.vfov) / 2.0f);
+  double viewport_width = viewport_height * (double(width) / height);
+
+  std::vector<ray> rays;
+  rays.reserve(2 * width * height);
+  for (int j = 0; j < height; j++)
+  {
+    for (int i = 0; i < width; i++)
+    {
+      double s = (i + random_double()) / width - 0.5f;
+      double t = 0.5f - (j + random_double()) / height;
+      vec3 direction = s * viewport_width * u + t * viewport_height * v - w;
+      rays.push_back(ray(cam.lookfrom, direction, random_double()));
+    }
+  }
+
+  // secondary ray: primary ray 교차 지점에서 노멀 주변 코사인 분포 방향 (lambertian 산란과 같은 분포)
+  size_t primary_count = rays.size();
+  for (size_t i = 0; i < primary_count; i++)
+  {
+    hit_record rec;
+    if (world.hit(rays[i], interval(0.001f, infinity), rec))
+    {
+      vec3 direction = rec.normal + random_unit_vector();
+      if (direction.near_zero())
+      {
+        direction = rec.normal;
+      }
+      rays.push_back(ray(rec.p, direction, rays[i].time()));
+    }
+  }
+  return rays;
+};
+
+// 모든 scene 에 대해 모든 가속 구조의 빌드 시간과 순회 속도를 측정하여 표로 출력
+inline void accelerator_benchmark(const std::vector<bench_scene> &scenes)
+{
+  const accelerator_type types[] = {accelerator_type::none, accelerator_type::bvh_tree, accelerator_type::bvh_flat,
+                                    accelerator_type::bvh_wide, accelerator_type::bvh_quantized, accelerator_type::bvh_motion,
+                                    accelerator_type::grid, accelerator_type::kd_tree};
+  const int repeat = 4;
+
+  bvh_build_options options; // 기본 옵션 (통계/시간 출력 없이 측정)
+
+  for (const auto &scene : scenes)
+  {
+    hittable_list world;
+    camera cam;
+    scene.setup(world, cam);
+    std::vector<ray> rays = accelerator_bench_rays(world, cam, 160);
+
+    printf("[%s] %zu objects, %zu rays x %d\n", scene.name, world.objects.size(), rays.size(), repeat);
+
+    size_t reference_hits = 0;
+    double reference_t_sum = 0.0f;
+    for (accelerator_type type : types)
+    {
+      auto build_start = std::chrono::steady_clock::now();
+      std::shared_ptr<hittable> accelerator = make_accelerator(world, type, options);
+      auto build_end = std::chrono::steady_clock::now();
+      double build_ms = std::chrono::duration<double, std::milli>(build_end - build_start).count();
+
+      size_t hit_count;
+      double t_sum;
+      double seconds = accelerator_trace_seconds(*accelerator, rays, repeat, hit_count, t_sum);
+      if (type == accelerator_type::none)
+      {
+        reference_hits = hit_count;
+        reference_t_sum = t_sum;
+      }
+      bool match = hit_count == reference_hits && std::fabs(t_sum - reference_t_sum) <= 1e-6 * std::fabs(reference_t_sum);
+
+      printf("  %-13s build %9.3f ms | %8.3f Mrays/s | hits %zu %s\n", accelerator_name(type), build_ms,
+             rays.size() * repeat / seconds * 1e-6, hit_count, match ? "" : "MISMATCH");
+    }
+  }
+};
+
+/**
+ * scene 별 가속 구조 선택
+ *
+ *
+ * 가속 구조의 우열은 scene 의 primitive 개수, 크기 분포, 공간 분포에 따라 달라진다.
+ * - primitive 가 몇 개뿐인 scene 은 가속 구조 없이 선형 검사하는 편이 빠를 수 있고,
+ * - bouncing_spheres 처럼 비슷한 크기의 primitive 가 고르게 깔린 scene 은 균일 격자가 유리할 수 있으며,
+ * - 크기와 밀도가 제각각인 scene 은 SAH 기반 BVH / kd-tree 가 안정적이다.
+ *
+ * 따라서 추측 대신 이 벤치마크로 scene 마다 측정한 뒤, main.cpp 의 render_scene() 호출에 scene 마다 가장 빠른 종류를 지정한다.
+ * (object 가 많은 scene 의 기본값 scene_accelerator 는 dense scene 인 bouncing_spheres_objects 의 측정 결과로 고른다)
+ * (빌드 시간은 렌더링 한 번에 한 번만 들고, 순회 시간은 광선 수(해상도 x 샘플 수 x 반사 횟수)에 비례하므로 둘을 함께 보고 판단)
+ */
+
+#endif /* ACCELERATOR_BENCH_HPP */
@@ -0,0 +1,93 @@
+#ifndef FAST_MATH_BENCH_HPP
+#define FAST_MATH_BENCH_HPP
+
+#include "common/rtweekend.hpp"
+
+#include <chrono>
+#include <vector>
+
+/**
+ * fast_math.hpp 근사 함수들의 정확도(최대 오차)와 속도를 측정하는 벤치마크
+ *
+ * - 각 함수의 정의역 전체를 촘촘하게 샘플링하여 표준 함수 대비 최대 절대/상대 오차를 계산하고,
+ *   fast_math.hpp 에 명시한 오차 상한을 넘으면 FAIL 로 표시한다. (정확도 trade-off 를 숫자로 확인하기 위한 용도)
+ * - 동일한 입력 배열에 대해 표준 함수와 근사 함수의 호출당 소요 시간(ns)을 측정한다.
+ */
+
+// 입력 배열 전체에 함수 f 를 적용하는 데 걸린 호출당 평균 시간(ns) 측정 (sink 에 결과를 누산해 최적화로 제거되는 것을 방지)
+template <typename F>
+inline double fast_math_time_ns(const std::vector<double> &xs, const std::vector<double> &ys, F f, double &sink)
+{
+  const int repeat = 20;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < repeat; r++)
+  {
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+      sink += f(xs[i], ys[i]);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / (double(repeat) * xs.size());
+};
+
+// 함수 하나에 대한 오차/속도 측정 결과 한 줄 출력
+template <typename F_STD, typename F_FAST>
+inline void fast_math_report_row(const char *name, const std::vector<double> &xs, const std::vector<double> &ys,
+                                 F_STD f_std, F_FAST f_fast, bool relative, double bound, double &sink)
+{
+  // 최대 오차 측정
+  double max_err = 0.0;
+  for (size_t i = 0; i < xs.size(); i++)
+  {
+    double ref = f_std(xs[i], ys[i]);
+    double err = std::fabs(f_fast(xs[i], ys[i]) - ref);
+    if (relative && ref != 0.0)
+      err /= std::fabs(ref);
+    max_err = std::fmax(max_err, err);
+  }
+
+  // 호출당 소요 시간 측정
+  double std_ns = fast_math_time_ns(xs, ys, f_std, sink);
+  double fast_ns = fast_math_time_ns(xs, ys, f_fast, sink);
+
+  printf("%-8s max %s err %.3e (bound %.0e) %s | std %6.2f ns  fast %6.2f ns  speedup x%.2f\n",
+         name, relative ? "rel" : "abs", max_err, bound, max_err <= bound ? "OK  " : "FAIL",
+         std_ns, fast_ns, std_ns / fast_ns);
+};
+
+// fast_math.hpp 근사 함수 전체에 대한 오차 검증 및 마이크로벤치마크 실행
+inline void fast_math_benchmark()
+{
+  const size_t count = 1 << 20;
+  std::vector<double> unit(count), angle(count), expo(count), base(count), ys(count), xs(count);
+
+  // 각 함수의 정의역을 균일하게 샘플링 (경계값 포함)
+  for (size_t i = 0; i < count; i++)
+  {
+    double s = double(i) / double(count - 1);
+    unit[i] = -1.0 + 2.0 * s;    // acos: [-1, 1]
+    angle[i] = -100.0 + 200.0 * s; // sin: [-100, 100]
+    expo[i] = fast_math_exp_min + (fast_math_exp_max - fast_math_exp_min) * s; // exp: 결과가 유한한 정규화 수인 입력 전체 (양 끝 포함)
+    base[i] = s;                   // pow: [0, 1] (Schlick 근사의 1 - cosθ 범위)
+    // atan2: 원 둘레 위의 (x, y) 와 다양한 반지름
+    double theta = 2.0 * pi * s;
+    double radius = 0.001 + 10.0 * random_double();
+    xs[i] = radius * std::cos(theta);
+    ys[i] = radius * std::sin(theta);
+  }
+
+  double sink = 0.0;
+  printf("fast-math accuracy / speed (%zu samples per function)\n", count);
+
+  fast_math_report_row("acos", unit, unit, [](double x, double) { return std::acos(x); }, [](double x, double) { return fast_acos(x); }, false, 1e-7, sink);
+  fast_math_report_row("atan2", ys, xs, [](double y, double x) { return std::atan2(y, x); }, [](double y, double x) { return fast_atan2(y, x); }, false, 5e-6, sink);
+  fast_math_report_row("sin", angle, angle, [](double x, double) { return std::sin(x); }, [](double x, double) { return fast_sin(x); }, false, 1e-7, sink);
+  fast_math_report_row("exp", expo, expo, [](double x, double) { return std::exp(x); }, [](double x, double) { return fast_exp(x); }, true, 2e-8, sink);
+  fast_math_report_row("pow5", base, base, [](double x, double) { return std::pow(x, 5); }, [](double x, double) { return pow_int<5>(x); }, false, 1e-15, sink);
+
+  // sink 값을 출력해 측정 루프가 최적화로 제거되지 않도록 함
+  printf("(checksum %g)\n", sink);
+};
+
+#endif /* FAST_MATH_BENCH_HPP */
@@ -0,0 +1,123 @@
+#ifndef HIT_RECORD_BENCH_HPP
+#define HIT_RECORD_BENCH_HPP
+
+#include "common/rtweekend.hpp"
+#include "common/parallel.hpp"
+#include "core/material.hpp"
+#include "hittable/hittable.hpp"
+
+#include <chrono>
+#include <type_traits>
+#include <vector>
+
+/**
+ * hit_record 의 material 참조 방식(shared_ptr vs raw pointer) 비교 벤치마크
+ *
+ * - 이전 hit_record 와 같은 구성(material 을 shared_ptr 로 보관)의 legacy_hit_record 를 두고,
+ *   hittable_list::hit() 의 후보 교차점 기록 패턴(primitive 가 temp_rec 에 material 대입 → 더 가까우면 rec = temp_rec 복사)을
+ *   두 record 타입으로 똑같이 반복하여 후보 교차점 하나당 소요 시간을 측정한다.
+ * - material 은 여러 primitive 가 공유하는 소수의 객체(ex> 바닥, 벽)로 두고, 1 thread 와 하드웨어 thread 수로 각각 측정한다.
+ *   (shared_ptr 는 모든 thread 가 같은 참조 카운트를 원자적으로 증감하므로 thread 수가 늘어날수록 차이가 커진다)
+ * - legacy 경로는 후보 교차점 하나당 참조 카운트 원자 연산을 4번(대입 시 증가/감소, 복사 시 증가/감소) 수행하며,
+ *   현재 hit_record 는 trivially copyable 이므로 원자 연산이 전혀 없다.
+ */
+
+// material 을 shared_ptr 로 보관하던 이전 hit_record 와 동일한 구성 (비교용)
+class legacy_hit_record
+{
+public:
+  point3 p;
+  vec3 normal;
+  std::shared_ptr<material> mat;
+  double t;
+  double u;
+  double v;
+  bool front_face;
+};
+
+// primitive 의 material(shared_ptr)을 record 에 기록 (sphere::hit() 의 rec.mat 대입에 해당)
+inline void hit_record_assign_material(legacy_hit_record &rec, const std::shared_ptr<material> &mat) { rec.mat = mat; };
+inline void hit_record_assign_material(hit_record &rec, const std::shared_ptr<material> &mat) { rec.mat = mat.get(); };
+
+// thread_count 개의 thread 가 각각 candidate_count 개의 후보 교차점을 기록할 때, 후보 하나당 평균 시간(ns, wall clock 기준 thread 합산 처리량) 측정
+template <typename RECORD>
+inline double hit_record_candidate_ns(const std::vector<std::shared_ptr<material>> &materials, size_t candidate_count,
+                                      int thread_count, double &sink)
+{
+  std::vector<double> chunk_sink(thread_count, 0.0f);
+  auto start = std::chrono::steady_clock::now();
+  int chunks = parallel_for_chunks(static_cast<size_t>(thread_count), thread_count,
+                                   [&](int chunk, size_t, size_t)
+                                   {
+                                     RECORD rec;
+                                     RECORD temp_rec;
+                                     rec.t = 0.0f;
+                                     double closest = infinity;
+                                     double local_sink = 0.0f;
+                                     for (size_t i = 0; i < candidate_count; i++)
+                                     {
+                                       // 광선 하나당 후보 교차점 4개 (hittable_list::hit() 처럼 매 광선마다 closest 초기화)
+                                       if ((i & 3) == 0)
+                                       {
+                                         local_sink += rec.t;
+                                         closest = infinity;
+                                       }
+
+                                       // primitive::hit() : temp_rec 에 교차 정보 기록
+                                       temp_rec.t = static_cast<double>((i * 2654435761u) & 1023);
+                                       temp_rec.u = temp_rec.t * 0.5f;
+                                       hit_record_assign_material(temp_rec, materials[(i + chunk) % materials.size()]);
+
+                                       // hittable_list::hit() : 더 가까운 교차점이면 rec 로 복사
+                                       if (temp_rec.t < closest)
+                                       {
+                                         closest = temp_rec.t;
+                                         rec = temp_rec;
+                                       }
+                                     }
+                                     chunk_sink[chunk] = local_sink;
+                                   });
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for (int c = 0; c < chunks; c++)
+  {
+    sink += chunk_sink[c];
+  }
+  return seconds * 1e9 / (static_cast<double>(candidate_count) * chunks);
+};
+
+// 1 thread / 하드웨어 thread 수에서 legacy(shared_ptr) 와 현재(raw pointer) hit_record 의 후보 교차점 기록 비용 비교
+inline void hit_record_benchmark()
+{
+  const size_t candidate_count = 20000000;
+
+  printf("hit_record: %zu bytes, trivially copyable %s | legacy_hit_record: %zu bytes, trivially copyable %s\n",
+         sizeof(hit_record), std::is_trivially_copyable<hit_record>::value ? "yes" : "no",
+         sizeof(legacy_hit_record), std::is_trivially_copyable<legacy_hit_record>::value ? "yes" : "no");
+
+  // scene 에서 여러 primitive 가 공유하는 소수의 material
+  std::vector<std::shared_ptr<material>> materials;
+  materials.push_back(std::make_shared<lambertian>(color(0.73f, 0.73f, 0.73f)));
+  materials.push_back(std::make_shared<lambertian>(color(0.65f, 0.05f, 0.05f)));
+  materials.push_back(std::make_shared<metal>(color(0.8f, 0.8f, 0.9f), 0.1f));
+
+  std::vector<int> thread_counts = {1};
+  if (hardware_thread_count() > 1)
+  {
+    thread_counts.push_back(hardware_thread_count());
+  }
+
+  double sink = 0.0f;
+  for (int thread_count : thread_counts)
+  {
+    double legacy_ns = hit_record_candidate_ns<legacy_hit_record>(materials, candidate_count, thread_count, sink);
+    double raw_ns = hit_record_candidate_ns<hit_record>(materials, candidate_count, thread_count, sink);
+    printf("%2d thread(s) | shared_ptr %6.2f ns/candidate  raw pointer %6.2f ns/candidate  speedup x%.2f\n",
+           thread_count, legacy_ns, raw_ns, legacy_ns / raw_ns);
+  }
+
+  // 측정 후에도 참조 카운트는 scene 이 가진 참조(1)만 남아 있어야 함
+  printf("material use_count after benchmark: %ld (sink %g)\n", materials[0].use_count(), sink);
+};
+
+#endif /* HIT_RECORD_BENCH_HPP */
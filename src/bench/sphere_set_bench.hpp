@@ -0,0 +1,106 @@
+#ifndef SPHERE_SET_BENCH_HPP
+#define SPHERE_SET_BENCH_HPP
+
+#include "common/rtweekend.hpp"
+#include "accelerator/accelerator.hpp"
+#include "bench/accelerator_bench.hpp"
+#include "core/material.hpp"
+#include "hittable/hittable_list.hpp"
+#include "hittable/sphere.hpp"
+#include "hittable/sphere_set.hpp"
+
+#include <chrono>
+#include <vector>
+
+/**
+ * sphere_set 벤치마크
+ *
+ * - 같은 구체 집합(입자 구름)을 1. 구체마다 sphere 객체를 만들어 BVH(bvh_flat, bvh_wide)로 감싼 경우와
+ *   2. sphere_set 하나로 만든 경우로 각각 구축하고, 같은 광선 집합에 대한 빌드 시간과 순회 속도를 측정한다.
+ * - 구체의 절반은 motion blur 용 동적 구체이며, 광선은 입자 구름 내부/주변에서 무작위 방향으로 쏜다.
+ * - 교차 개수와 t 합계를 sphere 객체 버전(bvh_flat)과 비교해서, 결과가 다르면 MISMATCH 로 표시한다.
+ */
+
+// 구체 count 개로 구성된 입자 구름 하나에 대해 측정 결과 출력
+inline void sphere_set_benchmark_case(size_t count, size_t ray_count)
+{
+  const int repeat = 4;
+
+  // 입자 구름: 한 변이 side 인 정육면체 안에 반지름 0.2 구체를 평균 간격 1 정도로 배치 (bouncing_spheres 의 소형 구체와 같은 밀도)
+  double side = std::cbrt(static_cast<double>(count));
+  auto mat = std::make_shared<lambertian>(color(0.5f, 0.5f, 0.5f));
+  hittable_list objects;
+  auto set = std::make_shared<sphere_set>();
+  for (size_t i = 0; i < count; i++)
+  {
+    point3 center(random_double(0.0f, side), random_double(0.0f, side), random_double(0.0f, side));
+    double radius = random_double(0.1f, 0.3f);
+    if (i % 2 == 0)
+    {
+      point3 center2 = center + vec3(0.0f, random_double(0.0f, 0.5f), 0.0f);
+      objects.add(std::make_shared<sphere>(center, center2, radius, mat));
+      set->add(center, center2, radius, mat);
+    }
+    else
+    {
+      objects.add(std::make_shared<sphere>(center, radius, mat));
+      set->add(center, radius, mat);
+    }
+  }
+
+  std::vector<ray> rays;
+  rays.reserve(ray_count);
+  for (size_t i = 0; i < ray_count; i++)
+  {
+    point3 origin(random_double(-1.0f, side + 1.0f), random_double(-1.0f, side + 1.0f), random_double(-1.0f, side + 1.0f));
+    rays.push_back(ray(origin, random_unit_vector(), random_double()));
+  }
+
+  printf("[%zu spheres] %zu rays x %d\n", count, rays.size(), repeat);
+
+  bvh_build_options options;
+  size_t reference_hits = 0;
+  double reference_t_sum = 0.0f;
+  const accelerator_type types[] = {accelerator_type::bvh_flat, accelerator_type::bvh_wide};
+  for (accelerator_type type : types)
+  {
+    auto build_start = std::chrono::steady_clock::now();
+    std::shared_ptr<hittable> accelerator = make_accelerator(objects, type, options);
+    double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_start).count();
+
+    size_t hit_count;
+    double t_sum;
+    double seconds = accelerator_trace_seconds(*accelerator, rays, repeat, hit_count, t_sum);
+    if (type == accelerator_type::bvh_flat)
+    {
+      reference_hits = hit_count;
+      reference_t_sum = t_sum;
+    }
+    bool match = hit_count == reference_hits && std::fabs(t_sum - reference_t_sum) <= 1e-6 * std::fabs(reference_t_sum);
+    printf("  sphere + %-11s build %9.3f ms | %8.3f Mrays/s | hits %zu %s\n", accelerator_name(type), build_ms,
+           rays.size() * repeat / seconds * 1e-6, hit_count, match ? "" : "MISMATCH");
+  }
+
+  auto build_start = std::chrono::steady_clock::now();
+  set->rebuild();
+  double build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_start).count();
+
+  size_t hit_count;
+  double t_sum;
+  double seconds = accelerator_trace_seconds(*set, rays, repeat, hit_count, t_sum);
+  bool match = hit_count == reference_hits && std::fabs(t_sum - reference_t_sum) <= 1e-6 * std::fabs(reference_t_sum);
+  printf("  %-20s build %9.3f ms | %8.3f Mrays/s | hits %zu %s (%zu packets)\n", "sphere_set", build_ms,
+         rays.size() * repeat / seconds * 1e-6, hit_count, match ? "" : "MISMATCH", set->packet_count());
+};
+
+// 구체 수를 바꿔가며 sphere 객체 + BVH 와 sphere_set 의 순회 속도 비교
+inline void sphere_set_benchmark()
+{
+  const size_t counts[] = {500, 20000, 500000};
+  for (size_t count : counts)
+  {
+    sphere_set_benchmark_case(count, 200000);
+  }
+};
+
+#endif /* SPHERE_SET_BENCH_HPP */
@@ -0,0 +1,81 @@
+#ifndef ALIGNED_ALLOCATOR_HPP
+#define ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+/**
+ * aligned_allocator<T, Align> 클래스
+ *
+ * std::vector 등 표준 컨테이너의 원소를 Align 바이트 경계에 맞춰 할당하는 allocator.
+ * - C++11 의 기본 allocator(operator new)는 alignof(std::max_align_t)(보통 16바이트)를 넘는 정렬을 보장하지 않으므로,
+ *   캐시 라인 / AVX 레지스터 크기에 맞춰 정렬해야 하는 노드 배열(ex> 32바이트 BVH 노드)을 힙에 저장할 때 사용한다.
+ * - Align 은 2의 거듭제곱이면서 sizeof(void *) 의 배수여야 한다. (posix_memalign 요구사항)
+ */
+template <typename T, size_t Align>
+class aligned_allocator
+{
+public:
+  using value_type = T;
+
+  // 다른 원소 타입에 대해 동일한 정렬을 사용하는 allocator 로 rebind (std::vector 내부 구현에서 요구)
+  template <typename U>
+  struct rebind
+  {
+    using other = aligned_allocator<U, Align>;
+  };
+
+  aligned_allocator() {};
+
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, Align> &) {};
+
+  // Align 바이트 경계에 맞춰 원소 n 개 크기의 메모리 할당
+  T *allocate(size_t n)
+  {
+    if (n == 0)
+    {
+      return nullptr;
+    }
+
+    void *ptr = nullptr;
+#if defined(_WIN32)
+    ptr = _aligned_malloc(n * sizeof(T), Align);
+#else
+    if (posix_memalign(&ptr, Align, n * sizeof(T)) != 0)
+    {
+      ptr = nullptr;
+    }
+#endif
+
+    if (!ptr)
+    {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(ptr);
+  };
+
+  // allocate() 로 할당한 메모리 해제
+  void deallocate(T *ptr, size_t)
+  {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+  };
+};
+
+// 상태가 없는 allocator 이므로 정렬이 같으면 항상 서로 호환됨
+template <typename T, typename U, size_t Align>
+inline bool operator==(const aligned_allocator<T, Align> &, const aligned_allocator<U, Align> &) { return true; };
+
+template <typename T, typename U, size_t Align>
+inline bool operator!=(const aligned_allocator<T, Align> &, const aligned_allocator<U, Align> &) { return false; };
+
+#endif /* ALIGNED_ALLOCATOR_HPP */
@@ -0,0 +1,245 @@
+#ifndef FAST_MATH_HPP
+#define FAST_MATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 빠른 근사 수학 함수 모음 (fast-math)
+ *
+ * - 렌더링 hot path 에서 호출되는 std::acos, std::atan2, std::sin, std::pow 를
+ *   오차 상한이 정해진 다항식 근사로 대체하기 위한 함수들.
+ *   (fast_exp 는 현재 렌더러 call site 가 없어서 rtw_* 래퍼 없이 벤치마크에서만 정확도를 확인한다)
+ * - 각 함수 옆에 적어둔 최대 오차는 bench/fast_math_bench.hpp 의 fast_math_benchmark() 로 측정/확인할 수 있다.
+ * - 실제 렌더러 코드에서는 fast_* 함수를 직접 호출하지 않고, 하단의 rtw_* 함수를 호출한다.
+ *   -> RTW_FAST_MATH 가 정의된 빌드(CMake 옵션 RTW_USE_FAST_MATH=ON)에서만 근사 함수로 대체되고, 기본 빌드에서는 표준 함수가 그대로 사용됨.
+ */
+
+// fast_* 근사 함수 내부에서 사용할 상수 (rtweekend.hpp 의 pi 와 독립적으로 사용할 수 있도록 별도 정의)
+const double fast_math_pi = 3.1415926535897932385;
+const double fast_math_half_pi = 1.5707963267948966192;
+const double fast_math_two_pi = 6.2831853071795864769;
+
+// fast_exp 의 입력 한계: exp(x) 가 유한한 double 인 최댓값 ln(DBL_MAX) 와 정규화 수가 되는 최솟값 ln(DBL_MIN)
+const double fast_math_exp_max = 709.782712893384;
+const double fast_math_exp_min = -708.3964185322641;
+
+// 1.5 * 2^52: 이 값을 더했다 빼면 double 의 가수부 정밀도 한계로 인해 소수부가 버려지고 가장 가까운 정수로 반올림됨
+// -> SSE4.1(roundsd) 없이도 std::floor / std::round 함수 호출보다 훨씬 저렴하게 정수 반올림 가능 (|x| < 2^51 범위에서 유효)
+const double fast_math_round_shifter = 6755399441055744.0;
+
+inline double fast_round(double x)
+{
+  // (x + c) - c 는 IEEE-754 규칙상 x 로 단순화될 수 없으므로 -ffast-math 로 빌드하지 않는 한 그대로 유지됨
+  return (x + fast_math_round_shifter) - fast_math_round_shifter;
+};
+
+// 정수 지수 거듭제곱 x^N (컴파일 타임 지수) -> 반복 제곱(exponentiation by squaring)으로 곱셈 몇 번에 계산
+template <int N>
+inline double pow_int(double x)
+{
+  return (N % 2 == 0) ? pow_int<N / 2>(x * x) : x * pow_int<N / 2>(x * x);
+};
+
+template <>
+inline double pow_int<1>(double x) { return x; };
+
+template <>
+inline double pow_int<0>(double) { return 1.0; };
+
+// 정수 지수 거듭제곱 x^n (런타임 지수, n < 0 이면 역수)
+inline double pow_int(double x, int n)
+{
+  bool inverse = n < 0;
+  unsigned int e = inverse ? -n : n;
+  double result = 1.0;
+
+  // 지수의 각 비트를 순회하며 해당 비트가 1 이면 현재 x^(2^k) 를 결과에 곱함
+  while (e)
+  {
+    if (e & 1)
+      result *= x;
+    x *= x;
+    e >>= 1;
+  }
+  return inverse ? 1.0 / result : result;
+};
+
+// acos(x) 근사 (Abramowitz & Stegun 4.4.46), x ∈ [-1, 1], 최대 절대 오차 약 2e-8 rad
+inline double fast_acos(double x)
+{
+  // acos(-x) = π - acos(x) 대칭성을 이용해 [0, 1] 구간만 근사
+  bool negate = x < 0.0;
+  x = std::fabs(x);
+  if (x > 1.0)
+    x = 1.0;
+
+  // acos(x) ≈ sqrt(1 - x) * P(x), P 는 7차 다항식 (Horner 방식으로 평가)
+  double p = -0.0012624911;
+  p = p * x + 0.0066700901;
+  p = p * x - 0.0170881256;
+  p = p * x + 0.0308918810;
+  p = p * x - 0.0501743046;
+  p = p * x + 0.0889789874;
+  p = p * x - 0.2145988016;
+  p = p * x + 1.5707963050;
+  double r = std::sqrt(1.0 - x) * p;
+
+  return negate ? fast_math_pi - r : r;
+};
+
+// atan(z) 근사, z ∈ [-1, 1], 11차 홀수 minimax 다항식 (최대 절대 오차 약 2e-6 rad)
+inline double fast_atan_unit(double z)
+{
+  double z2 = z * z;
+  double p = -0.0117212;
+  p = p * z2 + 0.05265332;
+  p = p * z2 - 0.11643287;
+  p = p * z2 + 0.19354346;
+  p = p * z2 - 0.33262347;
+  p = p * z2 + 0.99997726;
+  return z * p;
+};
+
+// atan2(y, x) 근사 (std::atan2 와 동일하게 [-π, π] 범위 반환), 최대 절대 오차 약 2e-6 rad
+inline double fast_atan2(double y, double x)
+{
+  double ax = std::fabs(x);
+  double ay = std::fabs(y);
+
+  // 원점은 std::atan2 와 동일하게 부호에 따라 0 또는 ±π 로 처리
+  if (ax == 0.0 && ay == 0.0)
+    return std::atan2(y, x);
+
+  // |y| <= |x| 이면 atan(y/x), 아니면 π/2 - atan(x/y) 로 [0, 1] 구간 근사를 재사용
+  bool swap = ay > ax;
+  double z = swap ? ax / ay : ay / ax;
+  double r = fast_atan_unit(z);
+  if (swap)
+    r = fast_math_half_pi - r;
+
+  // 사분면 복원
+  if (x < 0.0)
+    r = fast_math_pi - r;
+  return y < 0.0 ? -r : r;
+};
+
+// sin(x) 근사, 임의의 x 에 대해 [-π/2, π/2] 로 범위 축소 후 11차 Taylor 다항식 (|x| < 1e4 에서 최대 절대 오차 약 1e-7)
+inline double fast_sin(double x)
+{
+  // x 를 [-π, π] 범위로 축소
+  x -= fast_math_two_pi * fast_round(x * (1.0 / fast_math_two_pi));
+
+  // sin(π - x) = sin(x) 를 이용해 [-π/2, π/2] 범위로 한 번 더 축소
+  if (x > fast_math_half_pi)
+    x = fast_math_pi - x;
+  else if (x < -fast_math_half_pi)
+    x = -fast_math_pi - x;
+
+  double x2 = x * x;
+  double p = -2.5052108385441720e-08; // -1/11!
+  p = p * x2 + 2.7557319223985893e-06; // 1/9!
+  p = p * x2 - 1.9841269841269841e-04; // -1/7!
+  p = p * x2 + 8.3333333333333333e-03; // 1/5!
+  p = p * x2 - 1.6666666666666667e-01; // -1/3!
+  p = p * x2 + 1.0;
+  return x * p;
+};
+
+// exp(x) 근사, exp(x) = 2^k * exp(r) (|r| <= ln2/2) 로 분해 후 7차 Taylor 다항식 (최대 상대 오차 약 1e-8)
+inline double fast_exp(double x)
+{
+  // 결과가 double 최댓값을 넘거나 정규화 수(normal) 최솟값보다 작아지는 입력은 무한대 또는 0 으로 처리
+  if (x > fast_math_exp_max)
+    return HUGE_VAL;
+  if (x < fast_math_exp_min)
+    return 0.0;
+
+  // ln2 를 상위 비트(ln2_hi, k * ln2_hi 가 정확히 표현됨)와 나머지(ln2_lo)로 나눠서 r 을 계산 (Cody-Waite 범위 축소)
+  // -> ln2 하나로 계산하면 x = ln(DBL_MAX) 에서 r 이 0 으로 반올림되어 유한한 결과 대신 무한대가 됨
+  const double ln2 = 0.69314718055994530942;
+  const double ln2_hi = 6.93145751953125e-01;
+  const double ln2_lo = 1.42860682030941723212e-06;
+  double k = fast_round(x * (1.0 / ln2));
+  double r = (x - k * ln2_hi) - k * ln2_lo;
+
+  double p = 1.0 / 5040.0;
+  p = p * r + 1.0 / 720.0;
+  p = p * r + 1.0 / 120.0;
+  p = p * r + 1.0 / 24.0;
+  p = p * r + 1.0 / 6.0;
+  p = p * r + 0.5;
+  p = p * r + 1.0;
+  p = p * r + 1.0;
+
+  // 2^k 는 IEEE-754 double 의 지수 비트에 (k + 1023) 을 직접 기록해서 생성 (ldexp 호출 비용 제거)
+  // -> x 가 최댓값 근처이면 k = 1024 가 되어 무한대의 지수 비트(2047)가 기록되므로, 2^1023 * 2 두 단계로 나눠서 곱함
+  if (k > 1023.0)
+  {
+    p *= 2.0;
+    k -= 1.0;
+  }
+  int64_t bits = static_cast<int64_t>(k + 1023.0) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+};
+
+/** 렌더러 call site 에서 사용하는 switchable 수학 함수 (RTW_FAST_MATH 정의 여부에 따라 근사/표준 함수 선택) */
+inline double rtw_acos(double x)
+{
+#if defined(RTW_FAST_MATH)
+  return fast_acos(x);
+#else
+  return std::acos(x);
+#endif
+};
+
+inline double rtw_atan2(double y, double x)
+{
+#if defined(RTW_FAST_MATH)
+  return fast_atan2(y, x);
+#else
+  return std::atan2(y, x);
+#endif
+};
+
+inline double rtw_sin(double x)
+{
+#if defined(RTW_FAST_MATH)
+  return fast_sin(x);
+#else
+  return std::sin(x);
+#endif
+};
+
+template <int N>
+inline double rtw_pow(double x)
+{
+#if defined(RTW_FAST_MATH)
+  return pow_int<N>(x);
+#else
+  return std::pow(x, N);
+#endif
+};
+
+/**
+ * fast-math 적용 범위와 정확도 trade-off
+ *
+ *
+ * 근사 함수로 대체되는 call site 는 다음과 같다:
+ *   - sphere::get_sphere_uv()       : std::acos, std::atan2 -> rtw_acos, rtw_atan2 (구체 hit 마다 호출)
+ *   - dielectric::reflectance()     : std::pow(x, 5)        -> rtw_pow<5> (곱셈 3번)
+ *   - noise_texture::value()        : std::sin              -> rtw_sin
+ *
+ * uv 좌표의 오차(약 2e-6 rad / 2π ≈ 3e-7)는 텍스처 1픽셀보다 훨씬 작고,
+ * Schlick 근사 자체가 이미 근사식이므로 정수 거듭제곱에 따른 반올림 차이는 결과 이미지에 드러나지 않는다.
+ *
+ * linear_to_gamma() 의 std::sqrt 는 근사 대상에서 제외했다.
+ * std::sqrt 는 하드웨어 명령어(sqrtsd) 하나로 컴파일되므로 다항식 근사보다 이미 빠르고 정확하기 때문.
+ *
+ * 기본 빌드(RTW_FAST_MATH 미정의)에서는 rtw_* 함수가 표준 함수를 그대로 호출하므로 결과 이미지가 비트 단위로 동일하다.
+ */
+
+#endif /* FAST_MATH_HPP */
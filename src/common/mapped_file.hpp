@@ -0,0 +1,153 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * 읽기 전용 메모리 맵 파일 클래스
+ *
+ * - 파일 전체를 프로세스 주소 공간에 매핑하여, 파일 내용을 별도의 버퍼로 복사(read)하지 않고 포인터로 바로 접근한다.
+ *   (POSIX 는 mmap, Windows 는 CreateFileMapping / MapViewOfFile 사용)
+ * - 실제 디스크 읽기는 해당 페이지에 처음 접근할 때 OS 가 필요한 만큼만 수행하므로, 큰 파일도 열기 자체는 즉시 끝난다.
+ * - 소멸 시 매핑을 해제하며, 매핑 주소를 소유하므로 복사할 수 없다. (공유가 필요하면 shared_ptr 로 관리)
+ */
+class mapped_file
+{
+public:
+  mapped_file() {};
+
+  explicit mapped_file(const std::string &path) { open(path); };
+
+  ~mapped_file() { close(); };
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+
+  // 파일을 읽기 전용으로 매핑 (실패하거나 빈 파일이면 false 반환)
+  bool open(const std::string &path)
+  {
+    close();
+
+#ifdef _WIN32
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+    {
+      close();
+      return false;
+    }
+
+    mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping_handle == NULL)
+    {
+      close();
+      return false;
+    }
+
+    void *view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL)
+    {
+      close();
+      return false;
+    }
+    bytes = static_cast<const unsigned char *>(view);
+    byte_count = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+      ::close(fd);
+      return false;
+    }
+
+    // 매핑이 유지되는 동안에는 file descriptor 를 닫아도 됨
+    void *view = mmap(NULL, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+      return false;
+    }
+    bytes = static_cast<const unsigned char *>(view);
+    byte_count = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+  };
+
+  // 매핑 해제
+  void close()
+  {
+#ifdef _WIN32
+    if (bytes)
+    {
+      UnmapViewOfFile(bytes);
+    }
+    if (mapping_handle != NULL)
+    {
+      CloseHandle(mapping_handle);
+      mapping_handle = NULL;
+    }
+    if (file_handle != INVALID_HANDLE_VALUE)
+    {
+      CloseHandle(file_handle);
+      file_handle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (bytes)
+    {
+      munmap(const_cast<unsigned char *>(bytes), byte_count);
+    }
+#endif
+    bytes = nullptr;
+    byte_count = 0;
+  };
+
+  // 매핑 전체를 곧 읽을 예정임을 OS 에 알려서 미리 읽기(readahead) 요청 (페이지 폴트마다 작은 단위로 읽는 대신 큰 단위로 읽게 함)
+  void prefetch() const
+  {
+#ifndef _WIN32
+    if (bytes)
+    {
+      madvise(const_cast<unsigned char *>(bytes), byte_count, MADV_WILLNEED);
+    }
+#endif
+  };
+
+  bool is_open() const { return bytes != nullptr; };
+  const unsigned char *data() const { return bytes; };
+  size_t size() const { return byte_count; };
+
+private:
+  const unsigned char *bytes = nullptr; // 매핑된 파일 시작 주소 (페이지 경계 정렬)
+  size_t byte_count = 0;                // 매핑된 파일 크기 (바이트)
+
+#ifdef _WIN32
+  HANDLE file_handle = INVALID_HANDLE_VALUE;
+  HANDLE mapping_handle = NULL;
+#endif
+};
+
+#endif /* MAPPED_FILE_HPP */
@@ -0,0 +1,65 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * std::thread 기반의 간단한 병렬 실행 유틸리티
+ *
+ * - 별도의 thread pool 없이, 호출할 때마다 작업 개수만큼 std::thread 를 생성하고 join 한다.
+ * - BVH 빌드, 파일 파싱처럼 '한 번 실행되는 큰 작업'을 나누는 용도이므로 thread 생성 비용은 무시할 수 있는 수준이다.
+ */
+
+// 사용 가능한 하드웨어 thread 개수 반환 (알 수 없으면 1)
+inline int hardware_thread_count()
+{
+  unsigned int count = std::thread::hardware_concurrency();
+  return count > 0 ? static_cast<int>(count) : 1;
+};
+
+// thread_count 가 0 이하이면 하드웨어 thread 개수로 대체
+inline int resolve_thread_count(int thread_count)
+{
+  return thread_count > 0 ? thread_count : hardware_thread_count();
+};
+
+/**
+ * [0, count) 범위를 thread_count 개의 연속된 구간으로 나눠서 병렬로 f(chunk, begin, end) 를 호출
+ *
+ * - chunk 는 구간 번호(0 ~ 실제 사용한 thread 수 - 1)로, 구간별 누적 결과를 따로 저장해두었다가 합칠 때 사용한다.
+ * - 마지막 구간은 현재 thread 에서 직접 실행하고, 나머지 구간만 새 thread 로 실행한다.
+ * - 실제로 사용한 구간 개수를 반환한다.
+ */
+template <typename F>
+inline int parallel_for_chunks(size_t count, int thread_count, F f)
+{
+  int chunks = static_cast<int>(std::min<size_t>(static_cast<size_t>(std::max(thread_count, 1)), std::max<size_t>(count, 1)));
+  if (chunks <= 1)
+  {
+    f(0, size_t(0), count);
+    return 1;
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunks - 1);
+  size_t chunk_size = (count + chunks - 1) / chunks;
+  for (int c = 0; c < chunks - 1; c++)
+  {
+    size_t begin = std::min(count, c * chunk_size);
+    size_t end = std::min(count, begin + chunk_size);
+    workers.push_back(std::thread([=]()
+                                  { f(c, begin, end); }));
+  }
+  f(chunks - 1, std::min(count, (chunks - 1) * chunk_size), count);
+
+  for (auto &worker : workers)
+  {
+    worker.join();
+  }
+  return chunks;
+};
+
+#endif /* PARALLEL_HPP */
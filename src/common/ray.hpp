@@ -31,6 +31,38 @@ private:
   double tm;   // 광선이 생성된 시점
 };
 
+/**
+ * traversal_ray 클래스
+ *
+ * 가속 구조(BVH 등) 순회 시 사용하는 광선 wrapper 클래스.
+ * - 노드 AABB 와의 slab test 에 필요한 방향벡터의 역수(inv_dir)와 각 축의 방향 부호(sign)를 광선 하나당 한 번만 계산해서 저장한다.
+ *   -> 기존에는 노드를 방문할 때마다 AABB 검사 안에서 1.0 / direction 나눗셈을 축마다 반복했음.
+ * - 원본 광선은 참조로 들고 있으므로, 순회 도중 primitive::hit() 에는 원본 광선을 그대로 넘긴다.
+ *   (wrapper 의 수명은 가속 구조의 hit() 호출 범위를 넘지 않음)
+ */
+class traversal_ray
+{
+public:
+  explicit traversal_ray(const ray &r) : r(r), origin(r.origin()), direction(r.direction())
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      // 방향 성분이 0 이면 역수는 ±무한대가 됨 (slab test 에서 NaN 이 발생할 수 있는 경우는 aabb.hpp 의 slab_test() 가 처리)
+      inv_dir[axis] = 1.0 / direction[axis];
+
+      // 부호는 역수 기준으로 결정 -> -0.0 방향 성분도 1 / -0.0 = -inf 이므로 음의 방향으로 올바르게 분류됨
+      sign[axis] = inv_dir[axis] < 0.0 ? 1 : 0;
+    }
+  };
+
+public:
+  const ray &r;      // 원본 광선
+  point3 origin;     // 광선 출발점 (getter 호출 없이 바로 접근하기 위해 복사)
+  vec3 direction;    // 광선 방향벡터
+  double inv_dir[3]; // 각 축 방향 성분의 역수
+  int sign[3];       // 각 축 방향 성분의 부호 (0: 양의 방향, 1: 음의 방향) -> slab 의 가까운/먼 경계면 선택에 사용
+};
+
 /**
  * Motion Blur 와 ray::time
  *
@@ -39,6 +39,7 @@ inline int random_int(int min, int max)
 };
 
 // common
+#include "fast_math.hpp"
 #include "color.hpp"
 #include "interval.hpp"
 #include "ray.hpp"
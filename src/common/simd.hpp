@@ -0,0 +1,435 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+/**
+ * SIMD 백엔드 선택 헤더
+ *
+ * - 빌드 시 RTW_USE_SIMD 가 정의되어 있고(CMake 옵션 RTW_USE_SIMD=ON),
+ *   컴파일러가 해당 명령어 집합을 활성화한 상태일 때만 SIMD 경로를 켠다.
+ * - 조건을 만족하지 않으면 아무 매크로도 정의되지 않으므로, 각 수학 타입은 스칼라 구현(fallback)으로 컴파일된다.
+ */
+#if defined(RTW_USE_SIMD)
+
+// SSE2 는 x86-64 의 기본 명령어 집합이므로 64비트 빌드에서는 항상 사용 가능
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RTW_SIMD_SSE2 1
+#endif
+
+// AVX 는 -mavx(GCC/Clang) 또는 /arch:AVX(MSVC) 로 명시적으로 활성화해야 함
+#if defined(__AVX__)
+#define RTW_SIMD_AVX 1
+#endif
+
+// AVX2 는 lane 간 permute(_mm256_permute4x64_pd 등) 및 정수 256비트 연산에 필요
+#if defined(__AVX2__)
+#define RTW_SIMD_AVX2 1
+#endif
+
+#if defined(RTW_SIMD_SSE2) || defined(RTW_SIMD_AVX)
+#include <immintrin.h>
+#endif
+
+#endif /* RTW_USE_SIMD */
+
+#include <cmath>
+
+/**
+ * lanes<T, N> 클래스
+ *
+ * 같은 타입 T 의 값 N 개를 하나의 SIMD 레지스터처럼 다루는 lane 묶음(pack) 타입.
+ * - 기본 템플릿은 배열 기반의 포터블 구현(fallback)이며, 컴파일러의 auto-vectorization 에 맡긴다.
+ * - SIMD 백엔드가 활성화되면 lanes<float, 4>(SSE2), lanes<float, 8>(AVX), lanes<double, 4>(AVX) 는
+ *   아래의 특수화(specialization)된 intrinsic 구현으로 대체된다.
+ * - 비교 연산의 결과는 lane_mask<T, N> 으로 반환되며, select() 로 lane 별 값 선택에 사용한다.
+ */
+template <typename T, int N>
+class lanes
+{
+public:
+  T v[N];
+
+  // 모든 lane 을 0 으로 초기화
+  lanes()
+  {
+    for (int i = 0; i < N; i++)
+      v[i] = T(0);
+  };
+
+  // 스칼라 값을 모든 lane 에 broadcast
+  lanes(T s)
+  {
+    for (int i = 0; i < N; i++)
+      v[i] = s;
+  };
+
+  // 연속된 메모리(SoA 배열)에서 N 개 값을 읽어옴 (정렬 불필요)
+  static lanes load(const T *p)
+  {
+    lanes r;
+    for (int i = 0; i < N; i++)
+      r.v[i] = p[i];
+    return r;
+  };
+
+  // N 개 lane 값을 연속된 메모리에 기록
+  void store(T *p) const
+  {
+    for (int i = 0; i < N; i++)
+      p[i] = v[i];
+  };
+
+  T operator[](int i) const { return v[i]; };
+};
+
+// lanes<T, N> 간 비교 결과를 lane 별 참/거짓으로 저장하는 마스크 타입 (포터블 구현)
+template <typename T, int N>
+class lane_mask
+{
+public:
+  bool m[N];
+
+  lane_mask()
+  {
+    for (int i = 0; i < N; i++)
+      m[i] = false;
+  };
+
+  lane_mask(bool b)
+  {
+    for (int i = 0; i < N; i++)
+      m[i] = b;
+  };
+
+  // i 번째 lane 의 참/거짓을 i 번째 비트로 모은 정수 반환 (SSE/AVX movemask 와 동일한 규칙)
+  int bits() const
+  {
+    int r = 0;
+    for (int i = 0; i < N; i++)
+      r |= (m[i] ? 1 : 0) << i;
+    return r;
+  };
+
+  bool operator[](int i) const { return m[i]; };
+};
+
+/** lanes<T, N> 포터블 연산자 및 util 함수 */
+#define RTW_LANES_BINARY_OP(OP)                                        \
+  template <typename T, int N>                                         \
+  inline lanes<T, N> operator OP(const lanes<T, N> &a, const lanes<T, N> &b) \
+  {                                                                    \
+    lanes<T, N> r;                                                     \
+    for (int i = 0; i < N; i++)                                        \
+      r.v[i] = a.v[i] OP b.v[i];                                       \
+    return r;                                                          \
+  }
+
+#define RTW_LANES_COMPARE_OP(OP)                                           \
+  template <typename T, int N>                                             \
+  inline lane_mask<T, N> operator OP(const lanes<T, N> &a, const lanes<T, N> &b) \
+  {                                                                        \
+    lane_mask<T, N> r;                                                     \
+    for (int i = 0; i < N; i++)                                            \
+      r.m[i] = a.v[i] OP b.v[i];                                           \
+    return r;                                                              \
+  }
+
+RTW_LANES_BINARY_OP(+)
+RTW_LANES_BINARY_OP(-)
+RTW_LANES_BINARY_OP(*)
+RTW_LANES_BINARY_OP(/)
+RTW_LANES_COMPARE_OP(<)
+RTW_LANES_COMPARE_OP(<=)
+RTW_LANES_COMPARE_OP(>)
+RTW_LANES_COMPARE_OP(>=)
+
+#undef RTW_LANES_BINARY_OP
+#undef RTW_LANES_COMPARE_OP
+
+template <typename T, int N>
+inline lanes<T, N> operator-(const lanes<T, N> &a)
+{
+  lanes<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.v[i] = -a.v[i];
+  return r;
+};
+
+template <typename T, int N>
+inline lane_mask<T, N> operator&(const lane_mask<T, N> &a, const lane_mask<T, N> &b)
+{
+  lane_mask<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.m[i] = a.m[i] && b.m[i];
+  return r;
+};
+
+template <typename T, int N>
+inline lane_mask<T, N> operator|(const lane_mask<T, N> &a, const lane_mask<T, N> &b)
+{
+  lane_mask<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.m[i] = a.m[i] || b.m[i];
+  return r;
+};
+
+template <typename T, int N>
+inline lane_mask<T, N> operator~(const lane_mask<T, N> &a)
+{
+  lane_mask<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.m[i] = !a.m[i];
+  return r;
+};
+
+// mask 가 참인 lane 은 a, 거짓인 lane 은 b 를 선택
+template <typename T, int N>
+inline lanes<T, N> select(const lane_mask<T, N> &mask, const lanes<T, N> &a, const lanes<T, N> &b)
+{
+  lanes<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.v[i] = mask.m[i] ? a.v[i] : b.v[i];
+  return r;
+};
+
+// lane 별 최솟값 (SSE 의 minps 와 동일하게, 한쪽이 NaN 이면 두 번째 피연산자 b 를 반환)
+template <typename T, int N>
+inline lanes<T, N> min(const lanes<T, N> &a, const lanes<T, N> &b)
+{
+  lanes<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+  return r;
+};
+
+// lane 별 최댓값 (SSE 의 maxps 와 동일하게, 한쪽이 NaN 이면 두 번째 피연산자 b 를 반환)
+template <typename T, int N>
+inline lanes<T, N> max(const lanes<T, N> &a, const lanes<T, N> &b)
+{
+  lanes<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+  return r;
+};
+
+template <typename T, int N>
+inline lanes<T, N> sqrt(const lanes<T, N> &a)
+{
+  lanes<T, N> r;
+  for (int i = 0; i < N; i++)
+    r.v[i] = std::sqrt(a.v[i]);
+  return r;
+};
+
+template <typename T, int N>
+inline bool any(const lane_mask<T, N> &a) { return a.bits() != 0; };
+
+template <typename T, int N>
+inline bool all(const lane_mask<T, N> &a) { return a.bits() == (1 << N) - 1; };
+
+// 스칼라 피연산자를 broadcast 하여 lane 연산으로 위임하는 오버로딩 (SIMD 특수화된 연산자가 있으면 그쪽이 호출됨)
+template <typename T, int N>
+inline lanes<T, N> operator+(const lanes<T, N> &a, T s) { return a + lanes<T, N>(s); };
+template <typename T, int N>
+inline lanes<T, N> operator-(const lanes<T, N> &a, T s) { return a - lanes<T, N>(s); };
+template <typename T, int N>
+inline lanes<T, N> operator*(const lanes<T, N> &a, T s) { return a * lanes<T, N>(s); };
+template <typename T, int N>
+inline lanes<T, N> operator*(T s, const lanes<T, N> &a) { return lanes<T, N>(s) * a; };
+template <typename T, int N>
+inline lanes<T, N> operator/(const lanes<T, N> &a, T s) { return a / lanes<T, N>(s); };
+
+// float lane 묶음을 같은 개수의 double lane 묶음으로 변환 (float 로 압축 저장한 데이터를 double 정밀도로 계산할 때 사용)
+template <int N>
+inline lanes<double, N> widen(const lanes<float, N> &a)
+{
+  // SSE2 특수화된 lanes<float, 4> 에도 동작하도록 멤버 배열 대신 operator[] 로 접근
+  double t[N];
+  for (int i = 0; i < N; i++)
+    t[i] = static_cast<double>(a[i]);
+  return lanes<double, N>::load(t);
+};
+
+#if defined(RTW_SIMD_SSE2)
+/** lanes<float, 4> / lane_mask<float, 4> 의 SSE2 특수화 */
+template <>
+class lanes<float, 4>
+{
+public:
+  __m128 m;
+
+  lanes() : m(_mm_setzero_ps()) {};
+  lanes(float s) : m(_mm_set1_ps(s)) {};
+  explicit lanes(__m128 m) : m(m) {};
+
+  static lanes load(const float *p) { return lanes(_mm_loadu_ps(p)); };
+  void store(float *p) const { _mm_storeu_ps(p, m); };
+
+  float operator[](int i) const
+  {
+    float t[4];
+    _mm_storeu_ps(t, m);
+    return t[i];
+  };
+};
+
+template <>
+class lane_mask<float, 4>
+{
+public:
+  __m128 m; // 참인 lane 은 모든 비트가 1, 거짓인 lane 은 0
+
+  lane_mask() : m(_mm_setzero_ps()) {};
+  lane_mask(bool b) : m(_mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0))) {};
+  explicit lane_mask(__m128 m) : m(m) {};
+
+  int bits() const { return _mm_movemask_ps(m); };
+  bool operator[](int i) const { return (bits() >> i) & 1; };
+};
+
+inline lanes<float, 4> operator+(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_add_ps(a.m, b.m)); };
+inline lanes<float, 4> operator-(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_sub_ps(a.m, b.m)); };
+inline lanes<float, 4> operator*(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_mul_ps(a.m, b.m)); };
+inline lanes<float, 4> operator/(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_div_ps(a.m, b.m)); };
+inline lanes<float, 4> operator-(const lanes<float, 4> &a) { return lanes<float, 4>(_mm_xor_ps(a.m, _mm_set1_ps(-0.0f))); };
+inline lane_mask<float, 4> operator<(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lane_mask<float, 4>(_mm_cmplt_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator<=(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lane_mask<float, 4>(_mm_cmple_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator>(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lane_mask<float, 4>(_mm_cmpgt_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator>=(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lane_mask<float, 4>(_mm_cmpge_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator&(const lane_mask<float, 4> &a, const lane_mask<float, 4> &b) { return lane_mask<float, 4>(_mm_and_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator|(const lane_mask<float, 4> &a, const lane_mask<float, 4> &b) { return lane_mask<float, 4>(_mm_or_ps(a.m, b.m)); };
+inline lane_mask<float, 4> operator~(const lane_mask<float, 4> &a) { return lane_mask<float, 4>(_mm_xor_ps(a.m, _mm_castsi128_ps(_mm_set1_epi32(-1)))); };
+inline lanes<float, 4> min(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_min_ps(a.m, b.m)); };
+inline lanes<float, 4> max(const lanes<float, 4> &a, const lanes<float, 4> &b) { return lanes<float, 4>(_mm_max_ps(a.m, b.m)); };
+inline lanes<float, 4> sqrt(const lanes<float, 4> &a) { return lanes<float, 4>(_mm_sqrt_ps(a.m)); };
+
+// SSE2 에는 blendv 가 없으므로 and/andnot/or 조합으로 lane 선택
+inline lanes<float, 4> select(const lane_mask<float, 4> &mask, const lanes<float, 4> &a, const lanes<float, 4> &b)
+{
+  return lanes<float, 4>(_mm_or_ps(_mm_and_ps(mask.m, a.m), _mm_andnot_ps(mask.m, b.m)));
+};
+#endif /* RTW_SIMD_SSE2 */
+
+#if defined(RTW_SIMD_AVX)
+/** lanes<float, 8> / lane_mask<float, 8> 의 AVX 특수화 */
+template <>
+class lanes<float, 8>
+{
+public:
+  __m256 m;
+
+  lanes() : m(_mm256_setzero_ps()) {};
+  lanes(float s) : m(_mm256_set1_ps(s)) {};
+  explicit lanes(__m256 m) : m(m) {};
+
+  static lanes load(const float *p) { return lanes(_mm256_loadu_ps(p)); };
+  void store(float *p) const { _mm256_storeu_ps(p, m); };
+
+  float operator[](int i) const
+  {
+    float t[8];
+    _mm256_storeu_ps(t, m);
+    return t[i];
+  };
+};
+
+template <>
+class lane_mask<float, 8>
+{
+public:
+  __m256 m;
+
+  lane_mask() : m(_mm256_setzero_ps()) {};
+  lane_mask(bool b) : m(_mm256_castsi256_ps(_mm256_set1_epi32(b ? -1 : 0))) {};
+  explicit lane_mask(__m256 m) : m(m) {};
+
+  int bits() const { return _mm256_movemask_ps(m); };
+  bool operator[](int i) const { return (bits() >> i) & 1; };
+};
+
+inline lanes<float, 8> operator+(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_add_ps(a.m, b.m)); };
+inline lanes<float, 8> operator-(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_sub_ps(a.m, b.m)); };
+inline lanes<float, 8> operator*(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_mul_ps(a.m, b.m)); };
+inline lanes<float, 8> operator/(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_div_ps(a.m, b.m)); };
+inline lanes<float, 8> operator-(const lanes<float, 8> &a) { return lanes<float, 8>(_mm256_xor_ps(a.m, _mm256_set1_ps(-0.0f))); };
+inline lane_mask<float, 8> operator<(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lane_mask<float, 8>(_mm256_cmp_ps(a.m, b.m, _CMP_LT_OQ)); };
+inline lane_mask<float, 8> operator<=(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lane_mask<float, 8>(_mm256_cmp_ps(a.m, b.m, _CMP_LE_OQ)); };
+inline lane_mask<float, 8> operator>(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lane_mask<float, 8>(_mm256_cmp_ps(a.m, b.m, _CMP_GT_OQ)); };
+inline lane_mask<float, 8> operator>=(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lane_mask<float, 8>(_mm256_cmp_ps(a.m, b.m, _CMP_GE_OQ)); };
+inline lane_mask<float, 8> operator&(const lane_mask<float, 8> &a, const lane_mask<float, 8> &b) { return lane_mask<float, 8>(_mm256_and_ps(a.m, b.m)); };
+inline lane_mask<float, 8> operator|(const lane_mask<float, 8> &a, const lane_mask<float, 8> &b) { return lane_mask<float, 8>(_mm256_or_ps(a.m, b.m)); };
+inline lane_mask<float, 8> operator~(const lane_mask<float, 8> &a) { return lane_mask<float, 8>(_mm256_xor_ps(a.m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))); };
+inline lanes<float, 8> min(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_min_ps(a.m, b.m)); };
+inline lanes<float, 8> max(const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_max_ps(a.m, b.m)); };
+inline lanes<float, 8> sqrt(const lanes<float, 8> &a) { return lanes<float, 8>(_mm256_sqrt_ps(a.m)); };
+inline lanes<float, 8> select(const lane_mask<float, 8> &mask, const lanes<float, 8> &a, const lanes<float, 8> &b) { return lanes<float, 8>(_mm256_blendv_ps(b.m, a.m, mask.m)); };
+
+/** lanes<double, 4> / lane_mask<double, 4> 의 AVX 특수화 */
+template <>
+class lanes<double, 4>
+{
+public:
+  __m256d m;
+
+  lanes() : m(_mm256_setzero_pd()) {};
+  lanes(double s) : m(_mm256_set1_pd(s)) {};
+  explicit lanes(__m256d m) : m(m) {};
+
+  static lanes load(const double *p) { return lanes(_mm256_loadu_pd(p)); };
+  void store(double *p) const { _mm256_storeu_pd(p, m); };
+
+  double operator[](int i) const
+  {
+    double t[4];
+    _mm256_storeu_pd(t, m);
+    return t[i];
+  };
+};
+
+template <>
+class lane_mask<double, 4>
+{
+public:
+  __m256d m;
+
+  lane_mask() : m(_mm256_setzero_pd()) {};
+  lane_mask(bool b) : m(_mm256_castsi256_pd(_mm256_set1_epi64x(b ? -1 : 0))) {};
+  explicit lane_mask(__m256d m) : m(m) {};
+
+  int bits() const { return _mm256_movemask_pd(m); };
+  bool operator[](int i) const { return (bits() >> i) & 1; };
+};
+
+inline lanes<double, 4> operator+(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_add_pd(a.m, b.m)); };
+inline lanes<double, 4> operator-(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_sub_pd(a.m, b.m)); };
+inline lanes<double, 4> operator*(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_mul_pd(a.m, b.m)); };
+inline lanes<double, 4> operator/(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_div_pd(a.m, b.m)); };
+inline lanes<double, 4> operator-(const lanes<double, 4> &a) { return lanes<double, 4>(_mm256_xor_pd(a.m, _mm256_set1_pd(-0.0))); };
+inline lane_mask<double, 4> operator<(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lane_mask<double, 4>(_mm256_cmp_pd(a.m, b.m, _CMP_LT_OQ)); };
+inline lane_mask<double, 4> operator<=(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lane_mask<double, 4>(_mm256_cmp_pd(a.m, b.m, _CMP_LE_OQ)); };
+inline lane_mask<double, 4> operator>(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lane_mask<double, 4>(_mm256_cmp_pd(a.m, b.m, _CMP_GT_OQ)); };
+inline lane_mask<double, 4> operator>=(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lane_mask<double, 4>(_mm256_cmp_pd(a.m, b.m, _CMP_GE_OQ)); };
+inline lane_mask<double, 4> operator&(const lane_mask<double, 4> &a, const lane_mask<double, 4> &b) { return lane_mask<double, 4>(_mm256_and_pd(a.m, b.m)); };
+inline lane_mask<double, 4> operator|(const lane_mask<double, 4> &a, const lane_mask<double, 4> &b) { return lane_mask<double, 4>(_mm256_or_pd(a.m, b.m)); };
+inline lane_mask<double, 4> operator~(const lane_mask<double, 4> &a) { return lane_mask<double, 4>(_mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)))); };
+inline lanes<double, 4> min(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_min_pd(a.m, b.m)); };
+inline lanes<double, 4> max(const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_max_pd(a.m, b.m)); };
+inline lanes<double, 4> sqrt(const lanes<double, 4> &a) { return lanes<double, 4>(_mm256_sqrt_pd(a.m)); };
+inline lanes<double, 4> select(const lane_mask<double, 4> &mask, const lanes<double, 4> &a, const lanes<double, 4> &b) { return lanes<double, 4>(_mm256_blendv_pd(b.m, a.m, mask.m)); };
+
+// float 4개 -> double 4개 변환 (vcvtps2pd 명령어 하나)
+inline lanes<double, 4> widen(const lanes<float, 4> &a) { return lanes<double, 4>(_mm256_cvtps_pd(a.m)); };
+#endif /* RTW_SIMD_AVX */
+
+/**
+ * lanes 타입과 힙 메모리 정렬
+ *
+ *
+ * SSE/AVX 특수화된 lanes / lane_mask 는 __m128(16바이트), __m256(32바이트) 정렬을 요구한다.
+ * 그러나 C++11 의 operator new 와 std::vector 의 기본 allocator 는 16바이트를 넘는 정렬을 보장하지 않으므로,
+ * 8-wide lanes 를 클래스 멤버나 std::vector 원소로 힙에 저장하면 잘못 정렬된 메모리에 aligned load 가 발생할 수 있다.
+ *
+ * 따라서 lanes 는 함수 내부에서 레지스터처럼 사용하는 '계산용 타입'으로만 쓰고,
+ * 힙에 오래 보관할 데이터는 float / double 배열(SoA)로 저장한 뒤 lanes::load() (unaligned load) 로 읽어오도록 한다.
+ */
+
+#endif /* SIMD_HPP */
@@ -0,0 +1,168 @@
+#ifndef TRANSFORM_HPP
+#define TRANSFORM_HPP
+
+#include "rtweekend.hpp"
+
+/**
+ * 3x4 아핀 변환(affine transform) 행렬 클래스
+ *
+ * - 좌측 3x3 부분(m[i][0..2])은 회전/스케일 등의 선형 변환, 마지막 열(m[i][3])은 이동(translation)을 나타낸다.
+ * - 4번째 행은 항상 (0, 0, 0, 1) 이므로 저장하지 않는다. (하단 필기 참고)
+ * - 점(point)은 이동까지 적용하고, 방향벡터(vector)는 선형 변환만 적용한다.
+ */
+class transform
+{
+public:
+  // 단위 행렬(identity)로 초기화
+  transform()
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        m[i][j] = (i == j) ? 1.0 : 0.0;
+      }
+    }
+  };
+
+  // 이동 변환 행렬 생성
+  static transform translation(const vec3 &offset)
+  {
+    transform t;
+    t.m[0][3] = offset.x();
+    t.m[1][3] = offset.y();
+    t.m[2][3] = offset.z();
+    return t;
+  };
+
+  // 축별 스케일 변환 행렬 생성
+  static transform scaling(const vec3 &scale)
+  {
+    transform t;
+    t.m[0][0] = scale.x();
+    t.m[1][1] = scale.y();
+    t.m[2][2] = scale.z();
+    return t;
+  };
+
+  // 임의의 축(axis)을 기준으로 angle(degree) 만큼 회전하는 행렬 생성 (Rodrigues' rotation formula)
+  static transform rotation(const vec3 &axis, double angle)
+  {
+    vec3 a = unit_vector(axis);
+    double radians = degrees_to_radians(angle);
+    double c = std::cos(radians);
+    double s = std::sin(radians);
+    double k = 1.0 - c;
+
+    transform t;
+    t.m[0][0] = c + a.x() * a.x() * k;
+    t.m[0][1] = a.x() * a.y() * k - a.z() * s;
+    t.m[0][2] = a.x() * a.z() * k + a.y() * s;
+    t.m[1][0] = a.y() * a.x() * k + a.z() * s;
+    t.m[1][1] = c + a.y() * a.y() * k;
+    t.m[1][2] = a.y() * a.z() * k - a.x() * s;
+    t.m[2][0] = a.z() * a.x() * k - a.y() * s;
+    t.m[2][1] = a.z() * a.y() * k + a.x() * s;
+    t.m[2][2] = c + a.z() * a.z() * k;
+    return t;
+  };
+
+  // y 축 기준 회전 행렬 생성
+  static transform rotation_y(double angle) { return rotation(vec3(0.0, 1.0, 0.0), angle); };
+
+  // 점 p 에 변환 적용 (선형 변환 + 이동)
+  point3 apply_point(const point3 &p) const
+  {
+    return point3(m[0][0] * p.x() + m[0][1] * p.y() + m[0][2] * p.z() + m[0][3],
+                  m[1][0] * p.x() + m[1][1] * p.y() + m[1][2] * p.z() + m[1][3],
+                  m[2][0] * p.x() + m[2][1] * p.y() + m[2][2] * p.z() + m[2][3]);
+  };
+
+  // 방향벡터 v 에 변환 적용 (선형 변환만 적용, 이동은 무시)
+  vec3 apply_vector(const vec3 &v) const
+  {
+    return vec3(m[0][0] * v.x() + m[0][1] * v.y() + m[0][2] * v.z(),
+                m[1][0] * v.x() + m[1][1] * v.y() + m[1][2] * v.z(),
+                m[2][0] * v.x() + m[2][1] * v.y() + m[2][2] * v.z());
+  };
+
+  // 노멀벡터 n 에 변환 적용
+  // -> 노멀은 역행렬의 전치(inverse transpose)로 변환해야 하므로, 이 함수는 '역변환 행렬' 객체에서 호출해야 함 (하단 필기 참고)
+  vec3 apply_normal_transposed(const vec3 &n) const
+  {
+    return vec3(m[0][0] * n.x() + m[1][0] * n.y() + m[2][0] * n.z(),
+                m[0][1] * n.x() + m[1][1] * n.y() + m[2][1] * n.z(),
+                m[0][2] * n.x() + m[1][2] * n.y() + m[2][2] * n.z());
+  };
+
+  // 역변환 행렬 계산 (선형 변환 부분은 여인수(cofactor)로 역행렬을 구하고, 이동 부분은 -A^-1 * t)
+  // -> 선형 변환 부분이 특이 행렬(행렬식 0, ex> 스케일 0)이면 역변환이 존재하지 않으므로 호출자가 보장해야 함
+  transform inverse() const
+  {
+    double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                 m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                 m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    double inv_det = 1.0 / det;
+
+    transform inv;
+    inv.m[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * inv_det;
+    inv.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv_det;
+    inv.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv_det;
+    inv.m[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * inv_det;
+    inv.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv_det;
+    inv.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv_det;
+    inv.m[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * inv_det;
+    inv.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv_det;
+    inv.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv_det;
+
+    vec3 t = inv.apply_vector(vec3(m[0][3], m[1][3], m[2][3]));
+    inv.m[0][3] = -t.x();
+    inv.m[1][3] = -t.y();
+    inv.m[2][3] = -t.z();
+    return inv;
+  };
+
+public:
+  double m[3][4]; // 3x4 행렬 (row-major)
+};
+
+// 두 아핀 변환의 합성 (a * b 는 b 를 먼저 적용한 뒤 a 를 적용하는 변환)
+inline transform operator*(const transform &a, const transform &b)
+{
+  transform result;
+  for (int i = 0; i < 3; i++)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      result.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j];
+    }
+    result.m[i][3] += a.m[i][3];
+  }
+  return result;
+};
+
+/**
+ * 3x4 아핀 변환 행렬
+ *
+ *
+ * 동차 좌표계(homogeneous coordinates)에서 아핀 변환은 4x4 행렬로 표현되지만,
+ * 아핀 변환의 마지막 행은 항상 (0, 0, 0, 1) 이므로 3x4 만 저장해도 충분하다.
+ * -> 메모리를 25% 아끼고, 곱셈 시에도 마지막 행 계산을 생략할 수 있음.
+ *
+ * 점 p = (x, y, z, 1) 은 w = 1 이므로 마지막 열(이동)의 영향을 받고,
+ * 방향벡터 v = (x, y, z, 0) 은 w = 0 이므로 이동의 영향을 받지 않는다.
+ *
+ *
+ * 노멀벡터 변환
+ *
+ *
+ * 노멀벡터는 표면의 접선벡터(tangent)와 항상 수직이어야 한다. (dot(n, tangent) = 0)
+ * 접선벡터는 일반 방향벡터처럼 M 으로 변환되므로, 변환 후에도 수직을 유지하려면
+ * 노멀벡터는 (M^-1)^T 로 변환해야 한다. → dot((M^-1)^T n, M t) = dot(n, M^-1 M t) = dot(n, t) = 0
+ *
+ * 회전만 있는 경우 (M^-1)^T = M 이지만, 비균일 스케일(ex> x 축만 2배)이 섞이면 M 으로 노멀을 변환하면 방향이 틀어진다.
+ * 그래서 apply_normal_transposed() 는 역변환 행렬 객체에서 호출하여 (M^-1)^T 를 적용하도록 설계했다.
+ * (변환 후 길이가 1 이 아닐 수 있으므로 호출자가 다시 정규화해야 함)
+ */
+
+#endif /* TRANSFORM_HPP */
@@ -1,6 +1,8 @@
 #ifndef VEC3_HPP
 #define VEC3_HPP
 
+#include "simd.hpp"
+
 // using 을 이용해서 namespace 안의 특정 함수만 가져올 수 있음.
 using std::sqrt;
 
@@ -8,19 +10,49 @@ using std::sqrt;
 class vec3
 {
 public:
+#if defined(RTW_SIMD_AVX)
+  // AVX 백엔드: 4-lane 레지스터(__m256d)에 그대로 load/store 할 수 있도록 padding lane 을 하나 더 둔 배열로 선언 (하단 필기 참고)
+  alignas(16) double e[4];
+#else
   double e[3]; // vec3 의 세 컴포넌트 멤버변수를 double 타입 배열로 선언
+#endif
 
-  // vec3 생성자 선언
+  // vec3 생성자 선언 (AVX 백엔드에서 지정되지 않은 padding lane 은 aggregate 초기화 규칙에 따라 0 으로 채워짐)
   vec3() : e{0, 0, 0} {}                                   // 매개변수가 없는 기본생성자 > 영벡터로 초기화
   vec3(double e0, double e1, double e2) : e{e0, e1, e2} {} // vec3 의 세 컴포넌트를 직접 매개변수로 전달받을 때의 생성자 오버로딩
 
+#if defined(RTW_SIMD_AVX)
+  // 4-lane 레지스터 값으로부터 vec3 를 생성하는 생성자 (SIMD 연산 결과를 다시 vec3 로 저장할 때 사용)
+  explicit vec3(__m256d m) { _mm256_storeu_pd(e, m); }
+
+  // vec3 컴포넌트들을 4-lane 레지스터로 읽어오는 함수
+  __m256d simd() const { return _mm256_loadu_pd(e); }
+
+  // 4-lane 레지스터의 앞쪽 3개 lane 만 더하는 수평 합(horizontal sum) -> padding lane 값은 결과에 영향을 주지 않음
+  static double hsum3(__m256d m)
+  {
+    __m128d xy = _mm256_castpd256_pd128(m);
+    __m128d zw = _mm256_extractf128_pd(m, 1);
+    __m128d sum = _mm_add_sd(xy, _mm_unpackhi_pd(xy, xy));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, zw));
+  }
+#endif
+
   // vec3 각 컴포넌트에 대한 getter 메서드
   double x() const { return e[0]; }
   double y() const { return e[1]; }
   double z() const { return e[2]; }
 
   // -연산자 오버로딩
-  vec3 operator-() const { return vec3(-e[0], -e[1], -e[2]); }
+  vec3 operator-() const
+  {
+#if defined(RTW_SIMD_AVX)
+    // 부호 비트만 뒤집어서 세 컴포넌트를 한 번에 반전
+    return vec3(_mm256_xor_pd(simd(), _mm256_set1_pd(-0.0)));
+#else
+    return vec3(-e[0], -e[1], -e[2]);
+#endif
+  }
 
   // [] 연산자 오버로딩
   /**
@@ -34,19 +66,29 @@ public:
   // 연산자 오버로딩 시, 메서드 체이닝을 사용할 수 있도록 객체 자신의 포인터(this) 반환
   vec3 &operator+=(const vec3 &v)
   {
+#if defined(RTW_SIMD_AVX)
+    _mm256_storeu_pd(e, _mm256_add_pd(simd(), v.simd()));
+    return *this;
+#else
     e[0] += v.e[0];
     e[1] += v.e[1];
     e[2] += v.e[2];
     return *this;
+#endif
   }
 
   // *= 연산자 오버로딩
   vec3 &operator*=(double t)
   {
+#if defined(RTW_SIMD_AVX)
+    _mm256_storeu_pd(e, _mm256_mul_pd(simd(), _mm256_set1_pd(t)));
+    return *this;
+#else
     e[0] *= t;
     e[1] *= t;
     e[2] *= t;
     return *this;
+#endif
   }
 
   // /= 연산자 오버로딩
@@ -63,7 +105,12 @@ public:
 
   double length_squared() const
   {
+#if defined(RTW_SIMD_AVX)
+    auto m = simd();
+    return hsum3(_mm256_mul_pd(m, m));
+#else
     return e[0] * e[0] + e[1] * e[1] + e[2] * e[2];
+#endif
   }
 
   // 현재 벡터의 영벡터 여부 검사 함수
@@ -101,25 +148,41 @@ inline std::ostream &operator<<(std::ostream &out, const vec3 &v)
 // + 연산자 오버로딩
 inline vec3 operator+(const vec3 &u, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX)
+  return vec3(_mm256_add_pd(u.simd(), v.simd()));
+#else
   return vec3(u.e[0] + v.e[0], u.e[1] + v.e[1], u.e[2] + v.e[2]);
+#endif
 }
 
 // - 연산자 오버로딩
 inline vec3 operator-(const vec3 &u, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX)
+  return vec3(_mm256_sub_pd(u.simd(), v.simd()));
+#else
   return vec3(u.e[0] - v.e[0], u.e[1] - v.e[1], u.e[2] - v.e[2]);
+#endif
 }
 
 // * 연산자 오버로딩
 inline vec3 operator*(const vec3 &u, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX)
+  return vec3(_mm256_mul_pd(u.simd(), v.simd()));
+#else
   return vec3(u.e[0] * v.e[0], u.e[1] * v.e[1], u.e[2] * v.e[2]);
+#endif
 }
 
 // 매개변수에 따른 * 연산자 오버로딩 세분화
 inline vec3 operator*(double t, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX)
+  return vec3(_mm256_mul_pd(_mm256_set1_pd(t), v.simd()));
+#else
   return vec3(t * v.e[0], t * v.e[1], t * v.e[2]);
+#endif
 }
 
 inline vec3 operator*(const vec3 &v, double t)
@@ -137,20 +200,34 @@ inline vec3 operator/(vec3 v, double t)
 // 벡터 내적 연산
 inline double dot(const vec3 &u, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX)
+  return vec3::hsum3(_mm256_mul_pd(u.simd(), v.simd()));
+#else
   return u.e[0] * v.e[0] + u.e[1] * v.e[1] + u.e[2] * v.e[2];
+#endif
 }
 
 // 벡터 외적 연산
 inline vec3 cross(const vec3 &u, const vec3 &v)
 {
+#if defined(RTW_SIMD_AVX2)
+  // u.yzx * v.zxy - u.zxy * v.yzx 를 lane 간 permute 로 계산 (permute4x64 는 AVX2 명령어)
+  __m256d u_yzx = _mm256_permute4x64_pd(u.simd(), _MM_SHUFFLE(3, 0, 2, 1));
+  __m256d u_zxy = _mm256_permute4x64_pd(u.simd(), _MM_SHUFFLE(3, 1, 0, 2));
+  __m256d v_yzx = _mm256_permute4x64_pd(v.simd(), _MM_SHUFFLE(3, 0, 2, 1));
+  __m256d v_zxy = _mm256_permute4x64_pd(v.simd(), _MM_SHUFFLE(3, 1, 0, 2));
+  return vec3(_mm256_sub_pd(_mm256_mul_pd(u_yzx, v_zxy), _mm256_mul_pd(u_zxy, v_yzx)));
+#else
   return vec3(u.e[1] * v.e[2] - u.e[2] * v.e[1],
               u.e[2] * v.e[0] - u.e[0] * v.e[2],
               u.e[0] * v.e[1] - u.e[1] * v.e[0]);
+#endif
 }
 
 // 벡터 정규화 연산
 inline vec3 unit_vector(vec3 v)
 {
+  // 길이의 역수를 한 번만 계산한 뒤 broadcast 곱셈으로 세 컴포넌트를 동시에 정규화
   return v / v.length();
 }
 
@@ -284,4 +361,27 @@ inline vec3 refract(const vec3 &uv, const vec3 &n, double etai_over_etat)
  * 1e-160 보다 길이 제곱값이 작은 sample 도 rejection 하는 것!
  */
 
+/**
+ * vec3 의 SIMD(AVX) 백엔드
+ *
+ *
+ * RTW_USE_SIMD 로 빌드하고 컴파일러에서 AVX 가 활성화되어 있으면(RTW_SIMD_AVX),
+ * vec3 는 double 3개 대신 padding lane 을 포함한 double 4개 배열로 저장된다.
+ *
+ * 이렇게 하면 +, -, *, 스칼라 곱, dot, length, unit_vector(정규화) 등이
+ * 4-lane 레지스터(__m256d) 하나로 처리되어, 컴포넌트별 스칼라 연산 3번이 SIMD 연산 1번으로 줄어든다.
+ * (cross 는 lane 간 permute 가 필요하므로 AVX2 가 있을 때만 SIMD 경로를 사용)
+ *
+ * padding lane 은 항상 0 으로 초기화되지만, 0 으로 나누기 등으로 NaN 이 섞일 수 있으므로
+ * dot / length_squared 의 수평 합(hsum3)은 앞쪽 3개 lane 만 더하도록 구현했다.
+ *
+ * 배열을 alignas(32) 가 아닌 alignas(16) 로 선언하고 unaligned load/store(_mm256_loadu_pd)를 사용하는 이유는,
+ * 이 프로젝트가 C++11 로 빌드되기 때문이다.
+ * C++11 의 operator new(std::make_shared 포함)는 alignof(std::max_align_t)(= 16바이트)를 넘는 정렬을 보장하지 않으므로,
+ * vec3 를 멤버로 가지는 sphere, quad 등이 힙에 할당될 때 32바이트 정렬을 가정한 aligned load 가 잘못된 주소를 읽을 수 있다.
+ * (최신 CPU 에서는 실제로 정렬된 주소에 대한 unaligned load 의 비용이 aligned load 와 동일함)
+ *
+ * RTW_USE_SIMD 를 정의하지 않거나 AVX 를 지원하지 않는 환경에서는 기존 스칼라 구현이 그대로 사용된다.
+ */
+
 #endif /* VEC3_HPP */
@@ -0,0 +1,195 @@
+#ifndef VEC3XN_HPP
+#define VEC3XN_HPP
+
+#include "simd.hpp"
+#include "vec3.hpp"
+
+/**
+ * vec3xn<T, N> 클래스
+ *
+ * N 개의 vec3 를 구조체 배열(AoS)이 아닌 배열의 구조체(SoA, Structure of Arrays) 형태로 묶어서 저장하는 wide-vector 타입.
+ * - x, y, z 각 컴포넌트가 lanes<T, N> 하나씩에 저장되므로, N 개 벡터에 대한 동일 연산을 SIMD 명령어 한 번으로 처리한다.
+ * - 여러 개의 광선(packet) 또는 여러 개의 primitive(ex> 구체 4개/8개)에 대한 교차 검사나 shading 을 한 번에 계산할 때 사용된다.
+ * - 산술 연산자(lane 별 값 / 모든 lane 공통 스칼라 버전)와 dot, cross, unit_vector 는 vec3.hpp 의 scalar vec3 와 같은 구성으로 맞춤.
+ */
+template <typename T, int N>
+class vec3xn
+{
+public:
+  using lane_type = lanes<T, N>;
+  using mask_type = lane_mask<T, N>;
+
+  lane_type x, y, z; // N 개 벡터의 x, y, z 컴포넌트 (SoA)
+
+  // 영벡터 N 개로 초기화
+  vec3xn() {};
+
+  // 각 컴포넌트 lane 묶음을 직접 지정
+  vec3xn(const lane_type &x, const lane_type &y, const lane_type &z) : x(x), y(y), z(z) {};
+
+  // 하나의 scalar vec3 를 N 개 lane 모두에 broadcast (ex> 광선 하나를 N 개의 primitive 와 동시에 검사할 때)
+  explicit vec3xn(const vec3 &v) : x(T(v.x())), y(T(v.y())), z(T(v.z())) {};
+
+  // SoA 배열(xs, ys, zs)의 offset 위치에서 N 개 벡터를 읽어옴
+  static vec3xn load(const T *xs, const T *ys, const T *zs)
+  {
+    return vec3xn(lane_type::load(xs), lane_type::load(ys), lane_type::load(zs));
+  };
+
+  // i 번째 lane 의 벡터를 scalar vec3 로 추출
+  vec3 get(int i) const { return vec3(x[i], y[i], z[i]); };
+
+  vec3xn operator-() const { return vec3xn(-x, -y, -z); };
+
+  vec3xn &operator+=(const vec3xn &v)
+  {
+    x = x + v.x;
+    y = y + v.y;
+    z = z + v.z;
+    return *this;
+  };
+
+  vec3xn &operator*=(const lane_type &t)
+  {
+    x = x * t;
+    y = y * t;
+    z = z * t;
+    return *this;
+  };
+
+  vec3xn &operator*=(T t) { return *this *= lane_type(t); };
+
+  // scalar vec3 와 같이 역수를 한 번 구해서 곱함
+  vec3xn &operator/=(const lane_type &t) { return *this *= lane_type(T(1)) / t; };
+  vec3xn &operator/=(T t) { return *this *= lane_type(T(1) / t); };
+
+  lane_type length_squared() const { return x * x + y * y + z * z; };
+  lane_type length() const { return sqrt(length_squared()); };
+};
+
+// 자주 사용하는 4-wide / 8-wide 별칭 (lane 타입 T 는 float 또는 double)
+template <typename T>
+using vec3x4 = vec3xn<T, 4>;
+template <typename T>
+using vec3x8 = vec3xn<T, 8>;
+
+/** vec3xn 관련 연산자 오버로딩 (lane 별로 scalar vec3 와 동일한 의미) */
+template <typename T, int N>
+inline vec3xn<T, N> operator+(const vec3xn<T, N> &u, const vec3xn<T, N> &v)
+{
+  return vec3xn<T, N>(u.x + v.x, u.y + v.y, u.z + v.z);
+};
+
+template <typename T, int N>
+inline vec3xn<T, N> operator-(const vec3xn<T, N> &u, const vec3xn<T, N> &v)
+{
+  return vec3xn<T, N>(u.x - v.x, u.y - v.y, u.z - v.z);
+};
+
+template <typename T, int N>
+inline vec3xn<T, N> operator*(const vec3xn<T, N> &u, const vec3xn<T, N> &v)
+{
+  return vec3xn<T, N>(u.x * v.x, u.y * v.y, u.z * v.z);
+};
+
+// lane 별 스칼라 곱 (N 개의 벡터에 서로 다른 스칼라를 곱함)
+template <typename T, int N>
+inline vec3xn<T, N> operator*(const lanes<T, N> &t, const vec3xn<T, N> &v)
+{
+  return vec3xn<T, N>(t * v.x, t * v.y, t * v.z);
+};
+
+template <typename T, int N>
+inline vec3xn<T, N> operator*(const vec3xn<T, N> &v, const lanes<T, N> &t)
+{
+  return t * v;
+};
+
+// 모든 lane 에 동일한 스칼라 곱
+template <typename T, int N>
+inline vec3xn<T, N> operator*(T t, const vec3xn<T, N> &v)
+{
+  return lanes<T, N>(t) * v;
+};
+
+template <typename T, int N>
+inline vec3xn<T, N> operator*(const vec3xn<T, N> &v, T t)
+{
+  return lanes<T, N>(t) * v;
+};
+
+template <typename T, int N>
+inline vec3xn<T, N> operator/(const vec3xn<T, N> &v, const lanes<T, N> &t)
+{
+  return (lanes<T, N>(T(1)) / t) * v;
+};
+
+// 모든 lane 을 동일한 스칼라로 나눔
+template <typename T, int N>
+inline vec3xn<T, N> operator/(const vec3xn<T, N> &v, T t)
+{
+  return (T(1) / t) * v;
+};
+
+/** vec3xn 연산 관련 util 함수 */
+// lane 별 벡터 내적 연산
+template <typename T, int N>
+inline lanes<T, N> dot(const vec3xn<T, N> &u, const vec3xn<T, N> &v)
+{
+  return u.x * v.x + u.y * v.y + u.z * v.z;
+};
+
+// lane 별 벡터 외적 연산 (SoA 형태이므로 scalar vec3 와 달리 lane 간 shuffle 이 필요 없음)
+template <typename T, int N>
+inline vec3xn<T, N> cross(const vec3xn<T, N> &u, const vec3xn<T, N> &v)
+{
+  return vec3xn<T, N>(u.y * v.z - u.z * v.y,
+                      u.z * v.x - u.x * v.z,
+                      u.x * v.y - u.y * v.x);
+};
+
+// lane 별 벡터 정규화 연산
+template <typename T, int N>
+inline vec3xn<T, N> unit_vector(const vec3xn<T, N> &v)
+{
+  return v / v.length();
+};
+
+// mask 가 참인 lane 은 a 의 벡터, 거짓인 lane 은 b 의 벡터를 선택
+template <typename T, int N>
+inline vec3xn<T, N> select(const lane_mask<T, N> &mask, const vec3xn<T, N> &a, const vec3xn<T, N> &b)
+{
+  return vec3xn<T, N>(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z));
+};
+
+// 컴포넌트 별 최솟값 (AABB 의 min 코너 누적 등에 사용)
+template <typename T, int N>
+inline vec3xn<T, N> min(const vec3xn<T, N> &a, const vec3xn<T, N> &b)
+{
+  return vec3xn<T, N>(min(a.x, b.x), min(a.y, b.y), min(a.z, b.z));
+};
+
+// 컴포넌트 별 최댓값 (AABB 의 max 코너 누적 등에 사용)
+template <typename T, int N>
+inline vec3xn<T, N> max(const vec3xn<T, N> &a, const vec3xn<T, N> &b)
+{
+  return vec3xn<T, N>(max(a.x, b.x), max(a.y, b.y), max(a.z, b.z));
+};
+
+/**
+ * AoS vs SoA
+ *
+ *
+ * scalar vec3 는 (x, y, z) 가 한 덩어리로 붙어 있는 AoS(Array of Structures) 형태이므로,
+ * SIMD 레지스터에 vec3 하나를 올려도 4개 lane 중 3개만 의미 있는 값이고,
+ * dot 처럼 컴포넌트끼리 더해야 하는 연산은 lane 간 수평 합(horizontal add)이 필요해서 효율이 떨어진다.
+ *
+ * 반면, vec3xn 은 N 개 벡터의 x 들만, y 들만, z 들만 각각 하나의 레지스터에 모은 SoA(Structure of Arrays) 형태이므로,
+ * 모든 lane 이 서로 다른 벡터의 같은 컴포넌트를 담고 있다.
+ * 따라서 dot, cross 등 모든 연산이 lane 간 이동 없이 '세로 방향(vertical)' 연산만으로 처리되고,
+ * N 개의 광선 또는 N 개의 primitive 에 대한 계산이 거의 scalar 1회 비용으로 끝난다.
+ *
+ * 이 타입은 packet traversal, SoA sphere 묶음 교차 검사, 벡터화된 shading 등의 기반으로 사용된다.
+ */
+
+#endif /* VEC3XN_HPP */
@@ -202,7 +202,7 @@ private:
     r0 = r0 * r0;
 
     // 기본 반사율 F0 기반 Schlick's Approximation 으로 반사율 근사
-    return r0 + (1.0f - r0) * std::pow((1.0f - cosine), 5);
+    return r0 + (1.0f - r0) * rtw_pow<5>(1.0f - cosine);
   };
 };
 
@@ -147,7 +147,7 @@ public:
     // return color(1.0f, 1.0f, 1.0f) * noise.turb(p, 7);
 
     /** z축 방향 sin 파형에 turbulence noise 를 더해 위상(phase)을 불규칙하게 흔든 marble 무늬 생성 (하단 필기 참고) */
-    return color(0.5f, 0.5f, 0.5f) * (1.0f + std::sin(scale * p.z() + 10.0f * noise.turb(p, 7)));
+    return color(0.5f, 0.5f, 0.5f) * (1.0f + rtw_sin(scale * p.z() + 10.0f * noise.turb(p, 7)));
   };
 
 private:
@@ -0,0 +1,252 @@
+#ifndef BOX_HPP
+#define BOX_HPP
+
+#include "hittable.hpp"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// box 의 여섯 면 인덱스 (축 * 2 + (max 쪽 면이면 1)) → per-face material 배열 인덱스로 사용
+enum class box_face : int
+{
+  left = 0,   // x = min 면 (법선 -x)
+  right = 1,  // x = max 면 (법선 +x)
+  bottom = 2, // y = min 면 (법선 -y)
+  top = 3,    // y = max 면 (법선 +y)
+  back = 4,   // z = min 면 (법선 -z)
+  front = 5,  // z = max 면 (법선 +z)
+};
+
+/**
+ * 축 정렬 박스(axis-aligned box) 클래스
+ *
+ * - quad 6개로 구성된 hittable_list 대신, 박스 하나를 slab test 한 번으로 교차 검사하는 primitive.
+ *   (quad 6개는 면마다 평면 교차 + 내부 판정을 반복하고, BVH 입장에서도 primitive 6개로 취급됨)
+ * - slab test 에서 t 가 결정된 축(진입 축 또는 탈출 축)이 곧 교차한 면이므로, 법선과 uv 는 그 축에서 바로 계산한다.
+ * - 면마다 다른 material 을 지정할 수 있다. (box_face 순서의 6개 material)
+ * - 법선 방향과 uv 좌표의 방향은 기존 quad 기반 box() 의 면 구성(Q, u, v)과 동일하게 맞춰서, 같은 scene 은 같은 이미지를 만든다.
+ */
+class axis_aligned_box : public hittable
+{
+public:
+  // 두 대각선 정점 a, b 와 여섯 면 공통 재질 mat 으로 박스 생성
+  axis_aligned_box(const point3 &a, const point3 &b, std::shared_ptr<material> mat)
+  {
+    for (int face = 0; face < 6; face++)
+    {
+      face_mat[face] = mat;
+    }
+    set_bounds(a, b);
+  };
+
+  // 두 대각선 정점 a, b 와 면별 재질(box_face 순서)로 박스 생성
+  axis_aligned_box(const point3 &a, const point3 &b, const std::shared_ptr<material> (&face_materials)[6])
+  {
+    for (int face = 0; face < 6; face++)
+    {
+      face_mat[face] = face_materials[face];
+    }
+    set_bounds(a, b);
+  };
+
+  // 지정한 면의 재질 교체
+  void set_face_material(box_face face, std::shared_ptr<material> mat) { face_mat[static_cast<int>(face)] = mat; };
+
+  aabb bounding_box() const override { return bbox; };
+
+  // 순수 가상 함수 hit 재정의(override)
+  // -> 교차 t 계산(intersect)과 충돌 정보 계산(finalize) 두 단계로 나누어 수행 (leaf_primitives.hpp 하단 필기 '교차 t 탐색과 충돌 정보 계산의 분리' 참고)
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    double t;
+    if (!intersect(r, ray_t, t))
+    {
+      return false;
+    }
+    finalize(r, t, rec);
+    return true;
+  };
+
+  // slab test 결과만으로 차폐 여부 판정 (법선, uv, material 계산 생략)
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    double t;
+    return intersect(r, ray_t, t);
+  };
+
+  // 1단계: slab test 로 교차 t 만 계산 (면, 법선, uv, material 은 계산하지 않음)
+  bool intersect(const ray &r, interval ray_t, double &t) const
+  {
+    double t_enter, t_exit;
+    int enter_axis, exit_axis;
+    if (!slab(r, t_enter, t_exit, enter_axis, exit_axis))
+    {
+      return false;
+    }
+
+    /** 진입 지점이 유효 구간 안이면 진입 면, 아니면(광선 시작점이 박스 내부) 탈출 면과 교차 */
+    // quad::hit() 과 같이 구간 양 끝을 포함(contains)하는 기준으로 판정
+    if (ray_t.contains(t_enter))
+    {
+      t = t_enter;
+      return true;
+    }
+    if (ray_t.contains(t_exit))
+    {
+      t = t_exit;
+      return true;
+    }
+    return false;
+  };
+
+  // 2단계: intersect() 로 찾은 t 로 교차 면을 결정하고 교차점, 법선, uv, material 을 hit_record 에 기록
+  void finalize(const ray &r, double t, hit_record &rec) const
+  {
+    // slab test 를 다시 수행하여 t 가 진입 t 인지 탈출 t 인지로 교차 면 결정 (같은 광선이므로 intersect() 와 같은 값이 계산됨)
+    double t_enter, t_exit;
+    int enter_axis, exit_axis;
+    slab(r, t_enter, t_exit, enter_axis, exit_axis);
+
+    int face;
+    if (t == t_enter)
+    {
+      // 양의 방향으로 진행하는 광선은 min 쪽 면으로 진입
+      face = enter_axis * 2 + (r.direction()[enter_axis] < 0.0f ? 1 : 0);
+    }
+    else
+    {
+      // 양의 방향으로 진행하는 광선은 max 쪽 면으로 탈출
+      face = exit_axis * 2 + (r.direction()[exit_axis] < 0.0f ? 0 : 1);
+    }
+
+    rec.t = t;
+    rec.p = r.at(t);
+    rec.mat = face_mat[face].get();
+    face_uv(face, rec.p, rec.u, rec.v);
+
+    // 교차한 면의 바깥쪽 법선 (축 방향 단위 벡터)
+    vec3 outward_normal(0.0f, 0.0f, 0.0f);
+    outward_normal[face >> 1] = (face & 1) ? 1.0f : -1.0f;
+    rec.set_face_normal(r, outward_normal);
+  };
+
+private:
+  // 두 정점 중 작은 값을 min, 큰 값을 max 로 정리하고 크기 및 AABB 캐싱
+  void set_bounds(const point3 &a, const point3 &b)
+  {
+    box_min = point3(std::fmin(a.x(), b.x()), std::fmin(a.y(), b.y()), std::fmin(a.z(), b.z()));
+    box_max = point3(std::fmax(a.x(), b.x()), std::fmax(a.y(), b.y()), std::fmax(a.z(), b.z()));
+    extent = box_max - box_min;
+    bbox = aabb(box_min, box_max);
+  };
+
+  /**
+   * 광선과 박스의 세 슬랩 교차 구간을 구해서, 광선이 박스에 들어가는 t(t_enter)와 나오는 t(t_exit),
+   * 그리고 각각을 결정한 축(enter_axis, exit_axis)을 반환 (하단 필기 참고)
+   * → 광선 직선이 박스를 지나지 않으면 false 반환
+   */
+  bool slab(const ray &r, double &t_enter, double &t_exit, int &enter_axis, int &exit_axis) const
+  {
+    const point3 &origin = r.origin();
+    const vec3 &direction = r.direction();
+
+    t_enter = -std::numeric_limits<double>::infinity();
+    t_exit = std::numeric_limits<double>::infinity();
+    enter_axis = 0;
+    exit_axis = 0;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      // 방향 성분이 0 이면 역수가 ±inf 가 되어, 슬랩 밖의 광선은 빈 구간, 슬랩 안의 광선은 (-inf, inf) 구간이 된다.
+      double inv_d = 1.0f / direction[axis];
+      double t0 = (box_min[axis] - origin[axis]) * inv_d;
+      double t1 = (box_max[axis] - origin[axis]) * inv_d;
+      if (inv_d < 0.0f)
+      {
+        std::swap(t0, t1);
+      }
+
+      // 진입 t 는 세 슬랩 진입 t 중 최댓값, 탈출 t 는 세 슬랩 탈출 t 중 최솟값
+      // (광선이 슬랩 경계 평면 위에서 평행하면 0 * inf = NaN 이 되어 비교가 false → 해당 축은 구간을 좁히지 않음)
+      if (t0 > t_enter)
+      {
+        t_enter = t0;
+        enter_axis = axis;
+      }
+      if (t1 < t_exit)
+      {
+        t_exit = t1;
+        exit_axis = axis;
+      }
+    }
+    return t_enter <= t_exit;
+  };
+
+  // 교차 면과 교차점으로부터 uv 계산 (quad 기반 box() 의 각 면 기준점 Q 와 변 벡터 u, v 방향을 그대로 따름)
+  void face_uv(int face, const point3 &p, double &u, double &v) const
+  {
+    switch (static_cast<box_face>(face))
+    {
+    case box_face::left: // Q = (min x, min y, min z), u = +dz, v = +dy
+      u = (p.z() - box_min.z()) / extent.z();
+      v = (p.y() - box_min.y()) / extent.y();
+      break;
+    case box_face::right: // Q = (max x, min y, max z), u = -dz, v = +dy
+      u = (box_max.z() - p.z()) / extent.z();
+      v = (p.y() - box_min.y()) / extent.y();
+      break;
+    case box_face::bottom: // Q = (min x, min y, min z), u = +dx, v = +dz
+      u = (p.x() - box_min.x()) / extent.x();
+      v = (p.z() - box_min.z()) / extent.z();
+      break;
+    case box_face::top: // Q = (min x, max y, max z), u = +dx, v = -dz
+      u = (p.x() - box_min.x()) / extent.x();
+      v = (box_max.z() - p.z()) / extent.z();
+      break;
+    case box_face::back: // Q = (max x, min y, min z), u = -dx, v = +dy
+      u = (box_max.x() - p.x()) / extent.x();
+      v = (p.y() - box_min.y()) / extent.y();
+      break;
+    default: // box_face::front, Q = (min x, min y, max z), u = +dx, v = +dy
+      u = (p.x() - box_min.x()) / extent.x();
+      v = (p.y() - box_min.y()) / extent.y();
+      break;
+    }
+  };
+
+private:
+  point3 box_min, box_max;               // 박스의 최소/최대 정점
+  vec3 extent;                           // 박스의 축별 크기 (uv 정규화용)
+  std::shared_ptr<material> face_mat[6]; // 면별 material (box_face 순서)
+  aabb bbox;                             // 박스를 감싸는 AABB (두께 0 인 축은 aabb 생성자에서 padding 됨)
+};
+
+// 3D 박스 생성 함수: 두 대각선 정점 a, b와 재질 mat을 받아 축 정렬 박스 primitive 하나를 반환
+inline std::shared_ptr<axis_aligned_box> box(const point3 &a, const point3 &b, std::shared_ptr<material> mat)
+{
+  return std::make_shared<axis_aligned_box>(a, b, mat);
+};
+
+/**
+ * 박스 교차 검사: slab test 한 번 vs quad 6개
+ *
+ *
+ * quad 기반 box() 는 박스를 quad 6개가 담긴 hittable_list 로 만들기 때문에, 광선 하나가 박스를 검사할 때마다
+ * 1. 면 6개 각각에 대해 평면 교차 t 계산 + 외적 두 번으로 uv 계산 + 내부 판정을 반복하고,
+ * 2. 면마다 가상 함수 호출이 일어나며, BVH 에서도 primitive 6개(또는 hittable_list 하나)로 취급된다.
+ *
+ * 축 정렬 박스는 AABB 의 slab test 와 같은 방식으로 한 번에 처리할 수 있다.
+ *    - 축마다 t0 = (min - o) / d, t1 = (max - o) / d 를 계산하고 (d < 0 이면 두 값을 교환)
+ *    - t_enter = max(t0_x, t0_y, t0_z), t_exit = min(t1_x, t1_y, t1_z)
+ *    - t_enter <= t_exit 이면 광선 직선이 박스를 지난다.
+ *
+ * 이때 t_enter 를 결정한 축이 광선이 들어간 면의 축이고, t_exit 를 결정한 축이 나온 면의 축이다.
+ * 면의 min/max 쪽은 그 축의 광선 방향 부호로 정해지므로, 교차 면 → 법선(±축) → uv → 면별 material 이 분기 몇 개로 바로 결정된다.
+ *
+ * ✅ 광선 시작점이 박스 내부(t_enter < ray_t.min)이면 탈출 면을 교차 면으로 사용한다. (quad 6개 버전에서 안쪽 면을 맞히는 것과 동일)
+ * ✅ quad 처럼 인접한 두 면의 경계에서 반올림 오차로 두 면 모두 내부 판정에 실패하는 틈(crack)이 생기지 않는다.
+ * ⚠️ 축 정렬 박스 전용이다. 회전된 박스는 make_transformed()(또는 BLAS 를 공유하는 instance)로 광선을 박스 로컬 좌표계로 변환해서 사용한다.
+ * ⚠️ 두께가 0 인 축이 있는 박스(평면)는 uv 계산에서 0 으로 나누므로, 평면은 quad 를 사용한다.
+ */
+
+#endif /* BOX_HPP */
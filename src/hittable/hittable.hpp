@@ -18,7 +18,7 @@ class hit_record
 public:
   point3 p;                      // 반직선과 충돌한 지점의 좌표값
   vec3 normal;                   // 반직선과 충돌한 지점의 노멀벡터
-  std::shared_ptr<material> mat; // 반직선과 충돌한 object 지점의 산란 계산 시 적용할 material 을 가리키는 포인터
+  const material *mat = nullptr; // 반직선과 충돌한 object 지점의 산란 계산 시 적용할 material (소유하지 않는 포인터, 하단 필기 참고)
   double t;                      // 반직선 상에서 충돌한 지점이 위치한 비율값 t
   double u;                      // 반직선과 충돌한 지점의 uv 좌표값
   double v;                      // 반직선과 충돌한 지점의 uv 좌표값
@@ -47,6 +47,18 @@ public:
 
   // 현재 hittable 객체를 감싸는 AABB 를 반환하는 순수 가상함수 인터페이스 정의
   virtual aabb bounding_box() const = 0;
+
+  // 셔터 구간 내 특정 시점(time)의 AABB 반환 (motion_bvh 가 셔터 시작/끝 시점의 노드 AABB 를 구할 때 사용)
+  // -> 기본 구현은 셔터 구간 전체를 감싸는 bounding_box() 를 그대로 반환하며, 선형으로 움직이는 hittable 은 해당 시점의 AABB 로 재정의할 수 있음
+  virtual aabb bounding_box_at(double) const { return bounding_box(); };
+
+  // 광선이 ray_t 범위 내에서 무엇이든 하나라도 교차하는지만 검사하는 가시성(any-hit) 질의 (하단 필기 '차폐 검사' 참고)
+  // -> 기본 구현은 hit() 을 그대로 사용하며, 하위 클래스는 hit_record 계산과 가장 가까운 교차점 탐색을 생략하도록 재정의할 수 있음
+  virtual bool occluded(const ray &r, interval ray_t) const
+  {
+    hit_record rec;
+    return hit(r, ray_t, rec);
+  };
 };
 
 /**
@@ -103,6 +115,12 @@ public:
     return true;
   };
 
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    // 충돌 지점을 복원할 필요가 없으므로 로컬 좌표계 ray 로 변환해서 그대로 위임
+    return object->occluded(ray(r.origin() - offset, r.direction(), r.time()), ray_t);
+  };
+
   /**
    * 내부 object 의 월드 좌표계 기준 AABB를 반환
    * BVH 등의 외부 구조에서 사용될 AABB는 반드시 월드 좌표 기준이어야 하므로, offset 적용됨.
@@ -110,12 +128,52 @@ public:
    */
   aabb bounding_box() const override { return bbox; };
 
+  // 내부 object 의 time 시점 AABB 에 offset 적용
+  aabb bounding_box_at(double time) const override { return object->bounding_box_at(time) + offset; };
+
+  // 감싸고 있는 로컬 좌표계 object 와 이동량 반환 (연속된 변환 래퍼를 행렬 하나로 합칠 때 사용)
+  const std::shared_ptr<hittable> &inner() const { return object; };
+  const vec3 &translation() const { return offset; };
+
 private:
   std::shared_ptr<hittable> object; // 로컬 좌표계 기준으로 정의된 실제 hittable object
   vec3 offset;                      // object가 이동된 것처럼 보이게 할 translation vector -> 실제로는 월드 좌표계 ray 원점이 offset 만큼 이동됨.
   aabb bbox;                        // 월드 좌표계 기준 이동 변환된 AABB (object->bbox + offset)
 };
 
+/**
+ * 차폐 검사(occlusion query)
+ *
+ *
+ * hit() 은 '가장 가까운 교차점(closest-hit)'을 찾는 질의이므로,
+ * 교차점을 하나 찾아도 더 가까운 교차점이 있는지 나머지 후보를 계속 검사하고, 찾을 때마다 normal, uv, material 등 hit_record 전체를 계산한다.
+ *
+ * 반면 그림자 광선(shadow ray)이나 ambient occlusion 처럼 '광원까지 가려졌는지' 만 알면 되는 경우에는
+ * ray_t 범위(ex> 광원까지의 거리) 안에서 교차점이 하나라도 발견되는 순간 바로 true 를 반환해도 된다.
+ * occluded() 는 이 any-hit 질의를 위한 인터페이스로,
+ * - hit_record 를 기록하지 않고 (normal, uv, material 계산 생략)
+ * - 첫 번째 교차점에서 즉시 종료하며 (BVH 순회도 가까운 자식 정렬 없이 바로 종료)
+ * - 기본 구현은 hit() 을 호출하므로, 재정의하지 않은 hittable 도 올바르게 동작한다.
+ */
+
+/**
+ * hit_record::mat 를 shared_ptr 대신 raw pointer 로 두는 이유
+ *
+ *
+ * hit_record 는 광선마다, 그리고 교차 후보마다 기록되고 복사되는 가장 뜨거운 경로의 데이터다.
+ * (sphere::hit() 등이 후보 교차점마다 rec.mat 을 기록하고, hittable_list::hit() 은 가까운 교차점을 찾을 때마다 temp_rec 전체를 rec 로 복사)
+ *
+ * rec.mat 이 std::shared_ptr<material> 이면 대입/복사/소멸마다 참조 카운트를 원자적(atomic)으로 증감해야 하는데,
+ * - 원자적 증감(lock add)은 일반 대입보다 훨씬 비싸고 컴파일러가 제거하거나 재배치할 수 없으며,
+ * - 여러 스레드가 같은 material(ex> 바닥, 벽)에 동시에 부딪히면 같은 참조 카운트 캐시 라인을 코어끼리 주고받느라(false/true sharing) 더 느려진다.
+ *
+ * material 의 소유권은 이미 scene 을 구성하는 primitive(또는 sphere_set 의 materials 테이블)가 shared_ptr 로 가지고 있고,
+ * hit_record 는 scene 이 살아있는 동안 광선 하나를 추적하는 짧은 시간에만 쓰이므로 소유할 필요가 없다.
+ *
+ * ✅ const material * 는 단순 포인터 복사이므로 hit_record 전체가 trivially copyable 이 되어 memcpy 수준으로 복사된다.
+ * ⚠️ hit_record 를 scene(primitive) 보다 오래 보관하면 dangling pointer 가 되므로, 렌더링 중에만 사용해야 한다.
+ */
+
 /*
   가상 소멸자(destructor)와 default
 
@@ -36,6 +36,19 @@ public:
     bbox = aabb(bbox, object->bounding_box());
   };
 
+  // scene 에 추가된 hittable object 중 하나라도 ray 와 교차하면 즉시 true 반환 (가장 가까운 교차점을 찾을 필요 없음)
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    for (const auto &object : objects)
+    {
+      if (object->occluded(r, ray_t))
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
   // scene 에 추가된 hittable object 순회하며 ray intersection 검사
   bool hit(const ray &r, interval ray_t, hit_record &rec) const override
   {
@@ -66,6 +79,17 @@ public:
   // 하위 자식 hittable 객체들의 AABB 반환 함수
   aabb bounding_box() const override { return bbox; };
 
+  // 하위 자식 hittable 객체들의 time 시점 AABB 를 모두 감싸는 AABB 반환
+  aabb bounding_box_at(double time) const override
+  {
+    aabb result;
+    for (const auto &object : objects)
+    {
+      result = aabb(result, object->bounding_box_at(time));
+    }
+    return result;
+  };
+
 public:
   // scene 에 hittable object 를 추가하는 컨테이너
   // -> RAII 패턴 기반 메모리 안정적 관리 및 예상치 못한 소멸자 호출 방지 등을 위해 hittable 객체를 std::shared_ptr 로 관리
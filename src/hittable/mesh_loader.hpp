@@ -0,0 +1,1323 @@
+#ifndef MESH_LOADER_HPP
+#define MESH_LOADER_HPP
+
+#include "triangle_mesh.hpp"
+#include "common/mapped_file.hpp"
+#include "common/parallel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <locale.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <xlocale.h>
+#endif
+
+/**
+ * 메쉬 파일 로더 (Wavefront OBJ, binary PLY)
+ *
+ * - 파일을 mapped_file 로 매핑한 뒤, 파일 내용을 줄 단위 std::string 이나 중간 버퍼로 복사하지 않고 매핑된 메모리를 직접 파싱한다.
+ * - 파일을 thread 개수만큼의 구간으로 나눠 병렬로 파싱하고, 결과는 triangle_mesh_data 의 SoA 배열에 바로 기록한다.
+ *   (먼저 구간별 원소 개수를 세고, prefix sum 으로 구간별 쓰기 위치를 정한 뒤 두 번째 패스에서 각자 자기 위치에 기록)
+ * - 실수는 std::strtod 대신 로케일 / 널 종료 문자열에 의존하지 않는 간단한 10진 파서(mesh_parse_double())로 읽는다.
+ *   (파서가 정확히 반올림할 수 없는 드문 경우에만 "C" 로케일을 지정한 strtod_l 로 변환하므로, 프로세스 로케일의 소수점 문자와 무관함)
+ * - 실패 시 오류 메시지를 출력하고 false 를 반환한다. (mesh 는 비워짐)
+ */
+
+// 메쉬 로드 옵션
+class mesh_load_options
+{
+public:
+  int thread_count = 0;                  // 파싱에 사용할 thread 개수 (0 이면 하드웨어 thread 개수)
+  size_t parallel_threshold = 1u << 20;  // 파일 크기(바이트)가 이 값 이상일 때만 병렬 파싱
+  bool report_stats = true;              // 로드 통계(크기, 처리량) 콘솔 출력 여부
+};
+
+// 메쉬 로드 통계
+class mesh_load_stats
+{
+public:
+  size_t bytes = 0;          // 파일 크기 (바이트)
+  size_t vertex_count = 0;   // 로드된 정점 개수
+  size_t triangle_count = 0; // 로드된 삼각형 개수
+  int thread_count = 1;      // 파싱에 사용한 thread 개수
+  double map_ms = 0.0f;      // 파일 매핑 시간
+  double parse_ms = 0.0f;    // 파싱 시간 (페이지를 처음 읽을 때의 디스크 읽기 시간 포함)
+  double total_ms = 0.0f;    // 전체 로드 시간
+
+  double bytes_per_second() const { return total_ms > 0.0f ? bytes / (total_ms * 1e-3) : 0.0f; };
+  double triangles_per_second() const { return total_ms > 0.0f ? triangle_count / (total_ms * 1e-3) : 0.0f; };
+
+  void report(const std::string &path) const
+  {
+    printf("mesh %s: %zu vertices, %zu triangles (%d threads)\n", path.c_str(), vertex_count, triangle_count, thread_count);
+    printf("  %.1f MB in %.3f ms (map %.3f ms, parse %.3f ms) | %.1f MB/s | %.2f Mtriangles/s\n", bytes * 1e-6, total_ms, map_ms,
+           parse_ms, bytes_per_second() * 1e-6, triangles_per_second() * 1e-6);
+  };
+};
+
+/** 텍스트 파싱 유틸리티 (매핑된 메모리 [p, end) 를 직접 읽음) */
+
+// 개행 문자를 제외한 공백 건너뛰기
+inline const char *mesh_skip_spaces(const char *p, const char *end)
+{
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+  {
+    p++;
+  }
+  return p;
+};
+
+// 현재 줄의 나머지를 건너뛰고 다음 줄의 시작 위치 반환
+inline const char *mesh_skip_line(const char *p, const char *end)
+{
+  const void *newline = std::memchr(p, '\n', end - p);
+  return newline ? static_cast<const char *>(newline) + 1 : end;
+};
+
+inline bool mesh_is_token_end(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; };
+
+// 10진 정수 파싱 (부호 허용). 숫자가 하나도 없으면 false 반환하고 p 는 그대로 둠
+inline bool mesh_parse_int(const char *&p, const char *end, int64_t &value)
+{
+  const char *s = p;
+  bool negative = false;
+  if (s < end && (*s == '-' || *s == '+'))
+  {
+    negative = *s == '-';
+    s++;
+  }
+  const char *digits_begin = s;
+  int64_t result = 0;
+  while (s < end && static_cast<unsigned>(*s - '0') < 10u)
+  {
+    result = result * 10 + (*s - '0');
+    s++;
+  }
+  if (s == digits_begin)
+  {
+    return false;
+  }
+  value = negative ? -result : result;
+  p = s;
+  return true;
+};
+
+// "C" 로케일 기준 strtod (setlocale() 로 바뀐 프로세스 로케일의 소수점 문자 ',' 등에 영향받지 않음)
+inline double mesh_strtod_c(const char *token)
+{
+#ifdef _WIN32
+  static const _locale_t c_locale = _create_locale(LC_ALL, "C");
+  return _strtod_l(token, nullptr, c_locale);
+#else
+  static const locale_t c_locale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+  return strtod_l(token, nullptr, c_locale);
+#endif
+};
+
+/**
+ * 10진 실수 파싱 ([+-]digits[.digits][(e|E)[+-]digits] 형식)
+ *
+ * - 유효 숫자를 최대 19 자리까지 64 비트 정수 가수(mantissa)에 모으고, 10 의 거듭제곱을 한 번만 곱하거나 나눈다.
+ * - 가수가 2^53 이하이고 10 의 지수가 22 이하이면 두 값이 모두 double 로 정확히 표현되므로 결과도 정확히 반올림된다. (Clinger 의 fast path)
+ *   그 밖의 드문 경우(아주 작거나 큰 지수, 19 자리 초과)에만 토큰을 복사해서 "C" 로케일 strtod_l 로 변환한다.
+ */
+inline bool mesh_parse_double(const char *&p, const char *end, double &value)
+{
+  static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  const char *s = p;
+  bool negative = false;
+  if (s < end && (*s == '-' || *s == '+'))
+  {
+    negative = *s == '-';
+    s++;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;   // 가수에 모은 유효 숫자 개수 (앞쪽 0 제외)
+  int exponent = 0; // 가수에 곱할 10 의 지수
+  bool any_digit = false;
+
+  while (s < end && static_cast<unsigned>(*s - '0') < 10u)
+  {
+    if (digits < 19)
+    {
+      mantissa = mantissa * 10 + (*s - '0');
+      digits += mantissa != 0;
+    }
+    else
+    {
+      exponent++;
+    }
+    any_digit = true;
+    s++;
+  }
+  if (s < end && *s == '.')
+  {
+    s++;
+    while (s < end && static_cast<unsigned>(*s - '0') < 10u)
+    {
+      if (digits < 19)
+      {
+        mantissa = mantissa * 10 + (*s - '0');
+        digits += mantissa != 0;
+        exponent--;
+      }
+      any_digit = true;
+      s++;
+    }
+  }
+  if (!any_digit)
+  {
+    return false;
+  }
+
+  if (s < end && (*s == 'e' || *s == 'E'))
+  {
+    const char *e = s + 1;
+    int64_t exp_value;
+    if (mesh_parse_int(e, end, exp_value))
+    {
+      exponent += static_cast<int>(std::max<int64_t>(-10000, std::min<int64_t>(10000, exp_value)));
+      s = e;
+    }
+  }
+
+  double result = static_cast<double>(mantissa);
+  if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+  {
+    result = exponent < 0 ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+  }
+  else if (mantissa != 0)
+  {
+    // 드문 경우: 토큰을 스택 버퍼에 복사해서 "C" 로케일 strtod_l 로 정확히 변환 (가수가 0 이면 지수와 관계없이 0)
+    char token[128];
+    size_t length = static_cast<size_t>(s - p);
+    if (length < sizeof(token))
+    {
+      std::memcpy(token, p, length);
+      token[length] = '\0';
+      value = mesh_strtod_c(token);
+      p = s;
+      return true;
+    }
+    result *= std::pow(10.0, exponent);
+  }
+
+  value = negative ? -result : result;
+  p = s;
+  return true;
+};
+
+// 앞쪽 공백을 건너뛰고 실수 하나 파싱
+inline bool mesh_parse_next_double(const char *&p, const char *end, double &value)
+{
+  p = mesh_skip_spaces(p, end);
+  return mesh_parse_double(p, end, value);
+};
+
+// 파일 경로의 확장자를 소문자로 반환 (".obj", ".ply" 등)
+inline std::string mesh_file_extension(const std::string &path)
+{
+  size_t dot = path.find_last_of('.');
+  if (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos)
+  {
+    return std::string();
+  }
+  std::string extension = path.substr(dot);
+  for (char &c : extension)
+  {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return extension;
+};
+
+/** Wavefront OBJ */
+
+// OBJ 파일 한 구간의 원소 개수 (1 패스 결과이자 2 패스의 쓰기 시작 위치)
+class obj_chunk_counts
+{
+public:
+  size_t positions = 0; // "v" 줄 개수
+  size_t normals = 0;   // "vn" 줄 개수
+  size_t uvs = 0;       // "vt" 줄 개수
+  size_t triangles = 0; // "f" 줄을 fan 방식으로 나눈 삼각형 개수
+};
+
+// OBJ 면의 꼭짓점 하나 (위치 / uv / 노멀 인덱스, 0 부터 시작하는 절대 인덱스)
+class obj_corner
+{
+public:
+  uint32_t position;
+  uint32_t uv;
+  uint32_t normal;
+
+  bool operator==(const obj_corner &other) const
+  {
+    return position == other.position && uv == other.uv && normal == other.normal;
+  };
+};
+
+class obj_corner_hash
+{
+public:
+  size_t operator()(const obj_corner &c) const
+  {
+    uint64_t h = c.position * 0x9E3779B97F4A7C15ULL;
+    h ^= (c.uv + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2));
+    h ^= (c.normal + 0x85EBCA77C2B2AE63ULL + (h << 6) + (h >> 2));
+    return static_cast<size_t>(h);
+  };
+};
+
+static const uint32_t obj_missing_index = 0xFFFFFFFFu; // 면 꼭짓점에 uv / 노멀 인덱스가 없음
+
+// 바이트 구간 [begin, end) 를 줄 경계에 맞춘 위치 반환 (pos 가 줄 중간이면 다음 줄 시작으로 이동)
+// -> 이웃한 두 구간이 같은 경계를 계산하므로, 모든 줄은 첫 바이트가 속한 구간에서 정확히 한 번만 처리됨
+inline const char *obj_align_to_line(const char *data, size_t pos, size_t size)
+{
+  if (pos == 0 || pos >= size)
+  {
+    return data + std::min(pos, size);
+  }
+  return data[pos - 1] == '\n' ? data + pos : mesh_skip_line(data + pos, data + size);
+};
+
+// 1 패스: 구간 내 각 종류의 줄 개수와 삼각형 개수 세기
+inline void obj_count_chunk(const char *p, const char *end, obj_chunk_counts &counts)
+{
+  while (p < end)
+  {
+    p = mesh_skip_spaces(p, end);
+    if (p + 1 < end && p[0] == 'v')
+    {
+      if (p[1] == ' ' || p[1] == '\t')
+      {
+        counts.positions++;
+      }
+      else if (p[1] == 'n' && p + 2 < end && (p[2] == ' ' || p[2] == '\t'))
+      {
+        counts.normals++;
+      }
+      else if (p[1] == 't' && p + 2 < end && (p[2] == ' ' || p[2] == '\t'))
+      {
+        counts.uvs++;
+      }
+    }
+    else if (p + 1 < end && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+    {
+      // 면의 꼭짓점(공백으로 구분된 토큰) 개수 n 에서 n - 2 개의 삼각형
+      const char *s = p + 1;
+      size_t corners = 0;
+      while (true)
+      {
+        s = mesh_skip_spaces(s, end);
+        if (s >= end || *s == '\n' || *s == '#')
+        {
+          break;
+        }
+        corners++;
+        while (s < end && !mesh_is_token_end(*s))
+        {
+          s++;
+        }
+      }
+      counts.triangles += corners > 2 ? corners - 2 : 0;
+      p = s;
+    }
+    p = mesh_skip_line(p, end);
+  }
+};
+
+// OBJ 인덱스(1 부터 시작, 음수면 지금까지 정의된 원소 개수 기준 상대 인덱스)를 0 부터 시작하는 절대 인덱스로 변환
+inline bool obj_resolve_index(int64_t index, size_t defined_so_far, uint32_t &resolved)
+{
+  int64_t absolute = index > 0 ? index - 1 : static_cast<int64_t>(defined_so_far) + index;
+  if (index == 0 || absolute < 0 || absolute >= static_cast<int64_t>(defined_so_far) || absolute >= obj_missing_index)
+  {
+    return false;
+  }
+  resolved = static_cast<uint32_t>(absolute);
+  return true;
+};
+
+// OBJ 파싱 중간 결과: 정점 속성 배열은 위치 / uv / 노멀 각각 독립된 인덱스 공간을 가짐
+class obj_parse_buffers
+{
+public:
+  std::vector<double> nx, ny, nz;             // "vn" 배열
+  std::vector<double> tu, tv;                 // "vt" 배열
+  std::vector<uint32_t> corner_uv;            // 삼각형 꼭짓점별 uv 인덱스 (파일에 "vt" 가 없으면 비어 있음)
+  std::vector<uint32_t> corner_normal;        // 삼각형 꼭짓점별 노멀 인덱스 (파일에 "vn" 이 없으면 비어 있음)
+};
+
+// 2 패스: 구간을 파싱하여 base 위치부터 mesh / buffers 배열에 기록 (형식 오류 시 false)
+inline bool obj_parse_chunk(const char *p, const char *end, const obj_chunk_counts &base, triangle_mesh_data &mesh,
+                            obj_parse_buffers &buffers)
+{
+  size_t position = base.positions, normal = base.normals, uv = base.uvs, triangle = base.triangles;
+
+  while (p < end)
+  {
+    p = mesh_skip_spaces(p, end);
+    if (p + 1 < end && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+    {
+      double x, y, z;
+      const char *s = p + 1;
+      if (!mesh_parse_next_double(s, end, x) || !mesh_parse_next_double(s, end, y) || !mesh_parse_next_double(s, end, z))
+      {
+        return false;
+      }
+      mesh.px[position] = x;
+      mesh.py[position] = y;
+      mesh.pz[position] = z;
+      position++;
+      p = s;
+    }
+    else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t'))
+    {
+      double x, y, z;
+      const char *s = p + 2;
+      if (!mesh_parse_next_double(s, end, x) || !mesh_parse_next_double(s, end, y) || !mesh_parse_next_double(s, end, z))
+      {
+        return false;
+      }
+      buffers.nx[normal] = x;
+      buffers.ny[normal] = y;
+      buffers.nz[normal] = z;
+      normal++;
+      p = s;
+    }
+    else if (p + 2 < end && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t'))
+    {
+      double u, v = 0.0f;
+      const char *s = p + 2;
+      if (!mesh_parse_next_double(s, end, u))
+      {
+        return false;
+      }
+      mesh_parse_next_double(s, end, v); // v 는 생략 가능
+      buffers.tu[uv] = u;
+      buffers.tv[uv] = v;
+      uv++;
+      p = s;
+    }
+    else if (p + 1 < end && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+    {
+      // 다각형 면은 첫 꼭짓점 기준 fan 으로 삼각형 분할: (0, k - 1, k)
+      obj_corner first = obj_corner(), previous = obj_corner();
+      int corners = 0;
+      const char *s = p + 1;
+      while (true)
+      {
+        s = mesh_skip_spaces(s, end);
+        if (s >= end || *s == '\n' || *s == '#')
+        {
+          break;
+        }
+
+        // 꼭짓점 토큰: v, v/vt, v//vn, v/vt/vn
+        obj_corner corner = {obj_missing_index, obj_missing_index, obj_missing_index};
+        int64_t index;
+        if (!mesh_parse_int(s, end, index) || !obj_resolve_index(index, position, corner.position))
+        {
+          return false;
+        }
+        if (s < end && *s == '/')
+        {
+          s++;
+          if (mesh_parse_int(s, end, index) && !obj_resolve_index(index, uv, corner.uv))
+          {
+            return false;
+          }
+          if (s < end && *s == '/')
+          {
+            s++;
+            if (mesh_parse_int(s, end, index) && !obj_resolve_index(index, normal, corner.normal))
+            {
+              return false;
+            }
+          }
+        }
+        if (s < end && !mesh_is_token_end(*s))
+        {
+          return false;
+        }
+
+        if (corners == 0)
+        {
+          first = corner;
+        }
+        else if (corners >= 2)
+        {
+          const obj_corner triangle_corners[3] = {first, previous, corner};
+          for (int k = 0; k < 3; k++)
+          {
+            mesh.indices[3 * triangle + k] = triangle_corners[k].position;
+            if (!buffers.corner_uv.empty())
+            {
+              buffers.corner_uv[3 * triangle + k] = triangle_corners[k].uv;
+            }
+            if (!buffers.corner_normal.empty())
+            {
+              buffers.corner_normal[3 * triangle + k] = triangle_corners[k].normal;
+            }
+          }
+          triangle++;
+        }
+        previous = corner;
+        corners++;
+      }
+      p = s;
+    }
+    p = mesh_skip_line(p, end);
+  }
+  return true;
+};
+
+/**
+ * 꼭짓점별 uv / 노멀 인덱스를 정점 인덱스 하나로 통합
+ *
+ * - OBJ 는 위치 / uv / 노멀마다 별도의 인덱스를 쓰지만, triangle_mesh 는 세 속성이 같은 인덱스를 공유한다.
+ * - 모든 꼭짓점에서 uv / 노멀 인덱스가 위치 인덱스와 같으면(스캔 데이터, 대부분의 내보내기 결과) 배열을 그대로 넘겨받고,
+ *   다르면 (위치, uv, 노멀) 조합마다 정점을 하나씩 새로 만든다. (단일 thread, 해시 테이블 사용)
+ * - 일부 꼭짓점에만 uv / 노멀 인덱스가 있으면 해당 속성은 버린다.
+ */
+inline void obj_unify_attributes(triangle_mesh_data &mesh, obj_parse_buffers &buffers, int thread_count)
+{
+  size_t corner_count = mesh.indices.size();
+  bool use_uvs = !buffers.corner_uv.empty();
+  bool use_normals = !buffers.corner_normal.empty();
+
+  // 구간별로 (속성 누락 여부, 위치 인덱스와의 일치 여부) 검사
+  std::vector<char> uv_missing(thread_count, 0), normal_missing(thread_count, 0);
+  std::vector<char> uv_misaligned(thread_count, 0), normal_misaligned(thread_count, 0);
+  parallel_for_chunks(corner_count, thread_count,
+                      [&](int chunk, size_t begin, size_t end)
+                      {
+                        for (size_t i = begin; i < end; i++)
+                        {
+                          uint32_t position = mesh.indices[i];
+                          if (use_uvs)
+                          {
+                            uint32_t uv = buffers.corner_uv[i];
+                            uv_missing[chunk] |= uv == obj_missing_index;
+                            uv_misaligned[chunk] |= uv != position;
+                          }
+                          if (use_normals)
+                          {
+                            uint32_t normal = buffers.corner_normal[i];
+                            normal_missing[chunk] |= normal == obj_missing_index;
+                            normal_misaligned[chunk] |= normal != position;
+                          }
+                        }
+                      });
+  bool any_uv_misaligned = false, any_normal_misaligned = false;
+  for (int c = 0; c < thread_count; c++)
+  {
+    use_uvs = use_uvs && !uv_missing[c];
+    use_normals = use_normals && !normal_missing[c];
+    any_uv_misaligned = any_uv_misaligned || uv_misaligned[c];
+    any_normal_misaligned = any_normal_misaligned || normal_misaligned[c];
+  }
+  bool any_misaligned = (use_uvs && any_uv_misaligned) || (use_normals && any_normal_misaligned);
+
+  size_t vertex_count = mesh.vertex_count();
+  if (!any_misaligned)
+  {
+    // 인덱스가 이미 일치: 속성 배열을 정점 개수에 맞춰 그대로 넘겨받음
+    if (use_normals)
+    {
+      mesh.nx = std::move(buffers.nx);
+      mesh.ny = std::move(buffers.ny);
+      mesh.nz = std::move(buffers.nz);
+      mesh.nx.resize(vertex_count);
+      mesh.ny.resize(vertex_count);
+      mesh.nz.resize(vertex_count);
+    }
+    if (use_uvs)
+    {
+      mesh.tu = std::move(buffers.tu);
+      mesh.tv = std::move(buffers.tv);
+      mesh.tu.resize(vertex_count);
+      mesh.tv.resize(vertex_count);
+    }
+    return;
+  }
+
+  // (위치, uv, 노멀) 조합마다 새 정점 생성
+  triangle_mesh_data unified;
+  unified.indices = std::move(mesh.indices);
+  std::unordered_map<obj_corner, uint32_t, obj_corner_hash> vertex_map;
+  vertex_map.reserve(vertex_count);
+  for (size_t i = 0; i < corner_count; i++)
+  {
+    obj_corner corner = {unified.indices[i], use_uvs ? buffers.corner_uv[i] : 0u, use_normals ? buffers.corner_normal[i] : 0u};
+    auto inserted = vertex_map.insert(std::make_pair(corner, static_cast<uint32_t>(unified.px.size())));
+    if (inserted.second)
+    {
+      unified.px.push_back(mesh.px[corner.position]);
+      unified.py.push_back(mesh.py[corner.position]);
+      unified.pz.push_back(mesh.pz[corner.position]);
+      if (use_normals)
+      {
+        unified.nx.push_back(buffers.nx[corner.normal]);
+        unified.ny.push_back(buffers.ny[corner.normal]);
+        unified.nz.push_back(buffers.nz[corner.normal]);
+      }
+      if (use_uvs)
+      {
+        unified.tu.push_back(buffers.tu[corner.uv]);
+        unified.tv.push_back(buffers.tv[corner.uv]);
+      }
+    }
+    unified.indices[i] = inserted.first->second;
+  }
+  mesh = std::move(unified);
+};
+
+// Wavefront OBJ 파일 로드 ("v", "vt", "vn", "f" 만 읽고 그 밖의 줄은 무시. 다각형 면은 삼각형으로 분할)
+inline bool load_obj(const std::string &path, triangle_mesh_data &mesh, const mesh_load_options &options = mesh_load_options(),
+                     mesh_load_stats *stats = nullptr)
+{
+  auto load_start = std::chrono::steady_clock::now();
+  mesh.clear();
+
+  mapped_file file;
+  if (!file.open(path))
+  {
+    fprintf(stderr, "Error: could not open mesh file %s.\n", path.c_str());
+    return false;
+  }
+  file.prefetch();
+  auto map_end = std::chrono::steady_clock::now();
+
+  const char *data = reinterpret_cast<const char *>(file.data());
+  const size_t size = file.size();
+  const int thread_count = size >= options.parallel_threshold ? resolve_thread_count(options.thread_count) : 1;
+
+  // 1 패스: 구간별 원소 개수 세기
+  std::vector<obj_chunk_counts> counts(thread_count);
+  int chunks = parallel_for_chunks(size, thread_count,
+                                   [&](int chunk, size_t begin, size_t end)
+                                   {
+                                     obj_count_chunk(obj_align_to_line(data, begin, size), obj_align_to_line(data, end, size),
+                                                     counts[chunk]);
+                                   });
+
+  // prefix sum 으로 구간별 쓰기 시작 위치 계산
+  std::vector<obj_chunk_counts> bases(chunks);
+  obj_chunk_counts total;
+  for (int c = 0; c < chunks; c++)
+  {
+    bases[c] = total;
+    total.positions += counts[c].positions;
+    total.normals += counts[c].normals;
+    total.uvs += counts[c].uvs;
+    total.triangles += counts[c].triangles;
+  }
+  if (total.positions >= obj_missing_index || total.normals >= obj_missing_index || total.uvs >= obj_missing_index)
+  {
+    fprintf(stderr, "Error: mesh file %s has too many vertices.\n", path.c_str());
+    return false;
+  }
+
+  // 2 패스: 구간별로 자기 위치에 파싱 결과 기록
+  obj_parse_buffers buffers;
+  mesh.resize_vertices(total.positions, false, false);
+  mesh.indices.resize(3 * total.triangles);
+  buffers.nx.resize(total.normals);
+  buffers.ny.resize(total.normals);
+  buffers.nz.resize(total.normals);
+  buffers.tu.resize(total.uvs);
+  buffers.tv.resize(total.uvs);
+  buffers.corner_uv.resize(total.uvs > 0 ? 3 * total.triangles : 0);
+  buffers.corner_normal.resize(total.normals > 0 ? 3 * total.triangles : 0);
+
+  std::vector<char> chunk_ok(chunks, 0);
+  parallel_for_chunks(size, thread_count,
+                      [&](int chunk, size_t begin, size_t end)
+                      {
+                        chunk_ok[chunk] = obj_parse_chunk(obj_align_to_line(data, begin, size), obj_align_to_line(data, end, size),
+                                                          bases[chunk], mesh, buffers);
+                      });
+  for (int c = 0; c < chunks; c++)
+  {
+    if (!chunk_ok[c])
+    {
+      fprintf(stderr, "Error: malformed vertex or face line in mesh file %s.\n", path.c_str());
+      mesh.clear();
+      return false;
+    }
+  }
+
+  obj_unify_attributes(mesh, buffers, chunks);
+  auto load_end = std::chrono::steady_clock::now();
+
+  mesh_load_stats result;
+  result.bytes = size;
+  result.vertex_count = mesh.vertex_count();
+  result.triangle_count = mesh.triangle_count();
+  result.thread_count = chunks;
+  result.map_ms = std::chrono::duration<double, std::milli>(map_end - load_start).count();
+  result.parse_ms = std::chrono::duration<double, std::milli>(load_end - map_end).count();
+  result.total_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+  if (options.report_stats)
+  {
+    result.report(path);
+  }
+  if (stats)
+  {
+    *stats = result;
+  }
+  return true;
+};
+
+/** binary PLY */
+
+// PLY 속성 자료형
+enum class ply_type : uint8_t
+{
+  int8,
+  uint8,
+  int16,
+  uint16,
+  int32,
+  uint32,
+  float32,
+  float64,
+  invalid,
+};
+
+inline ply_type ply_type_from_name(const std::string &name)
+{
+  if (name == "char" || name == "int8")
+    return ply_type::int8;
+  if (name == "uchar" || name == "uint8")
+    return ply_type::uint8;
+  if (name == "short" || name == "int16")
+    return ply_type::int16;
+  if (name == "ushort" || name == "uint16")
+    return ply_type::uint16;
+  if (name == "int" || name == "int32")
+    return ply_type::int32;
+  if (name == "uint" || name == "uint32")
+    return ply_type::uint32;
+  if (name == "float" || name == "float32")
+    return ply_type::float32;
+  if (name == "double" || name == "float64")
+    return ply_type::float64;
+  return ply_type::invalid;
+};
+
+inline size_t ply_type_size(ply_type type)
+{
+  static const size_t sizes[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+  return sizes[static_cast<int>(type)];
+};
+
+// 매핑된 메모리의 p 위치에서 type 자료형 값 하나를 읽어 double 로 변환 (swap 이면 바이트 순서 뒤집기)
+inline double ply_read_scalar(const unsigned char *p, ply_type type, bool swap)
+{
+  unsigned char bytes[8];
+  size_t size = ply_type_size(type);
+  if (swap)
+  {
+    for (size_t i = 0; i < size; i++)
+    {
+      bytes[i] = p[size - 1 - i];
+    }
+    p = bytes;
+  }
+
+  switch (type)
+  {
+  case ply_type::int8:
+    return static_cast<int8_t>(p[0]);
+  case ply_type::uint8:
+    return p[0];
+  case ply_type::int16:
+  {
+    int16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  case ply_type::uint16:
+  {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  case ply_type::int32:
+  {
+    int32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  case ply_type::uint32:
+  {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  case ply_type::float32:
+  {
+    float v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  case ply_type::float64:
+  {
+    double v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  default:
+    return 0.0f;
+  }
+};
+
+// PLY element 의 속성 하나 (list 속성이면 개수 자료형 + 원소 자료형)
+class ply_property
+{
+public:
+  std::string name;
+  ply_type type = ply_type::invalid;       // scalar 자료형 (list 이면 원소 자료형)
+  ply_type count_type = ply_type::invalid; // list 개수 자료형 (scalar 이면 invalid)
+
+  bool is_list() const { return count_type != ply_type::invalid; };
+};
+
+// PLY element ("vertex", "face" 등) 선언
+class ply_element
+{
+public:
+  std::string name;
+  size_t count = 0;
+  std::vector<ply_property> properties;
+
+  // 모든 속성이 scalar 이면 레코드 하나의 바이트 크기, list 속성이 있으면 0
+  size_t fixed_size() const
+  {
+    size_t size = 0;
+    for (const auto &property : properties)
+    {
+      if (property.is_list())
+      {
+        return 0;
+      }
+      size += ply_type_size(property.type);
+    }
+    return size;
+  };
+
+  // 이름이 names 중 하나인 scalar 속성의 레코드 내 바이트 위치 (없으면 -1, list 속성 뒤에 있으면 -1)
+  long scalar_offset(const char *const *names, int name_count, ply_type &type) const
+  {
+    size_t offset = 0;
+    for (const auto &property : properties)
+    {
+      if (property.is_list())
+      {
+        return -1;
+      }
+      for (int n = 0; n < name_count; n++)
+      {
+        if (property.name == names[n])
+        {
+          type = property.type;
+          return static_cast<long>(offset);
+        }
+      }
+      offset += ply_type_size(property.type);
+    }
+    return -1;
+  };
+};
+
+// p 위치에서 시작하는 가변 크기 레코드(list 속성 포함) 하나를 건너뛴 위치 반환 (파일 끝을 넘으면 nullptr)
+inline const unsigned char *ply_skip_record(const unsigned char *p, const unsigned char *end, const ply_element &element, bool swap)
+{
+  for (const auto &property : element.properties)
+  {
+    if (property.is_list())
+    {
+      size_t count_size = ply_type_size(property.count_type);
+      if (p + count_size > end)
+      {
+        return nullptr;
+      }
+      double count = ply_read_scalar(p, property.count_type, swap);
+      p += count_size + static_cast<size_t>(std::max(count, 0.0)) * ply_type_size(property.type);
+    }
+    else
+    {
+      p += ply_type_size(property.type);
+    }
+    if (p > end)
+    {
+      return nullptr;
+    }
+  }
+  return p;
+};
+
+// PLY 헤더 파싱: format 과 element 선언을 읽고, 바이너리 데이터 시작 위치를 body 에 기록
+inline bool ply_parse_header(const char *data, size_t size, bool &big_endian, std::vector<ply_element> &elements, size_t &body)
+{
+  const char *p = data, *end = data + size;
+  if (size < 4 || std::memcmp(data, "ply", 3) != 0)
+  {
+    return false;
+  }
+
+  bool has_format = false;
+  while (p < end)
+  {
+    const char *line_end = static_cast<const char *>(std::memchr(p, '\n', end - p));
+    if (!line_end)
+    {
+      return false;
+    }
+
+    // 줄을 공백 기준 토큰으로 분리 (헤더는 수십 줄뿐이므로 std::string 사용)
+    std::vector<std::string> tokens;
+    const char *s = p;
+    while (true)
+    {
+      s = mesh_skip_spaces(s, line_end);
+      if (s >= line_end)
+      {
+        break;
+      }
+      const char *token_begin = s;
+      while (s < line_end && !mesh_is_token_end(*s))
+      {
+        s++;
+      }
+      tokens.push_back(std::string(token_begin, s));
+    }
+    p = line_end + 1;
+
+    if (tokens.empty() || tokens[0] == "comment" || tokens[0] == "obj_info" || tokens[0] == "ply")
+    {
+      continue;
+    }
+    if (tokens[0] == "end_header")
+    {
+      body = static_cast<size_t>(p - data);
+      return has_format;
+    }
+    if (tokens[0] == "format" && tokens.size() >= 2)
+    {
+      if (tokens[1] != "binary_little_endian" && tokens[1] != "binary_big_endian")
+      {
+        return false; // ascii PLY 는 지원하지 않음
+      }
+      big_endian = tokens[1] == "binary_big_endian";
+      has_format = true;
+    }
+    else if (tokens[0] == "element" && tokens.size() >= 3)
+    {
+      ply_element element;
+      element.name = tokens[1];
+      element.count = static_cast<size_t>(std::strtoull(tokens[2].c_str(), nullptr, 10));
+      elements.push_back(element);
+    }
+    else if (tokens[0] == "property" && !elements.empty())
+    {
+      ply_property property;
+      if (tokens.size() >= 5 && tokens[1] == "list")
+      {
+        property.count_type = ply_type_from_name(tokens[2]);
+        property.type = ply_type_from_name(tokens[3]);
+        property.name = tokens[4];
+        if (property.count_type == ply_type::invalid)
+        {
+          return false;
+        }
+      }
+      else if (tokens.size() >= 3)
+      {
+        property.type = ply_type_from_name(tokens[1]);
+        property.name = tokens[2];
+      }
+      if (property.type == ply_type::invalid)
+      {
+        return false;
+      }
+      elements.back().properties.push_back(property);
+    }
+  }
+  return false;
+};
+
+// vertex element 의 레코드들을 병렬로 읽어 SoA 배열에 기록 (레코드 크기가 고정된 경우)
+inline bool ply_read_vertices(const unsigned char *p, const unsigned char *end, const ply_element &element, bool swap,
+                              int thread_count, triangle_mesh_data &mesh)
+{
+  static const char *const x_names[] = {"x"}, *const y_names[] = {"y"}, *const z_names[] = {"z"};
+  static const char *const nx_names[] = {"nx"}, *const ny_names[] = {"ny"}, *const nz_names[] = {"nz"};
+  static const char *const u_names[] = {"u", "s", "texture_u", "texture_s"};
+  static const char *const v_names[] = {"v", "t", "texture_v", "texture_t"};
+
+  size_t stride = element.fixed_size();
+  if (stride == 0 || static_cast<size_t>(end - p) / stride < element.count)
+  {
+    return false;
+  }
+
+  ply_type types[8];
+  long offsets[8] = {element.scalar_offset(x_names, 1, types[0]), element.scalar_offset(y_names, 1, types[1]),
+                     element.scalar_offset(z_names, 1, types[2]), element.scalar_offset(nx_names, 1, types[3]),
+                     element.scalar_offset(ny_names, 1, types[4]), element.scalar_offset(nz_names, 1, types[5]),
+                     element.scalar_offset(u_names, 4, types[6]), element.scalar_offset(v_names, 4, types[7])};
+  if (offsets[0] < 0 || offsets[1] < 0 || offsets[2] < 0)
+  {
+    return false;
+  }
+  bool normals = offsets[3] >= 0 && offsets[4] >= 0 && offsets[5] >= 0;
+  bool uvs = offsets[6] >= 0 && offsets[7] >= 0;
+  mesh.resize_vertices(element.count, normals, uvs);
+
+  // 가장 흔한 경우(float32, 같은 바이트 순서)는 memcpy 로 바로 읽음
+  bool all_float = true;
+  for (int k = 0; k < 8; k++)
+  {
+    all_float = all_float && (offsets[k] < 0 || types[k] == ply_type::float32);
+  }
+
+  parallel_for_chunks(element.count, thread_count,
+                      [&](int, size_t begin, size_t end_index)
+                      {
+                        double *outputs[8] = {mesh.px.data(), mesh.py.data(), mesh.pz.data(), mesh.nx.data(),
+                                              mesh.ny.data(), mesh.nz.data(), mesh.tu.data(), mesh.tv.data()};
+                        const int attribute_count = uvs ? 8 : (normals ? 6 : 3);
+                        for (size_t i = begin; i < end_index; i++)
+                        {
+                          const unsigned char *record = p + i * stride;
+                          for (int k = 0; k < attribute_count; k++)
+                          {
+                            if ((k >= 3 && k < 6 && !normals) || offsets[k] < 0)
+                            {
+                              continue;
+                            }
+                            if (all_float && !swap)
+                            {
+                              float value;
+                              std::memcpy(&value, record + offsets[k], sizeof(value));
+                              outputs[k][i] = value;
+                            }
+                            else
+                            {
+                              outputs[k][i] = ply_read_scalar(record + offsets[k], types[k], swap);
+                            }
+                          }
+                        }
+                      });
+  return true;
+};
+
+/**
+ * face element 의 정점 인덱스 list 를 읽어 삼각형 인덱스 배열에 기록
+ *
+ * - 모든 면이 삼각형이면 레코드 크기가 고정이므로, 면 단위로 나눠 병렬로 바로 기록한다. (먼저 병렬로 개수가 모두 3 인지 확인)
+ * - 사각형 등이 섞여 있으면 레코드 위치를 앞에서부터 차례로 찾아야 하므로 단일 thread 로 읽으며 fan 방식으로 삼각형 분할한다.
+ */
+inline bool ply_read_faces(const unsigned char *p, const unsigned char *end, const ply_element &element, bool swap, int thread_count,
+                           triangle_mesh_data &mesh)
+{
+  // 정점 인덱스 list 속성 찾기 (다른 속성이 모두 scalar 이면 레코드 내 위치가 고정됨)
+  int index_property = -1;
+  bool fixed_layout = true;
+  size_t list_offset = 0, scalar_size = 0;
+  for (size_t k = 0; k < element.properties.size(); k++)
+  {
+    const ply_property &property = element.properties[k];
+    if (property.is_list() && index_property < 0 && (property.name == "vertex_indices" || property.name == "vertex_index"))
+    {
+      index_property = static_cast<int>(k);
+      list_offset = scalar_size;
+    }
+    else if (property.is_list())
+    {
+      fixed_layout = false;
+    }
+    else
+    {
+      scalar_size += ply_type_size(property.type);
+    }
+  }
+  if (index_property < 0)
+  {
+    return false;
+  }
+
+  size_t vertex_count = mesh.vertex_count();
+  std::vector<char> chunk_ok(std::max(thread_count, 1), 1);
+
+  if (fixed_layout)
+  {
+    const ply_property &list = element.properties[index_property];
+    size_t count_size = ply_type_size(list.count_type), index_size = ply_type_size(list.type);
+    size_t stride = scalar_size + count_size + 3 * index_size;
+
+    // 모든 면이 삼각형인지 병렬로 확인
+    bool all_triangles = static_cast<size_t>(end - p) / stride >= element.count;
+    if (all_triangles)
+    {
+      int chunks = parallel_for_chunks(element.count, thread_count,
+                                       [&](int chunk, size_t begin, size_t end_index)
+                                       {
+                                         for (size_t i = begin; i < end_index; i++)
+                                         {
+                                           if (ply_read_scalar(p + i * stride + list_offset, list.count_type, swap) != 3.0f)
+                                           {
+                                             chunk_ok[chunk] = 0;
+                                             return;
+                                           }
+                                         }
+                                       });
+      for (int c = 0; c < chunks; c++)
+      {
+        all_triangles = all_triangles && chunk_ok[c];
+      }
+    }
+
+    if (all_triangles)
+    {
+      mesh.indices.resize(3 * element.count);
+      int chunks = parallel_for_chunks(element.count, thread_count,
+                                       [&](int chunk, size_t begin, size_t end_index)
+                                       {
+                                         for (size_t i = begin; i < end_index; i++)
+                                         {
+                                           const unsigned char *indices = p + i * stride + list_offset + count_size;
+                                           for (int k = 0; k < 3; k++)
+                                           {
+                                             double index = ply_read_scalar(indices + k * index_size, list.type, swap);
+                                             chunk_ok[chunk] &= index >= 0.0f && index < static_cast<double>(vertex_count);
+                                             mesh.indices[3 * i + k] = static_cast<uint32_t>(index);
+                                           }
+                                         }
+                                       });
+      for (int c = 0; c < chunks; c++)
+      {
+        if (!chunk_ok[c])
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+
+  // 다각형이 섞인 경우: 레코드를 차례로 읽으며 fan 분할
+  mesh.indices.clear();
+  mesh.indices.reserve(3 * element.count);
+  for (size_t i = 0; i < element.count; i++)
+  {
+    const unsigned char *record = p;
+    for (size_t k = 0; k < element.properties.size(); k++)
+    {
+      const ply_property &property = element.properties[k];
+      size_t count_size = property.is_list() ? ply_type_size(property.count_type) : 0;
+      if (record + count_size > end)
+      {
+        return false;
+      }
+      size_t count = property.is_list() ? static_cast<size_t>(std::max(ply_read_scalar(record, property.count_type, swap), 0.0)) : 1;
+      const unsigned char *values = record + count_size;
+      size_t value_size = ply_type_size(property.type);
+      if (values + count * value_size > end)
+      {
+        return false;
+      }
+
+      if (static_cast<int>(k) == index_property)
+      {
+        uint32_t first = 0, previous = 0;
+        for (size_t j = 0; j < count; j++)
+        {
+          double index = ply_read_scalar(values + j * value_size, property.type, swap);
+          if (index < 0.0f || index >= static_cast<double>(vertex_count))
+          {
+            return false;
+          }
+          uint32_t current = static_cast<uint32_t>(index);
+          if (j == 0)
+          {
+            first = current;
+          }
+          else if (j >= 2)
+          {
+            mesh.indices.push_back(first);
+            mesh.indices.push_back(previous);
+            mesh.indices.push_back(current);
+          }
+          previous = current;
+        }
+      }
+      record = values + count * value_size;
+    }
+    p = record;
+  }
+  return true;
+};
+
+// binary PLY 파일 로드 ("vertex" element 의 x, y, z / nx, ny, nz / u, v 속성과 "face" element 의 정점 인덱스 list 를 읽음)
+inline bool load_ply(const std::string &path, triangle_mesh_data &mesh, const mesh_load_options &options = mesh_load_options(),
+                     mesh_load_stats *stats = nullptr)
+{
+  auto load_start = std::chrono::steady_clock::now();
+  mesh.clear();
+
+  mapped_file file;
+  if (!file.open(path))
+  {
+    fprintf(stderr, "Error: could not open mesh file %s.\n", path.c_str());
+    return false;
+  }
+  file.prefetch();
+  auto map_end = std::chrono::steady_clock::now();
+
+  bool big_endian = false;
+  std::vector<ply_element> elements;
+  size_t body = 0;
+  if (!ply_parse_header(reinterpret_cast<const char *>(file.data()), file.size(), big_endian, elements, body))
+  {
+    fprintf(stderr, "Error: %s is not a binary PLY file.\n", path.c_str());
+    return false;
+  }
+
+  const uint16_t endian_probe = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &endian_probe, 1);
+  const bool swap = big_endian == (first_byte == 1); // 파일과 현재 머신의 바이트 순서가 다르면 뒤집어서 읽음
+  const int thread_count = file.size() >= options.parallel_threshold ? resolve_thread_count(options.thread_count) : 1;
+
+  // element 를 선언 순서대로 지나가며 vertex, face 만 읽고 나머지는 건너뜀
+  const unsigned char *p = file.data() + body, *end = file.data() + file.size();
+  bool has_vertices = false, has_faces = false;
+  for (const auto &element : elements)
+  {
+    if (element.name == "vertex" && !has_vertices)
+    {
+      if (!ply_read_vertices(p, end, element, swap, thread_count, mesh))
+      {
+        fprintf(stderr, "Error: unsupported or truncated vertex data in mesh file %s.\n", path.c_str());
+        mesh.clear();
+        return false;
+      }
+      has_vertices = true;
+    }
+    else if (element.name == "face" && has_vertices)
+    {
+      if (!ply_read_faces(p, end, element, swap, thread_count, mesh))
+      {
+        fprintf(stderr, "Error: unsupported or truncated face data in mesh file %s.\n", path.c_str());
+        mesh.clear();
+        return false;
+      }
+      has_faces = true;
+      break; // face 이후의 element 는 읽을 필요 없음
+    }
+
+    // 다음 element 위치로 이동
+    size_t stride = element.fixed_size();
+    if (stride > 0)
+    {
+      if (static_cast<size_t>(end - p) / stride < element.count)
+      {
+        break;
+      }
+      p += element.count * stride;
+    }
+    else
+    {
+      for (size_t i = 0; i < element.count && p; i++)
+      {
+        p = ply_skip_record(p, end, element, swap);
+      }
+      if (!p)
+      {
+        break;
+      }
+    }
+  }
+  if (!has_faces)
+  {
+    fprintf(stderr, "Error: mesh file %s has no vertex / face data.\n", path.c_str());
+    mesh.clear();
+    return false;
+  }
+  auto load_end = std::chrono::steady_clock::now();
+
+  mesh_load_stats result;
+  result.bytes = file.size();
+  result.vertex_count = mesh.vertex_count();
+  result.triangle_count = mesh.triangle_count();
+  result.thread_count = thread_count;
+  result.map_ms = std::chrono::duration<double, std::milli>(map_end - load_start).count();
+  result.parse_ms = std::chrono::duration<double, std::milli>(load_end - map_end).count();
+  result.total_ms = std::chrono::duration<double, std::milli>(load_end - load_start).count();
+  if (options.report_stats)
+  {
+    result.report(path);
+  }
+  if (stats)
+  {
+    *stats = result;
+  }
+  return true;
+};
+
+// 확장자(.obj / .ply)로 형식을 골라 메쉬 파일 로드
+inline bool load_mesh(const std::string &path, triangle_mesh_data &mesh, const mesh_load_options &options = mesh_load_options(),
+                      mesh_load_stats *stats = nullptr)
+{
+  std::string extension = mesh_file_extension(path);
+  if (extension == ".obj")
+  {
+    return load_obj(path, mesh, options, stats);
+  }
+  if (extension == ".ply")
+  {
+    return load_ply(path, mesh, options, stats);
+  }
+  fprintf(stderr, "Error: unsupported mesh file format %s.\n", path.c_str());
+  return false;
+};
+
+/**
+ * 메쉬 파일을 빠르게 읽는 방법
+ *
+ *
+ * std::ifstream + std::getline + std::stringstream 으로 OBJ 를 읽으면
+ * 1. 파일 내용을 커널 버퍼 -> ifstream 버퍼 -> 줄 std::string 으로 여러 번 복사하고,
+ * 2. 줄마다 std::string 할당 / 해제가 일어나며,
+ * 3. operator>> 는 로케일을 확인하며 문자 하나씩 읽으므로 느리고,
+ * 4. 단일 thread 로만 읽게 되어 수 GB 크기의 스캔 데이터는 디스크 대역폭보다 훨씬 느리게 로드된다.
+ *
+ * 여기서는
+ * ✅ 파일을 mmap 으로 매핑하고 MADV_WILLNEED 로 미리 읽기(readahead)를 요청해서, 복사 없이 페이지 캐시를 바로 읽는다.
+ * ✅ 파일을 thread 개수만큼의 바이트 구간으로 자르고, 각 구간 경계는 다음 줄 시작으로 맞춰서 줄이 두 구간에 걸치지 않게 한다.
+ * ✅ 1 패스에서 구간별 원소 개수만 세고(memchr 로 줄 끝 탐색), prefix sum 으로 구간별 쓰기 위치를 정한 뒤
+ *    2 패스에서 각 thread 가 SoA 배열의 자기 위치에 바로 기록한다. (결과 순서는 파일 순서와 같음, 배열 재할당 / 병합 없음)
+ * ✅ binary PLY 는 레코드 크기가 고정이므로 레코드 번호만으로 위치를 계산해서 바로 병렬로 읽는다.
+ *
+ * ⚠️ OBJ 의 음수(상대) 인덱스는 '그 줄까지 정의된 정점 개수' 기준이므로, 구간 시작 위치(prefix sum)에 구간 내 개수를 더해서 계산한다.
+ * ⚠️ OBJ 는 위치 / uv / 노멀이 서로 다른 인덱스를 가질 수 있다. 이 경우만 단일 thread 로 정점을 새로 만들어 통합한다. (obj_unify_attributes())
+ */
+
+#endif /* MESH_LOADER_HPP */
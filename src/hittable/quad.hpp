@@ -41,7 +41,27 @@ public:
   aabb bounding_box() const override { return bbox; };
 
   // 순수 가상 함수 hit 재정의(override)
+  // -> 교차 t 계산(intersect)과 충돌 정보 계산(finalize) 두 단계로 나누어 수행 (leaf_primitives.hpp 하단 필기 '교차 t 탐색과 충돌 정보 계산의 분리' 참고)
   bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    double t;
+    if (!intersect(r, ray_t, t))
+    {
+      return false;
+    }
+    finalize(r, t, rec);
+    return true;
+  };
+
+  // 평면 교차 및 quad 내부 여부만 검사하고 충돌 정보(normal, material)는 기록하지 않음
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    double t;
+    return intersect(r, ray_t, t);
+  };
+
+  // 1단계: 평면 교차 t 계산 및 quad 내부 여부만 검사 (교차점 좌표, normal, uv, material 은 기록하지 않음)
+  bool intersect(const ray &r, interval ray_t, double &t) const
   {
     /** Ray - Plane(quad 가 속한 평면) intersection 검사 (하단 관련 필기 참고) */
 
@@ -56,7 +76,7 @@ public:
     }
 
     // 평면과의 교차 지점 파라미터 t(= 교차 판별식) 계산
-    auto t = (D - dot(normal, r.origin())) / denom;
+    t = (D - dot(normal, r.origin())) / denom;
 
     // t 값(= 교차 지점)이 ray의 유효한 범위 밖이면 무시
     if (!ray_t.contains(t))
@@ -64,13 +84,10 @@ public:
       return false;
     }
 
-    // 교차 지점 위치 계산
-    auto intersection = r.at(t);
-
     /** 평면 내 임의의 교차점 P 를 UV 좌표계로 변환하기 (하단 관련 필기 참고) */
 
     // Q 기준으로 평면 위 교차점까지의 벡터 p = P - Q 계산
-    vec3 planar_hitpt_vector = intersection - Q;
+    vec3 planar_hitpt_vector = r.at(t) - Q;
 
     // α = w ⋅ (p × v), β = w ⋅ (u × p)
     // → P = Q + αu + βv 를 만족하는 α, β 구함
@@ -78,19 +95,28 @@ public:
     auto beta = dot(w, cross(u, planar_hitpt_vector));
 
     // UV 좌표계로 변환된 α, β 값으로 교차점 P 가 quad 내부에 있는지 검사 -> 교차점 P 가 quad 외부에 있다면 무시
-    if (!is_interior(alpha, beta, rec))
-    {
-      return false;
-    }
+    // (is_interior() 는 하위 클래스에서 재정의될 수 있으므로 그대로 사용하고, uv 좌표는 버리는 임시 hit_record 에 기록)
+    hit_record scratch;
+    return is_interior(alpha, beta, scratch);
+  };
+
+  // 2단계: intersect() 로 찾은 t 로 교차점, uv, normal, material 을 hit_record 에 기록 (가장 가까운 교차점 하나에 대해서만 호출하면 됨)
+  void finalize(const ray &r, double t, hit_record &rec) const
+  {
+    // 교차 지점 위치 계산
+    auto intersection = r.at(t);
+
+    // intersect() 와 같은 식으로 α, β 를 다시 계산하여 uv 좌표로 기록 (같은 t 에서 계산하므로 내부 판정 결과도 같음)
+    vec3 planar_hitpt_vector = intersection - Q;
+    auto alpha = dot(w, cross(planar_hitpt_vector, v));
+    auto beta = dot(w, cross(u, planar_hitpt_vector));
+    is_interior(alpha, beta, rec);
 
     // hit_record 에 정보 기록
     rec.t = t;
     rec.p = intersection;
-    rec.mat = mat;
+    rec.mat = mat.get();
     rec.set_face_normal(r, normal); // 앞면/뒷면 여부 판정 포함한 노멀 설정
-
-    // 여기까지 통과했으면 교차 성공으로 판단
-    return true;
   };
 
   // quad 내부 여부 판단 함수
@@ -125,39 +151,6 @@ private:
   double D;                      // quad 가 속한 평면 방정식의 상수 D = n ⋅ Q
 };
 
-// quad 기반 3D 박스 생성 함수: 두 대각선 정점 a, b와 재질 mat을 받아 여섯 개의 면으로 구성된 hittable_list를 반환
-inline std::shared_ptr<hittable_list> box(const point3 &a, const point3 &b, std::shared_ptr<material> mat)
-{
-  // 박스 여섯 면을 담을 hittable_list를 생성
-  auto sides = std::make_shared<hittable_list>();
-
-  // 두 점 a, b 중 작은 값을 min, 큰 값을 max로 설정하여 3D box 의 min, max 범위 지정
-  auto min = point3(std::fmin(a.x(), b.x()), std::fmin(a.y(), b.y()), std::fmin(a.z(), b.z()));
-  auto max = point3(std::fmax(a.x(), b.x()), std::fmax(a.y(), b.y()), std::fmax(a.z(), b.z()));
-
-  // 3D box 의 각 축 방향 벡터 계산: 박스의 크기 벡터로 사용됨
-  auto dx = vec3(max.x() - min.x(), 0.0f, 0.0f); // x축 방향 크기 벡터
-  auto dy = vec3(0.0f, max.y() - min.y(), 0.0f); // y축 방향 크기 벡터
-  auto dz = vec3(0.0f, 0.0f, max.z() - min.z()); // z축 방향 크기 벡터
-
-  /** 박스의 크기 벡터와 min, max 값으로 3D box 각 면의 quad 파라미터 계산 및 생성 */
-  // 정면(front) 면: (min x, min y, max z) 지점을 기준점 Q 로 정하고 dx, dy 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(min.x(), min.y(), max.z()), dx, dy, mat));
-  // 오른쪽(right) 면: (max x, min y, max z) 지점을 기준점 Q 로 정하고 -dz, dy 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(max.x(), min.y(), max.z()), -dz, dy, mat));
-  // 뒷면(back) 면: (max x, min y, min z) 지점을 기준점 Q 로 정하고 -dx, dy 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(max.x(), min.y(), min.z()), -dx, dy, mat));
-  // 왼쪽(left) 면: (min x, min y, min z) 지점을 기준점 Q 로 정하고 dz, dy 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(min.x(), min.y(), min.z()), dz, dy, mat));
-  // 윗면(top) 면: (min x, max y, max z) 지점을 기준점 Q 로 정하고 dx, -dz 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(min.x(), max.y(), max.z()), dx, -dz, mat));
-  // 바닥(bottom) 면: (min x, min y, min z) 지점을 기준점 Q 로 정하고 dx, dz 방향으로 펼침
-  sides->add(std::make_shared<quad>(point3(min.x(), min.y(), min.z()), dx, dz, mat));
-
-  // 박스 여섯 면이 담긴 hittable_list 반환
-  return sides;
-};
-
 /**
  * 주어진 quad 가 속한 평면의 수학적 정의(= 평면의 방정식)
  *
@@ -44,7 +44,20 @@ public:
   };
 
   // 순수 가상 함수 hit 재정의(override)
+  // -> 교차 t 계산(intersect)과 충돌 정보 계산(finalize) 두 단계로 나누어 수행 (leaf_primitives.hpp 하단 필기 '교차 t 탐색과 충돌 정보 계산의 분리' 참고)
   bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    double t;
+    if (!intersect(r, ray_t, t))
+    {
+      return false;
+    }
+    finalize(r, t, rec);
+    return true;
+  }
+
+  // 1단계: 반직선 유효범위 내에서 가장 가까운 교차점의 비율값 t 만 계산 (normal, uv, material 은 계산하지 않음)
+  bool intersect(const ray &r, interval ray_t, double &t) const
   {
     // 광선의 생성 시점(r.time())에 따라 현재 구체 중심(current_center)을 계산함 (하단 필기 참고)
     point3 current_center = center.at(r.time());
@@ -79,30 +92,61 @@ public:
       }
     }
 
-    // 반직선 유효범위 내의 비율값 t 가 존재한다면, 이 비율값으로 충돌 정보를 출력 매개변수 rec 에 저장함.
-    // (https://raytracing.github.io/books/RayTracingInOneWeekend.html#surfacenormalsandmultipleobjects/shadingwithsurfacenormals > 구체 표면 상의 노멀벡터 계산 관련 Figure 6 참고)
-    rec.t = root;                                            // 반직선 상에서 충돌 지점이 위치하는 비율값 t 계산
+    // 반직선 유효범위 내의 비율값 t가 존재한다면, 구체와 반직선의 충돌 지점이 존재하는 것으로 판단하여 true 반환
+    t = root;
+    return true;
+  }
+
+  // 2단계: intersect() 로 찾은 비율값 t 로 충돌 정보를 출력 매개변수 rec 에 저장함. (가장 가까운 교차점 하나에 대해서만 호출하면 됨)
+  // (https://raytracing.github.io/books/RayTracingInOneWeekend.html#surfacenormalsandmultipleobjects/shadingwithsurfacenormals > 구체 표면 상의 노멀벡터 계산 관련 Figure 6 참고)
+  void finalize(const ray &r, double t, hit_record &rec) const
+  {
+    point3 current_center = center.at(r.time());
+
+    rec.t = t;                                               // 반직선 상에서 충돌 지점이 위치하는 비율값 t 계산
     rec.p = r.at(rec.t);                                     // 충돌 지점의 좌표값 계산
     vec3 outward_normal = (rec.p - current_center) / radius; // 구체 표면 상에서 충돌 지점의 정규화된 normal 계산
     rec.set_face_normal(r, outward_normal);                  // ray 위치와 그에 따른 충돌 지점의 normal 재계산
     get_sphere_uv(outward_normal, rec.u, rec.v);             // 단위 구 기준 충돌 지점을 구면 좌표계로 변환하여 (u,v) 텍스처 좌표 계산
-    rec.mat = mat;                                           // ray 충돌 지점에서 산란 계산 시 적용할 material 포인터 복사
+    rec.mat = mat.get();                                     // ray 충돌 지점에서 산란 계산 시 적용할 material 포인터 복사
+  };
 
-    // 반직선 유효범위 내의 비율값 t가 존재한다면, 구체와 반직선의 충돌 지점이 존재하는 것으로 판단하여 true 반환
-    return true;
-  }
+  // 교차점의 t 값만 판별식으로 검사하고 충돌 정보(normal, uv, material)는 계산하지 않음
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    vec3 oc = r.origin() - center.at(r.time());
+    auto a = r.direction().length_squared();
+    auto half_b = dot(oc, r.direction());
+    auto c = oc.length_squared() - radius * radius;
+
+    auto discriminant = half_b * half_b - a * c;
+    if (discriminant < 0)
+      return false;
+
+    // 두 교차점 중 하나라도 유효범위 내에 있으면 가려진 것으로 판단
+    auto sqrtd = sqrt(discriminant);
+    return ray_t.surrounds((-half_b - sqrtd) / a) || ray_t.surrounds((-half_b + sqrtd) / a);
+  };
 
   // 구체의 AABB 반환 함수
   aabb bounding_box() const override { return bbox; };
 
-private:
+  // time 시점의 구체 중심 기준 AABB 반환 (중심이 선형 이동하므로 time 0 / 1 시점 AABB 의 선형 보간과 같음)
+  aabb bounding_box_at(double time) const override
+  {
+    auto rvec = vec3(radius, radius, radius);
+    return aabb(center.at(time) - rvec, center.at(time) + rvec);
+  };
+
+public:
   // 중심이 원점이고 반지름이 1인 단위 구 위의 점 p(= 데카르트 좌표계)를 구면 좌표계로 변환 후, (u, v) 텍스쳐 좌표 [0, 1] 범위로 맵핑해주는 함수
+  // (sphere_set 도 같은 uv 를 계산하도록 public 으로 공개)
   static void get_sphere_uv(const point3 &p, double &u, double &v)
   {
     // 고도각 θ: 아래쪽 극점(-Y)에서 위로 향하는 각도, acos(-y) → [0, π] 범위
-    auto theta = std::acos(-p.y());
+    auto theta = rtw_acos(-p.y());
     // 방위각 ϕ: +X축 기준 반시계 방향 회전 각도, atan2(-z, x) + π → [0, 2π] 범위
-    auto phi = std::atan2(-p.z(), p.x()) + pi;
+    auto phi = rtw_atan2(-p.z(), p.x()) + pi;
 
     // u: 방위각 ϕ를 [0, 2π] → [0, 1]로 정규화하여 u좌표값 계산
     u = phi / (2.0f * pi);
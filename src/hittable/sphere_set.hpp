@@ -0,0 +1,378 @@
+#ifndef SPHERE_SET_HPP
+#define SPHERE_SET_HPP
+
+#include "hittable.hpp"
+#include "sphere.hpp"
+#include "accelerator/bvh_build.hpp"
+#include "accelerator/bvh_flat.hpp"
+#include "common/aligned_allocator.hpp"
+#include "common/simd.hpp"
+#include "common/vec3xn.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 구체 4 개를 lane 별로 묶은 packet (packet 내부는 컴포넌트별 배열, SoA)
+ *
+ * - 같은 컴포넌트 4 개가 연속으로 놓이므로 lanes<double, 4>::load() 한 번으로 4 개 구체의 같은 값을 레지스터에 올릴 수 있다.
+ *   (중심과 이동량은 vec3xn<double, 4>::load() 로 x, y, z 세 레지스터에 한 번에 올려서 lane 별 벡터 연산에 사용)
+ * - 구체가 4 개보다 적은 packet 의 남는 lane 은 중심을 NaN 으로 채워서, 판별식 비교가 항상 거짓이 되도록 한다.
+ */
+class alignas(64) sphere_packet
+{
+public:
+  static const int width = 4;
+
+  double center_x[width], center_y[width], center_z[width]; // time = 0 시점 중심
+  double motion_x[width], motion_y[width], motion_z[width]; // time 0 -> 1 동안의 이동량 (정적 구체는 0)
+  double radius[width];                                     // 반지름
+  uint32_t material[width];                                 // sphere_set::materials 내 material 인덱스
+};
+
+static_assert(sizeof(sphere_packet) == 256, "sphere_packet must be 256 bytes");
+
+/**
+ * SoA 구체 집합(sphere set) 클래스
+ *
+ * - 작은 구체가 아주 많은 scene(bouncing_spheres 의 소형 구체, 입자 등)에서 구체마다 sphere 객체를 만드는 대신,
+ *   구체들의 중심 / 이동량 / 반지름 / material 인덱스만 sphere_packet 배열에 모아서 hittable 하나로 다룬다.
+ *   (구체마다 shared_ptr<material> 과 ray 로 표현된 중심, AABB 를 들고 있지 않음)
+ * - 내부에 자체 BVH(bvh_flat_node 배열)를 구축하고, 리프 하나의 구체들을 packet 단위로 재배치해서
+ *   리프 방문 시 packet 하나(구체 4 개)와의 교차 검사를 lanes<double, 4> 연산 한 번에 수행한다.
+ *   (SIMD 백엔드가 켜진 빌드에서는 AVX 레지스터 하나, 꺼진 빌드에서는 컴파일러 auto-vectorization)
+ * - 순회 중에는 t 와 구체 위치만 기록하고, hit_record(노멀, uv, material)는 가장 가까운 구체 하나에 대해서만 계산한다.
+ * - tlas 와 같이 add() 로 구체를 추가한 뒤 rebuild() 로 내부 BVH 를 구축해야 교차 검사에 반영된다.
+ */
+class sphere_set : public hittable
+{
+public:
+  sphere_set(const bvh_build_options &options = bvh_build_options()) : options(options) {};
+
+  // 정적 구체 추가
+  void add(const point3 &center, double radius, std::shared_ptr<material> mat)
+  {
+    add(center, center, radius, mat);
+  };
+
+  // time = 0 에 center1, time = 1 에 center2 에 있는 동적 구체 추가 (음수 반지름은 0 으로 제한)
+  void add(const point3 &center1, const point3 &center2, double radius, std::shared_ptr<material> mat)
+  {
+    centers.push_back(center1);
+    motions.push_back(center2 - center1);
+    radii.push_back(std::fmax(0.0f, radius));
+    material_ids.push_back(material_index(mat));
+  };
+
+  // 추가된 구체들로 packet 배열과 내부 BVH 를 다시 구축
+  void rebuild()
+  {
+    nodes.clear();
+    packets.clear();
+    bbox = aabb();
+
+    size_t count = centers.size();
+    if (count == 0)
+    {
+      return;
+    }
+
+    std::vector<aabb> bounds(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      bounds[i] = sphere_bounds(i);
+    }
+
+    // packet 하나(최대 4 개 구체)를 검사하는 비용은 구체 하나를 검사하는 비용과 거의 같으므로,
+    // SAH 비용 모델의 primitive 당 교차 비용을 packet 폭만큼 나눠서 리프가 packet 을 채우도록 유도
+    bvh_build_options build_options = options;
+    build_options.max_leaf_size = sphere_packet::width;
+    build_options.intersection_cost = options.intersection_cost / sphere_packet::width;
+    if (build_options.max_depth > bvh_stack_capacity)
+    {
+      build_options.max_depth = bvh_stack_capacity;
+    }
+    bvh_builder builder(bounds, build_options);
+
+    bbox = builder.nodes[builder.root].bbox;
+    nodes.reserve(builder.nodes.size());
+    packets.reserve(count / sphere_packet::width + builder.nodes.size());
+    flatten_bvh(builder, builder.root, nodes,
+                [&](const bvh_build_node &build_node, bvh_flat_node &node)
+                {
+                  // 리프의 구체들을 packet 배열에 차례로 채우고, 리프는 채워진 packet 범위를 참조
+                  uint32_t first_packet = static_cast<uint32_t>(packets.size());
+                  for (size_t k = 0; k < build_node.count; k++)
+                  {
+                    if (k % sphere_packet::width == 0)
+                    {
+                      packets.push_back(empty_packet());
+                    }
+                    store_lane(packets.back(), k % sphere_packet::width, builder.prim_indices[build_node.first + k]);
+                  }
+                  node.offset = first_packet;
+                  node.count = static_cast<uint16_t>(packets.size() - first_packet);
+                });
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    if (nodes.empty())
+    {
+      return false;
+    }
+
+    // flat_bvh 와 같은 near child first 순회 (bvh_traversal.hpp 참고), 리프에서는 packet 단위로 교차 검사
+    const traversal_ray tr(r);
+    const packet_ray pr(r);
+    uint32_t closest_packet = 0;
+    int closest_lane = 0;
+    bool hit_anything = bvh_traverse_closest(nodes.data(), tr, ray_t,
+                                             [&](const bvh_flat_node &node, interval &ray_t)
+                                             {
+                                               bool hit_leaf = false;
+                                               for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                                               {
+                                                 int lane;
+                                                 double t;
+                                                 if (intersect(packets[i], pr, ray_t, t, lane))
+                                                 {
+                                                   hit_leaf = true;
+                                                   ray_t.max = t;
+                                                   closest_packet = i;
+                                                   closest_lane = lane;
+                                                 }
+                                               }
+                                               return hit_leaf;
+                                             });
+
+    if (!hit_anything)
+    {
+      return false;
+    }
+    fill_record(packets[closest_packet], closest_lane, r, ray_t.max, rec);
+    return true;
+  };
+
+  // 차폐 검사: packet 중 하나라도 교차하는 lane 이 있으면 즉시 종료
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    if (nodes.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    const packet_ray pr(r);
+    return bvh_traverse_any(nodes.data(), tr, ray_t,
+                            [&](const bvh_flat_node &node, interval ray_t)
+                            {
+                              for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                              {
+                                if (any(valid_lanes(packets[i], pr, ray_t)))
+                                {
+                                  return true;
+                                }
+                              }
+                              return false;
+                            });
+  };
+
+  aabb bounding_box() const override { return bbox; };
+
+  // time 시점의 구체 중심 기준 AABB 들을 모두 감싸는 AABB 반환
+  aabb bounding_box_at(double time) const override
+  {
+    aabb box;
+    for (size_t i = 0; i < centers.size(); i++)
+    {
+      point3 center = centers[i] + time * motions[i];
+      vec3 rvec(radii[i], radii[i], radii[i]);
+      box = aabb(box, aabb(center - rvec, center + rvec));
+    }
+    return box;
+  };
+
+  size_t size() const { return centers.size(); };
+  size_t packet_count() const { return packets.size(); };
+
+private:
+  using lane_type = lanes<double, sphere_packet::width>;
+  using mask_type = lane_mask<double, sphere_packet::width>;
+  using vec3_lanes = vec3xn<double, sphere_packet::width>;
+
+  // packet 교차 검사에 필요한 광선 값을 lane 에 미리 broadcast 해둔 것
+  class packet_ray
+  {
+  public:
+    explicit packet_ray(const ray &r)
+        : origin(r.origin()), direction(r.direction()), time(r.time()), a(r.direction().length_squared()) {};
+
+    vec3_lanes origin;
+    vec3_lanes direction;
+    lane_type time;
+    lane_type a; // 방향벡터 길이 제곱 (sphere::hit() 의 a)
+  };
+
+  bvh_build_options options; // 내부 BVH 빌드 옵션
+
+  // add() 로 추가된 구체 (rebuild() 의 입력)
+  std::vector<point3> centers;
+  std::vector<vec3> motions;
+  std::vector<double> radii;
+  std::vector<uint32_t> material_ids;
+
+  // material 은 서로 다른 포인터만 한 번씩 저장하고, 구체는 인덱스로 참조
+  std::vector<std::shared_ptr<material>> materials;
+  std::unordered_map<const material *, uint32_t> material_lookup;
+
+  bvh_flat_node_array nodes;                                                // 내부 BVH 노드 배열 (리프는 packet 범위를 참조)
+  std::vector<sphere_packet, aligned_allocator<sphere_packet, 64>> packets; // BVH 리프 순서대로 나열된 구체 packet 배열
+  aabb bbox;                                                                // 셔터 구간 전체에서 모든 구체를 감싸는 AABB
+
+private:
+  uint32_t material_index(const std::shared_ptr<material> &mat)
+  {
+    auto found = material_lookup.find(mat.get());
+    if (found != material_lookup.end())
+    {
+      return found->second;
+    }
+    uint32_t index = static_cast<uint32_t>(materials.size());
+    materials.push_back(mat);
+    material_lookup[mat.get()] = index;
+    return index;
+  };
+
+  // i 번째 구체의 셔터 구간 전체 AABB (time 0 / 1 시점 AABB 의 합집합, sphere 와 동일)
+  aabb sphere_bounds(size_t i) const
+  {
+    vec3 rvec(radii[i], radii[i], radii[i]);
+    point3 center2 = centers[i] + motions[i];
+    return aabb(aabb(centers[i] - rvec, centers[i] + rvec), aabb(center2 - rvec, center2 + rvec));
+  };
+
+  // 모든 lane 이 비어 있는 packet (중심이 NaN 이므로 어떤 광선과도 교차하지 않음)
+  static sphere_packet empty_packet()
+  {
+    sphere_packet packet;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (int lane = 0; lane < sphere_packet::width; lane++)
+    {
+      packet.center_x[lane] = packet.center_y[lane] = packet.center_z[lane] = nan;
+      packet.motion_x[lane] = packet.motion_y[lane] = packet.motion_z[lane] = 0.0f;
+      packet.radius[lane] = 0.0f;
+      packet.material[lane] = 0;
+    }
+    return packet;
+  };
+
+  void store_lane(sphere_packet &packet, int lane, size_t i) const
+  {
+    packet.center_x[lane] = centers[i].x();
+    packet.center_y[lane] = centers[i].y();
+    packet.center_z[lane] = centers[i].z();
+    packet.motion_x[lane] = motions[i].x();
+    packet.motion_y[lane] = motions[i].y();
+    packet.motion_z[lane] = motions[i].z();
+    packet.radius[lane] = radii[i];
+    packet.material[lane] = material_ids[i];
+  };
+
+  /**
+   * packet 의 구체 4 개와 광선의 교차 검사 (sphere::hit() 의 판별식을 lane 별로 동시에 계산)
+   *
+   * - 각 lane 에서 ray_t 범위 안의 가장 가까운 근(root)을 구하고, 없는 lane 은 무한대로 둔다.
+   * - 반환값 mask 는 유효한 근이 있는 lane, roots 는 lane 별 근
+   */
+  static mask_type lane_roots(const sphere_packet &packet, const packet_ray &pr, interval ray_t, lane_type &roots)
+  {
+    // 광선 시점의 구체 중심 = center + time * motion
+    vec3_lanes center = vec3_lanes::load(packet.center_x, packet.center_y, packet.center_z) +
+                        pr.time * vec3_lanes::load(packet.motion_x, packet.motion_y, packet.motion_z);
+    vec3_lanes oc = pr.origin - center;
+    lane_type radius = lane_type::load(packet.radius);
+
+    lane_type half_b = dot(oc, pr.direction);
+    lane_type c = oc.length_squared() - radius * radius;
+    lane_type discriminant = half_b * half_b - pr.a * c;
+
+    // 판별식이 음수인 lane(과 중심이 NaN 인 빈 lane)은 비교 결과가 모두 거짓
+    mask_type real = discriminant >= lane_type(0.0);
+    lane_type sqrtd = sqrt(max(discriminant, lane_type(0.0)));
+    lane_type t_min(ray_t.min), t_max(ray_t.max);
+
+    lane_type root_near = (-half_b - sqrtd) / pr.a;
+    lane_type root_far = (-half_b + sqrtd) / pr.a;
+    mask_type near_valid = real & (root_near > t_min) & (root_near < t_max);
+    mask_type far_valid = real & (root_far > t_min) & (root_far < t_max);
+
+    roots = select(near_valid, root_near, select(far_valid, root_far, lane_type(infinity)));
+    return near_valid | far_valid;
+  };
+
+  static mask_type valid_lanes(const sphere_packet &packet, const packet_ray &pr, interval ray_t)
+  {
+    lane_type roots;
+    return lane_roots(packet, pr, ray_t, roots);
+  };
+
+  // packet 에서 가장 가까운 교차 lane 과 그 t 를 출력 (교차하는 lane 이 없으면 false)
+  static bool intersect(const sphere_packet &packet, const packet_ray &pr, interval ray_t, double &t, int &lane)
+  {
+    lane_type roots;
+    int bits = lane_roots(packet, pr, ray_t, roots).bits();
+    if (bits == 0)
+    {
+      return false;
+    }
+
+    double values[sphere_packet::width];
+    roots.store(values);
+    lane = -1;
+    t = ray_t.max;
+    for (int i = 0; i < sphere_packet::width; i++)
+    {
+      if (((bits >> i) & 1) && values[i] < t)
+      {
+        t = values[i];
+        lane = i;
+      }
+    }
+    return lane >= 0;
+  };
+
+  // 가장 가까운 구체 하나에 대해서만 교차점, 노멀, uv, material 을 계산하여 hit_record 에 기록 (sphere::hit() 과 동일)
+  void fill_record(const sphere_packet &packet, int lane, const ray &r, double t, hit_record &rec) const
+  {
+    point3 center = point3(packet.center_x[lane], packet.center_y[lane], packet.center_z[lane]) +
+                    r.time() * vec3(packet.motion_x[lane], packet.motion_y[lane], packet.motion_z[lane]);
+    rec.t = t;
+    rec.p = r.at(t);
+    vec3 outward_normal = (rec.p - center) / packet.radius[lane];
+    rec.set_face_normal(r, outward_normal);
+    sphere::get_sphere_uv(outward_normal, rec.u, rec.v);
+    rec.mat = materials[packet.material[lane]].get();
+  };
+};
+
+/**
+ * 구체 packet 교차 검사
+ *
+ *
+ * sphere 객체를 BVH 리프에 하나씩 두면 구체마다
+ * - shared_ptr 를 따라 힙의 sphere 객체로 이동해서 (캐시 미스) 가상 함수로 hit() 를 호출하고,
+ * - 판별식을 스칼라로 계산한 뒤 분기로 근을 고르며,
+ * - 교차할 때마다 노멀 / uv(acos, atan2) / material shared_ptr 복사까지 수행한다. (나중에 더 가까운 구체가 나오면 버려짐)
+ *
+ * sphere_set 은
+ * ✅ 리프의 구체 4 개가 packet 하나(256 바이트, 캐시 라인 4 개)에 연속으로 놓이므로 포인터를 따라가지 않고,
+ * ✅ 판별식과 두 근, ray_t 범위 검사를 lane 별로 동시에 계산하고 select 로 근을 골라 분기 없이 처리하며,
+ * ✅ 순회가 끝난 뒤 가장 가까운 구체 하나에 대해서만 hit_record 를 채운다.
+ * ⚠️ double lane 4 개이므로 한 번에 검사하는 구체 수는 4 개이다. float lane 8 개를 쓰면 두 배로 늘릴 수 있지만,
+ *    sphere::hit() 과 결과(t)가 달라지고 큰 구체나 먼 거리에서 판별식의 정밀도가 부족해질 수 있어 double 을 사용한다.
+ */
+
+#endif /* SPHERE_SET_HPP */
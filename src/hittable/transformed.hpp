@@ -0,0 +1,162 @@
+#ifndef TRANSFORMED_HPP
+#define TRANSFORMED_HPP
+
+#include "hittable.hpp"
+#include "hittable_list.hpp"
+#include "common/transform.hpp"
+
+/**
+ * transformed 클래스
+ *
+ * - 임의의 hittable object 를 아핀 변환(회전/스케일/이동의 조합)으로 배치하는 래퍼 클래스.
+ * - translate 클래스와 같은 방식으로 object 는 그대로 두고 광선을 object 로컬 좌표계로 역변환하여 hit test 를 수행하며,
+ *   instance 클래스(공유 BLAS 배치)도 BLAS 의 가속 구조를 transformed 로 감싸서 같은 변환 경로를 사용한다.
+ * - 로컬 -> 월드 변환과 그 역변환, 월드 좌표계 AABB 는 생성 시 한 번만 계산해서 캐싱한다. (hit 마다 sin/cos 나 역행렬 계산 없음)
+ * - 여러 래퍼를 겹쳐 쓰는 대신 make_transformed() 로 생성하면, 안쪽의 translate / transformed 래퍼가 행렬 하나로 합쳐진다. (하단 필기 참고)
+ */
+class transformed : public hittable
+{
+public:
+  transformed(std::shared_ptr<hittable> object, const transform &object_to_world)
+      : object(object), local_to_world(object_to_world), world_to_local(object_to_world.inverse())
+  {
+    bbox = transform_bbox(local_to_world, object->bounding_box());
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    // 월드 좌표계 ray 를 object 로컬 좌표계 ray 로 변환
+    // -> 방향벡터를 정규화하지 않으므로 로컬 좌표계에서 구한 t 가 월드 좌표계 ray 의 t 와 동일함 (ray_t 그대로 사용)
+    ray local_r(world_to_local.apply_point(r.origin()), world_to_local.apply_vector(r.direction()), r.time());
+
+    if (!object->hit(local_r, ray_t, rec))
+    {
+      return false;
+    }
+
+    // 충돌 지점은 로컬 -> 월드 변환, 노멀은 역변환의 전치로 월드 좌표계에 복원
+    // -> dot(normal, direction) 의 부호는 변환 전후로 보존되므로 front_face 는 다시 계산할 필요 없음
+    rec.p = local_to_world.apply_point(rec.p);
+    rec.normal = unit_vector(world_to_local.apply_normal_transposed(rec.normal));
+    return true;
+  };
+
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    ray local_r(world_to_local.apply_point(r.origin()), world_to_local.apply_vector(r.direction()), r.time());
+    return object->occluded(local_r, ray_t);
+  };
+
+  // 월드 좌표계 기준 AABB 반환
+  aabb bounding_box() const override { return bbox; };
+
+  // 내부 object 의 time 시점 AABB 를 월드 좌표계로 변환
+  aabb bounding_box_at(double time) const override { return transform_bbox(local_to_world, object->bounding_box_at(time)); };
+
+  // 감싸고 있는 로컬 좌표계 object 와 로컬 -> 월드 변환 반환
+  const std::shared_ptr<hittable> &inner() const { return object; };
+  const transform &object_to_world() const { return local_to_world; };
+
+private:
+  std::shared_ptr<hittable> object; // 로컬 좌표계 기준으로 정의된 실제 hittable object
+  transform local_to_world;         // object 로컬 좌표계 -> 월드 좌표계 변환
+  transform world_to_local;         // 월드 좌표계 -> object 로컬 좌표계 변환 (캐싱된 역변환)
+  aabb bbox;                        // 월드 좌표계 기준 AABB
+};
+
+/**
+ * object 를 object_to_world 변환으로 배치한 transformed 생성
+ * → object 가 이미 translate / transformed 래퍼라면 래퍼를 벗겨내며 변환을 누적하여, 가장 안쪽 object 를 감싸는 transformed 하나만 만든다.
+ */
+inline std::shared_ptr<hittable> make_transformed(std::shared_ptr<hittable> object, const transform &object_to_world)
+{
+  transform accumulated = object_to_world;
+  while (true)
+  {
+    if (auto wrapper = std::dynamic_pointer_cast<transformed>(object))
+    {
+      accumulated = accumulated * wrapper->object_to_world();
+      object = wrapper->inner();
+    }
+    else if (auto wrapper = std::dynamic_pointer_cast<translate>(object))
+    {
+      accumulated = accumulated * transform::translation(wrapper->translation());
+      object = wrapper->inner();
+    }
+    else
+    {
+      break;
+    }
+  }
+  return std::make_shared<transformed>(object, accumulated);
+};
+
+/**
+ * 두 겹 이상 중첩된 변환 래퍼(translate / transformed)를 transformed 하나로 합침
+ * → 래퍼가 없거나 translate 한 겹뿐이면 그대로 반환 (translate 는 행렬 곱 없이 덧셈만 하므로 더 저렴함)
+ */
+inline std::shared_ptr<hittable> collapse_transforms(const std::shared_ptr<hittable> &object)
+{
+  int depth = 0;
+  bool translation_only = true;
+  vec3 offset(0.0f, 0.0f, 0.0f); // translate 만 중첩된 경우의 이동량 합
+  std::shared_ptr<hittable> current = object;
+  while (true)
+  {
+    if (auto wrapper = std::dynamic_pointer_cast<transformed>(current))
+    {
+      translation_only = false;
+      current = wrapper->inner();
+    }
+    else if (auto wrapper = std::dynamic_pointer_cast<translate>(current))
+    {
+      offset += wrapper->translation();
+      current = wrapper->inner();
+    }
+    else
+    {
+      break;
+    }
+    depth++;
+  }
+
+  if (depth < 2)
+  {
+    return object;
+  }
+  if (translation_only)
+  {
+    return std::make_shared<translate>(current, offset);
+  }
+  return make_transformed(object, transform());
+};
+
+// scene 의 최상위 object 들에 대해 중첩된 변환 래퍼를 합침 (가속 구조 구축 직전에 한 번 호출)
+inline void collapse_transforms(hittable_list &world)
+{
+  for (auto &object : world.objects)
+  {
+    object = collapse_transforms(object);
+  }
+};
+
+/**
+ * 변환 래퍼 중첩 vs 행렬 하나
+ *
+ *
+ * translate(rotate(scale(object))) 처럼 래퍼를 겹쳐서 변환을 표현하면, 광선 하나가 object 에 도달할 때마다
+ * 1. 래퍼 개수만큼 가상 함수 hit() 을 연달아 호출하고,
+ * 2. 래퍼마다 광선을 한 번씩 변환하며 (회전 래퍼가 각도만 저장한다면 매번 sin/cos 도 계산),
+ * 3. 돌아오는 길에 충돌 지점과 노멀도 래퍼 개수만큼 다시 변환한다.
+ *
+ * 아핀 변환은 합성해도 아핀 변환이므로, 중첩된 래퍼들의 변환을 scene 구축 시점에 곱해서 3x4 행렬 하나로 만들 수 있다.
+ *    object_to_world = T_outer * ... * T_inner
+ * 그러면 광선 변환(행렬 곱 2번)과 복원(행렬 곱 2번)은 래퍼 개수와 관계없이 한 번씩만 일어나고, 가상 함수 호출도 한 단계로 줄어든다.
+ *
+ * ✅ 월드 AABB 도 합성된 행렬로 로컬 AABB 를 한 번만 변환하므로, 회전 래퍼를 겹칠 때마다 AABB 가 점점 느슨해지는 문제가 없다.
+ * ✅ 노멀은 역변환의 전치로 변환하므로 비균등 스케일(ex> 한 축만 늘린 구)에서도 표면에 수직으로 유지된다.
+ * ⚠️ 합치기는 scene 최상위 object 에만 적용된다. hittable_list 안쪽에 중첩된 래퍼는 make_transformed() 로 생성해야 합쳐진다.
+ * ⚠️ 같은 object 를 여러 번 배치하는 경우는 BLAS 를 공유하는 instance / tlas 를 사용한다.
+ */
+
+#endif /* TRANSFORMED_HPP */
@@ -0,0 +1,370 @@
+#ifndef TRIANGLE_MESH_HPP
+#define TRIANGLE_MESH_HPP
+
+#include "hittable.hpp"
+#include "accelerator/bvh_build.hpp"
+#include "accelerator/bvh_flat.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * 삼각형 메쉬 입력 데이터 (정점 속성 SoA 배열 + 삼각형 인덱스 배열)
+ *
+ * - mesh loader 가 파싱 결과를 이 배열들에 직접 쓰고, triangle_mesh 는 배열을 복사 없이 넘겨받는다(move).
+ * - 정점 노멀 / uv 배열은 비어 있거나 정점 위치 배열과 같은 크기여야 한다.
+ */
+class triangle_mesh_data
+{
+public:
+  std::vector<double> px, py, pz; // 정점 위치
+  std::vector<double> nx, ny, nz; // 정점 노멀 (선택)
+  std::vector<double> tu, tv;     // 정점 uv 좌표 (선택)
+  std::vector<uint32_t> indices;  // 삼각형마다 세 정점 인덱스를 차례로 나열한 배열
+
+  size_t vertex_count() const { return px.size(); };
+  size_t triangle_count() const { return indices.size() / 3; };
+  bool has_normals() const { return !nx.empty(); };
+  bool has_uvs() const { return !tu.empty(); };
+
+  void resize_vertices(size_t count, bool normals, bool uvs)
+  {
+    px.resize(count);
+    py.resize(count);
+    pz.resize(count);
+    nx.resize(normals ? count : 0);
+    ny.resize(normals ? count : 0);
+    nz.resize(normals ? count : 0);
+    tu.resize(uvs ? count : 0);
+    tv.resize(uvs ? count : 0);
+  };
+
+  void clear() { *this = triangle_mesh_data(); };
+};
+
+/**
+ * 인덱스 기반 삼각형 메쉬(indexed triangle mesh) 클래스
+ *
+ * - 여러 삼각형이 공유하는 정점 위치 / 정점 노멀 / uv 좌표를 x, y, z (u, v) 컴포넌트별 배열(SoA)로 한 벌만 저장하고,
+ *   삼각형은 세 정점의 인덱스만 저장한다. (삼각형마다 hittable 객체와 shared_ptr<material> 을 만들지 않음)
+ * - 메쉬 내부에 삼각형 인덱스에 대한 자체 BVH(flat_bvh 와 같은 bvh_flat_node 배열)를 구축하고,
+ *   삼각형 인덱스 배열은 BVH 리프 순서대로 재배치해서 리프 하나의 삼각형들이 메모리상에 연속으로 놓이도록 한다.
+ * - 교차 검사는 Möller–Trumbore 알고리즘으로 t 와 무게중심 좌표(barycentric)만 구하고,
+ *   순회가 끝난 뒤 가장 가까운 삼각형 하나에 대해서만 노멀 / uv 를 보간해서 hit_record 를 채운다.
+ * - 정점 노멀이 없으면 면 노멀(flat shading)을, uv 가 없으면 무게중심 좌표를 uv 로 사용한다.
+ */
+class triangle_mesh : public hittable
+{
+public:
+  /**
+   * positions : 정점 위치 배열
+   * indices   : 삼각형마다 세 정점 인덱스를 차례로 나열한 배열 (크기는 3 의 배수)
+   * normals   : 정점 노멀 배열 (비어 있거나 positions 와 같은 크기)
+   * uvs       : 정점 uv 좌표 배열 (비어 있거나 positions 와 같은 크기, vec3 의 x, y 만 사용)
+   */
+  triangle_mesh(const std::vector<point3> &positions, const std::vector<uint32_t> &indices, std::shared_ptr<material> mat,
+                const std::vector<vec3> &normals = std::vector<vec3>(), const std::vector<vec3> &uvs = std::vector<vec3>(),
+                const bvh_build_options &options = bvh_build_options())
+      : mat(mat)
+  {
+    // 정점 속성을 컴포넌트별 배열(SoA)로 변환
+    size_t vertex_count = positions.size();
+    triangle_mesh_data data;
+    data.resize_vertices(vertex_count, normals.size() == vertex_count, uvs.size() == vertex_count);
+    for (size_t i = 0; i < vertex_count; i++)
+    {
+      data.px[i] = positions[i].x();
+      data.py[i] = positions[i].y();
+      data.pz[i] = positions[i].z();
+      if (data.has_normals())
+      {
+        data.nx[i] = normals[i].x();
+        data.ny[i] = normals[i].y();
+        data.nz[i] = normals[i].z();
+      }
+      if (data.has_uvs())
+      {
+        data.tu[i] = uvs[i].x();
+        data.tv[i] = uvs[i].y();
+      }
+    }
+
+    take(data);
+    build(indices, options);
+  };
+
+  // mesh loader 등이 SoA 배열로 채운 데이터를 복사 없이 넘겨받아 메쉬 구성
+  triangle_mesh(triangle_mesh_data &&data, std::shared_ptr<material> mat, const bvh_build_options &options = bvh_build_options())
+      : mat(mat)
+  {
+    take(data);
+    build(data.indices, options);
+    std::vector<uint32_t>().swap(data.indices); // 재배치된 인덱스는 i0, i1, i2 에 있으므로 원본 해제
+  };
+
+  bool hit(const ray &r, interval ray_t, hit_record &rec) const override
+  {
+    if (nodes.empty())
+    {
+      return false;
+    }
+
+    // flat_bvh 와 같은 near child first 순회 (bvh_traversal.hpp 참고)
+    // -> 가장 가까운 교차 삼각형과 그 무게중심 좌표만 기록해두고, hit_record 는 순회가 끝난 뒤 한 번만 계산
+    const traversal_ray tr(r);
+    uint32_t closest = 0;
+    double closest_b1 = 0.0f, closest_b2 = 0.0f;
+    bool hit_anything = bvh_traverse_closest(nodes.data(), tr, ray_t,
+                                             [&](const bvh_flat_node &node, interval &ray_t)
+                                             {
+                                               bool hit_leaf = false;
+                                               for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                                               {
+                                                 double t, b1, b2;
+                                                 if (intersect(i, r, ray_t, t, b1, b2))
+                                                 {
+                                                   hit_leaf = true;
+                                                   ray_t.max = t;
+                                                   closest = i;
+                                                   closest_b1 = b1;
+                                                   closest_b2 = b2;
+                                                 }
+                                               }
+                                               return hit_leaf;
+                                             });
+
+    if (!hit_anything)
+    {
+      return false;
+    }
+    fill_record(closest, closest_b1, closest_b2, r, ray_t.max, rec);
+    return true;
+  };
+
+  // 차폐 검사: 교차하는 삼각형을 하나라도 찾으면 즉시 종료
+  bool occluded(const ray &r, interval ray_t) const override
+  {
+    if (nodes.empty())
+    {
+      return false;
+    }
+
+    const traversal_ray tr(r);
+    return bvh_traverse_any(nodes.data(), tr, ray_t,
+                            [&](const bvh_flat_node &node, interval ray_t)
+                            {
+                              for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                              {
+                                double t, b1, b2;
+                                if (intersect(i, r, ray_t, t, b1, b2))
+                                {
+                                  return true;
+                                }
+                              }
+                              return false;
+                            });
+  };
+
+  aabb bounding_box() const override { return bbox; };
+
+  size_t vertex_count() const { return px.size(); };
+  size_t triangle_count() const { return i0.size(); };
+
+private:
+  // 정점 속성 (SoA)
+  std::vector<double> px, py, pz; // 정점 위치
+  std::vector<double> nx, ny, nz; // 정점 노멀 (비어 있으면 면 노멀 사용)
+  std::vector<double> tu, tv;     // 정점 uv 좌표 (비어 있으면 무게중심 좌표 사용)
+
+  // 삼각형별 세 정점 인덱스 (SoA, BVH 리프 순서대로 재배치됨)
+  std::vector<uint32_t> i0, i1, i2;
+
+  bvh_flat_node_array nodes;     // 메쉬 내부 BVH 노드 배열 (flat_bvh 와 같은 형식, 리프는 삼각형 범위를 참조)
+  std::shared_ptr<material> mat; // 메쉬 전체에 적용할 material
+  aabb bbox;                     // 메쉬 전체를 감싸는 AABB
+
+private:
+  // 정점 속성 배열의 소유권을 넘겨받음 (data 에는 삼각형 인덱스 배열만 남음)
+  void take(triangle_mesh_data &data)
+  {
+    px = std::move(data.px);
+    py = std::move(data.py);
+    pz = std::move(data.pz);
+    nx = std::move(data.nx);
+    ny = std::move(data.ny);
+    nz = std::move(data.nz);
+    tu = std::move(data.tu);
+    tv = std::move(data.tv);
+  };
+
+  // 삼각형 AABB 로 내부 BVH 를 구축하고, 삼각형 인덱스를 리프 순서대로 재배치
+  void build(const std::vector<uint32_t> &indices, const bvh_build_options &options)
+  {
+    // 정점 개수를 벗어난 인덱스가 있으면 mesh loader 와 같이 오류를 출력하고 빈 메쉬로 둠
+    size_t triangle_count = indices.size() / 3;
+    for (size_t i = 0; i < triangle_count * 3; i++)
+    {
+      if (indices[i] >= px.size())
+      {
+        fprintf(stderr, "Error: triangle mesh index %u is out of range (%zu vertices).\n", indices[i], px.size());
+        triangle_mesh_data empty;
+        take(empty); // 정점 속성 해제
+        return;
+      }
+    }
+
+    std::vector<aabb> bounds(triangle_count);
+    int thread_count = triangle_count >= options.parallel_threshold ? resolve_thread_count(options.thread_count) : 1;
+    parallel_for_chunks(triangle_count, thread_count,
+                        [&](int, size_t begin, size_t end)
+                        {
+                          for (size_t i = begin; i < end; i++)
+                          {
+                            point3 a = vertex(indices[3 * i]), b = vertex(indices[3 * i + 1]), c = vertex(indices[3 * i + 2]);
+                            bounds[i] = aabb(aabb(a, b), aabb(c, c));
+                          }
+                        });
+    if (triangle_count == 0)
+    {
+      return;
+    }
+
+    bvh_build_options build_options = options;
+    if (build_options.max_depth > bvh_stack_capacity)
+    {
+      build_options.max_depth = bvh_stack_capacity;
+    }
+    bvh_builder builder(bounds, build_options);
+
+    i0.reserve(builder.prim_indices.size());
+    i1.reserve(builder.prim_indices.size());
+    i2.reserve(builder.prim_indices.size());
+    for (size_t index : builder.prim_indices)
+    {
+      i0.push_back(indices[3 * index]);
+      i1.push_back(indices[3 * index + 1]);
+      i2.push_back(indices[3 * index + 2]);
+    }
+
+    bbox = builder.nodes[builder.root].bbox;
+    nodes.reserve(builder.nodes.size());
+    flatten_bvh(builder, builder.root, nodes);
+  };
+
+  point3 vertex(uint32_t i) const { return point3(px[i], py[i], pz[i]); };
+
+  /**
+   * Möller–Trumbore 광선-삼각형 교차 검사 (하단 필기 참고)
+   *
+   * - tri 번째 삼각형과 광선이 ray_t 범위 안에서 교차하면 true 를 반환하고, 교차 거리 t 와 무게중심 좌표 (b1, b2) 를 출력한다.
+   *   (교차점 = (1 - b1 - b2) * p0 + b1 * p1 + b2 * p2)
+   * - 양면(two-sided) 삼각형으로 취급하므로 광선이 뒷면에서 들어와도 교차로 판정한다.
+   */
+  bool intersect(uint32_t tri, const ray &r, interval ray_t, double &t, double &b1, double &b2) const
+  {
+    const uint32_t a = i0[tri], b = i1[tri], c = i2[tri];
+    const vec3 &d = r.direction();
+    const point3 &o = r.origin();
+
+    // 두 변 벡터 e1 = p1 - p0, e2 = p2 - p0
+    double e1x = px[b] - px[a], e1y = py[b] - py[a], e1z = pz[b] - pz[a];
+    double e2x = px[c] - px[a], e2y = py[c] - py[a], e2z = pz[c] - pz[a];
+
+    // pvec = d x e2, det = e1 . pvec (det 이 0 이면 광선이 삼각형 평면과 평행)
+    // -> det 의 크기는 삼각형 크기와 광선 방향 길이에 비례하므로 고정된 절댓값 임계치와 비교하지 않는다.
+    //    거의 평행한 광선은 det 가 아주 작아 b1, b2 가 커지므로 아래 범위 검사에서 걸러짐
+    double pvx = d.y() * e2z - d.z() * e2y;
+    double pvy = d.z() * e2x - d.x() * e2z;
+    double pvz = d.x() * e2y - d.y() * e2x;
+    double det = e1x * pvx + e1y * pvy + e1z * pvz;
+    if (det == 0.0f)
+    {
+      return false;
+    }
+    double inv_det = 1.0f / det;
+
+    // tvec = o - p0, b1 = (tvec . pvec) / det
+    double tvx = o.x() - px[a], tvy = o.y() - py[a], tvz = o.z() - pz[a];
+    b1 = (tvx * pvx + tvy * pvy + tvz * pvz) * inv_det;
+    if (b1 < 0.0f || b1 > 1.0f)
+    {
+      return false;
+    }
+
+    // qvec = tvec x e1, b2 = (d . qvec) / det
+    double qvx = tvy * e1z - tvz * e1y;
+    double qvy = tvz * e1x - tvx * e1z;
+    double qvz = tvx * e1y - tvy * e1x;
+    b2 = (d.x() * qvx + d.y() * qvy + d.z() * qvz) * inv_det;
+    if (b2 < 0.0f || b1 + b2 > 1.0f)
+    {
+      return false;
+    }
+
+    // t = (e2 . qvec) / det
+    t = (e2x * qvx + e2y * qvy + e2z * qvz) * inv_det;
+    return ray_t.surrounds(t);
+  };
+
+  // 가장 가까운 교차 삼각형 하나에 대해서만 교차점, 노멀, uv 를 계산하여 hit_record 에 기록
+  void fill_record(uint32_t tri, double b1, double b2, const ray &r, double t, hit_record &rec) const
+  {
+    const uint32_t a = i0[tri], b = i1[tri], c = i2[tri];
+    const double b0 = 1.0f - b1 - b2;
+
+    rec.t = t;
+    rec.p = r.at(t);
+
+    // 면 노멀로 광선이 앞면/뒷면 중 어디에 닿았는지 결정
+    point3 p0 = vertex(a);
+    vec3 face_normal = unit_vector(cross(vertex(b) - p0, vertex(c) - p0));
+    rec.set_face_normal(r, face_normal);
+
+    // 정점 노멀이 있으면 무게중심 좌표로 보간한 shading normal 을 면 노멀과 같은 쪽(광선 반대쪽)으로 맞춰서 사용
+    if (!nx.empty())
+    {
+      vec3 shading_normal(b0 * nx[a] + b1 * nx[b] + b2 * nx[c],
+                          b0 * ny[a] + b1 * ny[b] + b2 * ny[c],
+                          b0 * nz[a] + b1 * nz[b] + b2 * nz[c]);
+      if (shading_normal.length_squared() > 0.0f)
+      {
+        shading_normal = unit_vector(shading_normal);
+        rec.normal = dot(shading_normal, rec.normal) < 0.0f ? -shading_normal : shading_normal;
+      }
+    }
+
+    if (!tu.empty())
+    {
+      rec.u = b0 * tu[a] + b1 * tu[b] + b2 * tu[c];
+      rec.v = b0 * tv[a] + b1 * tv[b] + b2 * tv[c];
+    }
+    else
+    {
+      rec.u = b1;
+      rec.v = b2;
+    }
+    rec.mat = mat.get();
+  };
+};
+
+/**
+ * Möller–Trumbore 광선-삼각형 교차
+ *
+ *
+ * 삼각형 위의 점을 무게중심 좌표로 P = p0 + b1 * e1 + b2 * e2 (e1 = p1 - p0, e2 = p2 - p0) 로 나타내고,
+ * 광선 o + t * d 와 같다고 놓으면 미지수 (t, b1, b2) 에 대한 3x3 연립방정식이 된다.
+ *
+ *   [-d  e1  e2] (t, b1, b2)^T = o - p0
+ *
+ * 이를 크래머 공식(Cramer's rule)과 삼중곱 성질로 풀면 외적 두 번(pvec, qvec)과 내적 네 번으로 t, b1, b2 를 모두 구할 수 있다.
+ * quad 처럼 평면 방정식(normal, D)이나 평면 좌표계 변환 벡터(w)를 삼각형마다 미리 저장해둘 필요가 없으므로,
+ * 정점 위치만 공유 배열에 두고 삼각형은 인덱스 3개(12 바이트)만 저장할 수 있다.
+ *
+ * ✅ b1, b2 범위 검사에서 일찍 실패하면 나머지 계산(qvec, t)을 생략한다.
+ * ✅ 교차 검사 중에는 t 와 (b1, b2) 만 기록하고, 노멀 정규화 / 속성 보간 / material 복사는 가장 가까운 삼각형 하나에 대해서만 수행한다.
+ * ⚠️ 이웃한 두 삼각형이 공유하는 변 위를 정확히 지나는 광선은 부동소수점 오차로 양쪽 모두에서 빠져나갈 수 있다. (watertight 하지 않음)
+ *    실제로는 그런 광선이 극히 드물고, 배경이 비쳐 보이는 한 픽셀 샘플 정도의 오차로만 나타난다.
+ */
+
+#endif /* TRIANGLE_MESH_HPP */
@@ -1,26 +1,59 @@
 #include "common/rtweekend.hpp" // common header 최상단에 가장 먼저 include (관련 필기 하단 참고)
-#include "accelerator/bvh_node.hpp"
+#include "accelerator/accelerator.hpp"
+#include "accelerator/instance.hpp"
 #include "core/camera.hpp"
 #include "core/material.hpp"
 #include "core/texture.hpp"
 #include "hittable/hittable.hpp"
 #include "hittable/hittable_list.hpp"
 #include "hittable/sphere.hpp"
+#include "hittable/sphere_set.hpp"
 #include "hittable/quad.hpp"
-
-// bouncing spheres scene 렌더링 함수
-void bouncing_spheres(std::ofstream &output_file)
+#include "hittable/box.hpp"
+#include "hittable/transformed.hpp"
+#include "hittable/mesh_loader.hpp"
+#include "hittable/triangle_mesh.hpp"
+#include "bench/accelerator_bench.hpp"
+#include "bench/fast_math_bench.hpp"
+#include "bench/hit_record_bench.hpp"
+#include "bench/sphere_set_bench.hpp"
+
+// loaded_mesh scene 에서 불러올 메쉬 파일 경로 (.obj 또는 binary .ply)
+const char *const scene_mesh_path = "assets/mesh.ply";
+
+// object 가 많은 scene 의 기본 가속 구조 (case 10 의 가속 구조 벤치마크 중 dense scene 인 bouncing_spheres_objects 측정 결과 기준)
+// -> 자식 AABB 4개를 한 번에 검사하는 bvh_wide 는 AVX 빌드에서 가장 빠르고, 스칼라 빌드에서는 bvh_flat 이 가장 빠름
+//    (object 가 몇 개뿐인 scene 은 main() 의 render_scene() 호출에서 scene 별 측정 결과로 따로 지정)
+#if defined(RTW_SIMD_AVX)
+const accelerator_type scene_accelerator = accelerator_type::bvh_wide;
+#else
+const accelerator_type scene_accelerator = accelerator_type::bvh_flat;
+#endif
+
+// scene 가속 구조 빌드 옵션 (빌드 품질 vs 빌드 시간 선택 및 단계별 빌드 시간 출력)
+bvh_build_options scene_build_options()
 {
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
+  bvh_build_options options;
+  options.quality = bvh_build_quality::high; // primitive 수가 매우 많은 scene 은 bvh_build_quality::fast(LBVH) 로 빌드 시간 단축,
+                                             // 큰 primitive 가 서로 겹치는 scene 은 bvh_build_quality::spatial(SBVH) 로 순회 비용 감소
+  options.report_timings = true;
+  options.report_stats = true; // 트리 품질 통계 출력 (options.stats_dump_path 지정 시 노드 AABB 를 OBJ wireframe 으로 저장)
+  // options.cache_path = "output/scene.bvh"; // bvh_flat 사용 시 빌드 결과를 캐시 파일로 저장하고, scene 이 바뀌지 않았으면 다음 실행부터 빌드 생략
+  return options;
+};
 
+// bouncing spheres scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+// -> use_sphere_set 이 false 면 소형 sphere 를 sphere_set 으로 묶지 않고 sphere 객체로 하나씩 world 에 추가
+void bouncing_spheres_scene(hittable_list &world, camera &cam, bool use_sphere_set)
+{
   /** 각 Hittable 객체에 적용할 재질(Material)을 shared_ptr로 생성하여 공유 가능하도록 관리 */
   // checker texture 생성 후 ground_material 에 적용
   auto checker = std::make_shared<checker_texture>(0.32f, color(0.2f, 0.3f, 0.1f), color(0.9f, 0.9f, 0.9f));
   auto ground_material = std::make_shared<lambertian>(checker);
   world.add(std::make_shared<sphere>(point3(0.0f, -1000.0f, -1.0f), 1000.0f, ground_material)); // 반지름이 1000 인 지면 sphere 추가
 
-  /** 484개(= 22 * 22)의 소형 sphere 생성 후 world 에 추가 */
+  /** 484개(= 22 * 22)의 소형 sphere 생성 후 sphere_set 하나로 묶어서 world 에 추가 (구체마다 sphere 객체를 만들지 않음) */
+  auto small_spheres = use_sphere_set ? std::make_shared<sphere_set>() : nullptr;
   for (int a = -11; a < 11; a++)
   {
     for (int b = -11; b < 11; b++)
@@ -42,7 +75,14 @@ void bouncing_spheres(std::ofstream &output_file)
           auto albedo = color::random() * color::random();
           sphere_material = std::make_shared<lambertian>(albedo);
           auto centrt2 = center + vec3(0.0f, random_double(0.0f, 0.5f), 0.0f);
-          world.add(std::make_shared<sphere>(center, centrt2, 0.2f, sphere_material));
+          if (small_spheres)
+          {
+            small_spheres->add(center, centrt2, 0.2f, sphere_material);
+          }
+          else
+          {
+            world.add(std::make_shared<sphere>(center, centrt2, 0.2f, sphere_material));
+          }
         }
         else if (choose_mat < 0.95f)
         {
@@ -50,18 +90,38 @@ void bouncing_spheres(std::ofstream &output_file)
           auto albedo = color::random(0.5f, 1.0f);
           auto fuzz = random_double(0.0f, 0.5f);
           sphere_material = std::make_shared<metal>(albedo, fuzz);
-          world.add(std::make_shared<sphere>(center, 0.2f, sphere_material));
+          if (small_spheres)
+          {
+            small_spheres->add(center, 0.2f, sphere_material);
+          }
+          else
+          {
+            world.add(std::make_shared<sphere>(center, 0.2f, sphere_material));
+          }
         }
         else
         {
           // 5% 확률로(1.0 - 0.95 = 0.05) glass material 적용하여 소형 sphere 생성
           sphere_material = std::make_shared<dielectric>(1.5f);
-          world.add(std::make_shared<sphere>(center, 0.2f, sphere_material));
+          if (small_spheres)
+          {
+            small_spheres->add(center, 0.2f, sphere_material);
+          }
+          else
+          {
+            world.add(std::make_shared<sphere>(center, 0.2f, sphere_material));
+          }
         }
       }
     }
   }
 
+  if (small_spheres)
+  {
+    small_spheres->rebuild();
+    world.add(small_spheres);
+  }
+
   /** 각 재질이 적용된 3개의 대형 sphere 생성 후 world 에 추가 */
   auto material1 = std::make_shared<dielectric>(1.5f);
   world.add(std::make_shared<sphere>(point3(0.0f, 1.0f, 0.0f), 1.0f, material1));
@@ -72,12 +132,7 @@ void bouncing_spheres(std::ofstream &output_file)
   auto material3 = std::make_shared<metal>(color(0.7f, 0.6f, 0.5f), 0.0f);
   world.add(std::make_shared<sphere>(point3(4.0f, 1.0f, 0.0f), 1.0f, material3));
 
-  // 현재 world 내의 hittable 객체들을 가지고서 BVH 트리를 구축함.
-  world = hittable_list(std::make_shared<bvh_node>(world));
-
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 16.0f / 9.0f;
@@ -95,17 +150,18 @@ void bouncing_spheres(std::ofstream &output_file)
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.6f;
   cam.focus_dist = 10.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, world);
 }
 
-// checkered spheres scene 렌더링 함수
-void checkered_spheres(std::ofstream &output_file)
-{
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
+// 렌더링용 bouncing spheres scene (소형 sphere 를 sphere_set 하나로 묶음)
+void bouncing_spheres(hittable_list &world, camera &cam) { bouncing_spheres_scene(world, cam, true); };
 
+// 가속 구조 벤치마크 전용 bouncing spheres scene
+// -> 소형 sphere 484 개가 최상위 object 로 남아 있어서, 가속 구조가 primitive 수백 개를 직접 다루는 dense case 를 측정할 수 있음
+void bouncing_spheres_objects(hittable_list &world, camera &cam) { bouncing_spheres_scene(world, cam, false); };
+
+// checkered spheres scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void checkered_spheres(hittable_list &world, camera &cam)
+{
   /** 각 Hittable 객체에 적용할 재질(Material)을 shared_ptr로 생성하여 공유 가능하도록 관리 */
   // checker texture 생성 후 lambertian material 에 적용
   auto checker = std::make_shared<checker_texture>(0.32f, color(0.2f, 0.3f, 0.1f), color(0.9f, 0.9f, 0.9f));
@@ -113,9 +169,7 @@ void checkered_spheres(std::ofstream &output_file)
   world.add(std::make_shared<sphere>(point3(0.0f, -10.0f, 0.0f), 10.0f, std::make_shared<lambertian>(checker)));
   world.add(std::make_shared<sphere>(point3(0.0f, 10.0f, 0.0f), 10.0f, std::make_shared<lambertian>(checker)));
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 16.0f / 9.0f;
@@ -132,23 +186,19 @@ void checkered_spheres(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, world);
 };
 
-// earth scene 렌더링 함수
-void earth(std::ofstream &output_file)
+// earth scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void earth(hittable_list &world, camera &cam)
 {
   // earthmap.jpg 이미지 로드 및 적용을 위해 image_texture 생성 후 lambertian material 에 적용
   auto earth_texture = std::make_shared<image_texture>("earthmap.jpg");
   auto earth_surface = std::make_shared<lambertian>(earth_texture);
   // 반지름이 2 인 glob sphere 생성
   auto globe = std::make_shared<sphere>(point3(0.0f, 0.0f, 0.0f), 2.0f, earth_surface);
+  world.add(globe);
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 16.0f / 9.0f;
@@ -165,26 +215,18 @@ void earth(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, hittable_list(globe));
 };
 
-// perlin noise sphere scene 렌더링 함수
-void perlin_sphere(std::ofstream &output_file)
+// perlin noise sphere scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void perlin_sphere(hittable_list &world, camera &cam)
 {
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
-
   // perlin noise 적용을 위해 noise_texture 생성 후 lambertian material 에 적용
   auto pertext = std::make_shared<noise_texture>(4);
   // 반지름이 각각 2, 1000 인 두 sphere 추가
   world.add(std::make_shared<sphere>(point3(0.0f, -1000.0f, 0.0f), 1000.0f, std::make_shared<lambertian>(pertext)));
   world.add(std::make_shared<sphere>(point3(0.0f, 2.0f, 0.0f), 2.0f, std::make_shared<lambertian>(pertext)));
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 16.0f / 9.0f;
@@ -201,17 +243,11 @@ void perlin_sphere(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, hittable_list(world));
 };
 
-// quad scene 렌더링 함수
-void quads(std::ofstream &output_file)
+// quad scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void quads(hittable_list &world, camera &cam)
 {
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
-
   /** 각 quad 객체에 적용할 재질(Material)을 shared_ptr로 생성 */
   auto left_red = std::make_shared<lambertian>(color(1.0f, 0.2f, 0.2f));
   auto back_green = std::make_shared<lambertian>(color(0.2f, 1.0f, 0.2f));
@@ -226,9 +262,7 @@ void quads(std::ofstream &output_file)
   world.add(std::make_shared<quad>(point3(-2.0f, 3.0f, 1.0f), vec3(4.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 4.0f), upper_orange));
   world.add(std::make_shared<quad>(point3(-2.0f, -3.0f, 5.0f), vec3(4.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, -4.0f), lower_teal));
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 1.0f;
@@ -245,17 +279,11 @@ void quads(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, world);
 };
 
-// light scene 렌더링 함수
-void simple_light(std::ofstream &output_file)
+// light scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void simple_light(hittable_list &world, camera &cam)
 {
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
-
   // perlin noise 적용을 위해 noise_texture 생성 후 lambertian material 에 적용
   auto pertext = std::make_shared<noise_texture>(4);
   // 반지름이 각각 2, 1000 인 두 sphere 추가
@@ -273,9 +301,7 @@ void simple_light(std::ofstream &output_file)
   // 광원으로 사용할 quad 생성 후 world 에 추가
   world.add(std::make_shared<quad>(point3(3.0f, 1.0f, -2.0f), vec3(2.0f, 0.0f, 0.0f), vec3(0.0f, 2.0f, 0.0f), difflight));
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 400;
   cam.aspect_ratio = 16.0f / 9.0f;
@@ -292,17 +318,11 @@ void simple_light(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
-
-  // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
-  cam.render(output_file, world);
 };
 
-// cornell box 렌더링 함수
-void cornell_box(std::ofstream &output_file)
+// cornell box scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void cornell_box(hittable_list &world, camera &cam)
 {
-  /** world(scene) 역할을 수행하는 hittable_list 생성 및 hittable object 추가 */
-  hittable_list world;
-
   /** 각 quad 객체에 적용할 재질(Material)을 shared_ptr로 생성 */
   auto red = std::make_shared<lambertian>(color(0.65f, 0.05f, 0.05f));
   auto white = std::make_shared<lambertian>(color(0.73f, 0.73f, 0.73f));
@@ -321,9 +341,7 @@ void cornell_box(std::ofstream &output_file)
   world.add(box(point3(130.0f, 0.0f, 65.0f), point3(295.0f, 165.0f, 230.0f), white));
   world.add(box(point3(265.0f, 0.0f, 295.0f), point3(430.0f, 330.0f, 460.0f), white));
 
-  /** camera 객체 생성 및 이미지 렌더링 수행 */
-  camera cam;
-
+  /** camera 파라미터 설정 */
   // 주요 이미지 파라미터 설정
   cam.image_width = 600;
   cam.aspect_ratio = 1.0f;
@@ -340,11 +358,210 @@ void cornell_box(std::ofstream &output_file)
 
   // defocus blur 관련 파라미터 성정
   cam.defocus_angle = 0.0f;
+};
+
+// 같은 소품(상자 + 구)을 TLAS/BLAS 인스턴싱으로 수천 개 배치한 scene 구성 함수 (world 에 object 추가 및 camera 파라미터 설정)
+void instanced_props(hittable_list &world, camera &cam)
+{
+  /** 소품 geometry 를 로컬 좌표계 기준으로 한 번만 생성하여 BLAS 로 구축 */
+  auto crate_material = std::make_shared<lambertian>(color(0.6f, 0.4f, 0.2f));
+  auto ball_material = std::make_shared<metal>(color(0.8f, 0.8f, 0.9f), 0.1f);
+
+  hittable_list prop;
+  prop.add(box(point3(-0.5f, 0.0f, -0.5f), point3(0.5f, 1.0f, 0.5f), crate_material));
+  prop.add(std::make_shared<sphere>(point3(0.0f, 1.3f, 0.0f), 0.3f, ball_material));
+  auto prop_blas = std::make_shared<blas>(prop, scene_accelerator);
+
+  /** 80 x 80 격자에 무작위 회전/크기로 소품 instance 배치 (geometry 는 공유하고 변환 행렬만 instance 마다 저장) */
+  auto props = std::make_shared<tlas>(scene_accelerator, scene_build_options());
+  for (int a = -40; a < 40; a++)
+  {
+    for (int b = -40; b < 40; b++)
+    {
+      double scale = random_double(0.4f, 0.9f);
+      transform placement = transform::translation(vec3(a * 2.0f + random_double(), 0.0f, b * 2.0f + random_double())) *
+                            transform::rotation_y(random_double(0.0f, 360.0f)) *
+                            transform::scaling(vec3(scale, scale, scale));
+      props->add(prop_blas, placement);
+    }
+  }
+  props->rebuild();
+  printf("instanced props: %zu instances sharing %zu primitives\n", props->instance_count(), prop_blas->primitive_count);
+
+  auto ground_material = std::make_shared<lambertian>(color(0.5f, 0.5f, 0.5f));
+  world.add(std::make_shared<quad>(point3(-100.0f, 0.0f, -100.0f), vec3(200.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 200.0f), ground_material));
+  world.add(props);
+
+  /** camera 파라미터 설정 */
+  // 주요 이미지 파라미터 설정
+  cam.image_width = 400;
+  cam.aspect_ratio = 16.0f / 9.0f;
+  cam.samples_per_pixel = 50;
+  cam.max_depth = 20;
+  // ray 와 충돌한 물체가 없을 경우 반환할 scene 배경색(solid color. no gradient) 정의
+  cam.background = color(0.7f, 0.8f, 1.0f);
+
+  // camera transform 관련 파라미터 설정
+  cam.vfov = 30.0f;
+  cam.lookfrom = point3(30.0f, 20.0f, 40.0f);
+  cam.lookat = point3(0.0f, 0.0f, 0.0f);
+  cam.vup = vec3(0.0f, 1.0f, 0.0f);
+
+  // defocus blur 관련 파라미터 성정
+  cam.defocus_angle = 0.0f;
+};
+
+// major_radius, minor_radius 크기의 torus 를 rings x sides 개 정점 격자의 삼각형 메쉬로 생성 (정점 노멀, uv 포함)
+std::shared_ptr<triangle_mesh> make_torus(double major_radius, double minor_radius, int rings, int sides, std::shared_ptr<material> mat)
+{
+  std::vector<point3> positions;
+  std::vector<vec3> normals;
+  std::vector<vec3> uvs;
+  std::vector<uint32_t> indices;
+
+  // 정점은 격자 (i, j) 마다 한 번만 생성하고, 이웃한 삼각형들은 인덱스로 공유
+  for (int i = 0; i < rings; i++)
+  {
+    double phi = 2.0f * pi * i / rings;
+    vec3 ring_dir(std::cos(phi), 0.0f, std::sin(phi));
+    for (int j = 0; j < sides; j++)
+    {
+      double theta = 2.0f * pi * j / sides;
+      vec3 normal = std::cos(theta) * ring_dir + vec3(0.0f, std::sin(theta), 0.0f);
+      positions.push_back(point3(0.0f, 0.0f, 0.0f) + major_radius * ring_dir + minor_radius * normal);
+      normals.push_back(normal);
+      uvs.push_back(vec3(double(i) / rings, double(j) / sides, 0.0f));
+    }
+  }
+  for (int i = 0; i < rings; i++)
+  {
+    for (int j = 0; j < sides; j++)
+    {
+      uint32_t a = i * sides + j;
+      uint32_t b = ((i + 1) % rings) * sides + j;
+      uint32_t c = ((i + 1) % rings) * sides + (j + 1) % sides;
+      uint32_t d = i * sides + (j + 1) % sides;
+      indices.insert(indices.end(), {a, b, c, a, c, d});
+    }
+  }
+  return std::make_shared<triangle_mesh>(positions, indices, mat, normals, uvs);
+};
+
+void mesh_torus(hittable_list &world, camera &cam)
+{
+  /** 삼각형 메쉬 torus 3 개 (메쉬마다 정점/인덱스 배열과 내부 BVH 를 가짐) */
+  auto torus_material = std::make_shared<lambertian>(color(0.8f, 0.3f, 0.2f));
+  auto metal_material = std::make_shared<metal>(color(0.8f, 0.8f, 0.9f), 0.05f);
+  auto glass_material = std::make_shared<dielectric>(1.5f);
+
+  auto torus = make_torus(1.0f, 0.4f, 256, 128, torus_material);
+  printf("mesh torus: %zu vertices, %zu triangles\n", torus->vertex_count(), torus->triangle_count());
+  world.add(std::make_shared<translate>(torus, vec3(0.0f, 0.4f, 0.0f)));
+  // metal torus 는 x 축 기준으로 세운 뒤 바닥에 닿도록 이동 (회전 + 이동을 행렬 하나로 배치)
+  world.add(make_transformed(make_torus(0.7f, 0.25f, 128, 64, metal_material),
+                             transform::translation(vec3(-2.6f, 0.95f, 0.5f)) * transform::rotation(vec3(1.0f, 0.0f, 0.0f), 90.0f)));
+  world.add(std::make_shared<translate>(make_torus(0.7f, 0.25f, 128, 64, glass_material), vec3(2.6f, 0.25f, 0.5f)));
+
+  auto ground_material = std::make_shared<lambertian>(color(0.5f, 0.5f, 0.5f));
+  world.add(std::make_shared<quad>(point3(-100.0f, 0.0f, -100.0f), vec3(200.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 200.0f), ground_material));
+
+  /** camera 파라미터 설정 */
+  // 주요 이미지 파라미터 설정
+  cam.image_width = 400;
+  cam.aspect_ratio = 16.0f / 9.0f;
+  cam.samples_per_pixel = 50;
+  cam.max_depth = 20;
+  // ray 와 충돌한 물체가 없을 경우 반환할 scene 배경색(solid color. no gradient) 정의
+  cam.background = color(0.7f, 0.8f, 1.0f);
+
+  // camera transform 관련 파라미터 설정
+  cam.vfov = 30.0f;
+  cam.lookfrom = point3(0.0f, 5.0f, 10.0f);
+  cam.lookat = point3(0.0f, 0.3f, 0.0f);
+  cam.vup = vec3(0.0f, 1.0f, 0.0f);
+
+  // defocus blur 관련 파라미터 성정
+  cam.defocus_angle = 0.0f;
+};
+
+void loaded_mesh(hittable_list &world, camera &cam)
+{
+  /** 메쉬 파일을 읽어서 바닥 위에 놓일 수 있도록 크기 2 로 맞추고 원점에 배치 (파일을 읽지 못하면 torus 로 대체) */
+  auto mesh_material = std::make_shared<lambertian>(color(0.7f, 0.7f, 0.75f));
+
+  triangle_mesh_data data;
+  if (load_mesh(scene_mesh_path, data))
+  {
+    // 메쉬 AABB 기준으로 정점 좌표를 정규화 (가장 긴 변의 길이 2, 바닥면 y = 0, xz 중심 원점)
+    aabb bounds;
+    for (size_t i = 0; i < data.vertex_count(); i++)
+    {
+      point3 p(data.px[i], data.py[i], data.pz[i]);
+      bounds = aabb(bounds, aabb(p, p));
+    }
+    double extent = std::max(bounds.x.size(), std::max(bounds.y.size(), bounds.z.size()));
+    double scale = extent > 0.0f ? 2.0f / extent : 1.0f;
+    for (size_t i = 0; i < data.vertex_count(); i++)
+    {
+      data.px[i] = (data.px[i] - 0.5f * (bounds.x.min + bounds.x.max)) * scale;
+      data.py[i] = (data.py[i] - bounds.y.min) * scale;
+      data.pz[i] = (data.pz[i] - 0.5f * (bounds.z.min + bounds.z.max)) * scale;
+    }
+    world.add(std::make_shared<triangle_mesh>(std::move(data), mesh_material));
+  }
+  else
+  {
+    world.add(std::make_shared<translate>(make_torus(1.0f, 0.4f, 256, 128, mesh_material), vec3(0.0f, 0.4f, 0.0f)));
+  }
+
+  auto ground_material = std::make_shared<lambertian>(color(0.5f, 0.5f, 0.5f));
+  world.add(std::make_shared<quad>(point3(-100.0f, 0.0f, -100.0f), vec3(200.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 200.0f), ground_material));
+
+  /** camera 파라미터 설정 */
+  // 주요 이미지 파라미터 설정
+  cam.image_width = 400;
+  cam.aspect_ratio = 16.0f / 9.0f;
+  cam.samples_per_pixel = 50;
+  cam.max_depth = 20;
+  // ray 와 충돌한 물체가 없을 경우 반환할 scene 배경색(solid color. no gradient) 정의
+  cam.background = color(0.7f, 0.8f, 1.0f);
+
+  // camera transform 관련 파라미터 설정
+  cam.vfov = 30.0f;
+  cam.lookfrom = point3(0.0f, 3.0f, 7.0f);
+  cam.lookat = point3(0.0f, 0.8f, 0.0f);
+  cam.vup = vec3(0.0f, 1.0f, 0.0f);
+
+  // defocus blur 관련 파라미터 성정
+  cam.defocus_angle = 0.0f;
+};
+
+// scene 구성 함수로 world 와 camera 를 설정한 뒤, world 를 accelerator 종류의 가속 구조로 감싸서 .ppm 이미지 렌더링
+void render_scene(scene_setup setup, std::ofstream &output_file, accelerator_type accelerator = scene_accelerator)
+{
+  hittable_list world;
+  camera cam;
+  setup(world, cam);
+
+  // 중첩된 변환 래퍼(translate / transformed)를 행렬 하나로 합친 뒤
+  collapse_transforms(world);
+
+  // 현재 world 내의 hittable 객체들을 가지고서 가속 구조를 구축함. (종류는 accelerator 로 선택)
+  world = hittable_list(make_accelerator(world, accelerator, scene_build_options()));
 
   // 카메라 및 viewport 파라미터 내부에서 자동 초기화 후 .ppm 이미지 렌더링
   cam.render(output_file, world);
 };
 
+// 가속 구조 비교 벤치마크 대상 built-in scene 목록
+std::vector<bench_scene> builtin_scenes()
+{
+  return {{"bouncing_spheres", bouncing_spheres}, {"bouncing_spheres_objects", bouncing_spheres_objects},
+          {"checkered_spheres", checkered_spheres}, {"earth", earth},
+          {"perlin_sphere", perlin_sphere}, {"quads", quads}, {"simple_light", simple_light},
+          {"cornell_box", cornell_box}, {"instanced_props", instanced_props}, {"mesh_torus", mesh_torus}};
+};
+
 int main(int argc, char *argv[])
 {
   /** 명령줄 인수로 출력 파일(= .ppm 이미지 파일) 경로 전달받기 */
@@ -366,28 +583,56 @@ int main(int argc, char *argv[])
   }
 
   // switch 문으로 렌더링을 원하는 장면 선택 가능
+  // -> 가속 구조는 case 10 의 벤치마크에서 스칼라 / AVX 빌드 모두 가장 빨랐던 종류로 scene 마다 지정
+  //    (object 가 몇 개뿐이고 각 object 의 교차 검사가 싼 scene 은 가속 구조 없이(none) 선형 검사하는 편이 빠름)
   switch (7)
   {
   case 1:
-    bouncing_spheres(output_file);
+    render_scene(bouncing_spheres, output_file, accelerator_type::bvh_tree);
     break;
   case 2:
-    checkered_spheres(output_file);
+    render_scene(checkered_spheres, output_file, accelerator_type::none);
     break;
   case 3:
-    earth(output_file);
+    render_scene(earth, output_file, accelerator_type::none);
     break;
   case 4:
-    perlin_sphere(output_file);
+    render_scene(perlin_sphere, output_file, accelerator_type::none);
     break;
   case 5:
-    quads(output_file);
+    render_scene(quads, output_file, accelerator_type::kd_tree);
     break;
   case 6:
-    simple_light(output_file);
+    render_scene(simple_light, output_file, accelerator_type::none);
     break;
   case 7:
-    cornell_box(output_file);
+    render_scene(cornell_box, output_file, accelerator_type::none);
+    break;
+  case 8:
+    // 렌더링 대신 fast-math 근사 함수의 오차 검증 및 마이크로벤치마크 결과를 콘솔에 출력
+    fast_math_benchmark();
+    break;
+  case 9:
+    render_scene(instanced_props, output_file);
+    break;
+  case 10:
+    // 렌더링 대신 모든 built-in scene 을 모든 가속 구조로 빌드/순회한 측정 결과를 콘솔에 출력 (scene 별 가속 구조 선택 기준)
+    accelerator_benchmark(builtin_scenes());
+    break;
+  case 11:
+    render_scene(mesh_torus, output_file);
+    break;
+  case 12:
+    // scene_mesh_path 의 메쉬 파일을 읽어서 렌더링 (로드 시간과 처리량 출력)
+    render_scene(loaded_mesh, output_file);
+    break;
+  case 13:
+    // 렌더링 대신 구체 객체 + BVH 와 sphere_set 의 빌드/순회 속도 비교 결과를 콘솔에 출력
+    sphere_set_benchmark();
+    break;
+  case 14:
+    // 렌더링 대신 hit_record 의 material 참조 방식(shared_ptr vs raw pointer)별 후보 교차점 기록 비용 비교 결과를 콘솔에 출력
+    hit_record_benchmark();
     break;
   }
 